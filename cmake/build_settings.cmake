@@ -5,6 +5,7 @@ option(BUILD_COVERAGE "Enables code coverage report" OFF)
 option(USE_ASSERT "Enable assertions" ON)
 option(USE_VALGRIND "Allow Valgrind for unit tests" OFF)
 option(ENABLE_PROFILING "Enable AllScale profiling support" OFF)
+option(USE_COROUTINES "Compile as C++20, enabling the coroutine layer" OFF)
 
 # ALLSCALE_CHECK_BOUNDS ... Enable bounds checks for AllScale data items and utility structures
 
@@ -45,7 +46,11 @@ if(CMAKE_CXX_COMPILER_ID STREQUAL "Clang" OR CMAKE_CXX_COMPILER_ID STREQUAL "GNU
 	set(CMAKE_C_FLAGS_RELEASE "-O2")
 
 	# C++ flags
-	set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -Wall -Wextra -std=c++14")
+	if(USE_COROUTINES)
+		set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -Wall -Wextra -std=c++20")
+	else()
+		set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -Wall -Wextra -std=c++14")
+	endif()
 	set(CMAKE_CXX_FLAGS_DEBUG "-O0 -g3 -ggdb")
 	set(CMAKE_CXX_FLAGS_RELEASE "-O2")
 
@@ -80,6 +85,9 @@ if(CMAKE_CXX_COMPILER_ID STREQUAL "Clang" OR CMAKE_CXX_COMPILER_ID STREQUAL "GNU
 	endif()
 elseif(MSVC)
 	include(msvc_settings)
+	if(USE_COROUTINES)
+		set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} /std:c++20")
+	endif()
 	set(USE_VALGRIND OFF)
 else()
 	message(FATAL_ERROR "Unhandled Compiler: ${CMAKE_CXX_COMPILER_ID}")
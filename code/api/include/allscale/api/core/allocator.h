@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * This header provides allocators for the temporary memory of tasks. Bodies of parallel
+ * operations like pfor or preduce may utilize the task_local_allocator for scratch buffers,
+ * e.g. as part of std containers, which are then served by an arena of the current worker
+ * without any synchronization and released in bulk once the current task ends.
+ *
+ * Memory obtained through a task_local_allocator must thus neither outlive the task it is
+ * allocated by, e.g. as part of its result or across a co_await, nor be passed to other threads.
+ */
+
+#include <vector>
+
+#include "allscale/api/core/impl/reference/allocator.h"
+
+namespace allscale {
+namespace api {
+namespace core {
+
+	/**
+	 * An allocator for the temporary memory of the current task.
+	 */
+	template<typename T>
+	using task_local_allocator = impl::reference::TaskLocalAllocator<T>;
+
+	/**
+	 * A vector for temporary data of the current task.
+	 */
+	template<typename T>
+	using task_local_vector = std::vector<T,task_local_allocator<T>>;
+
+} // end namespace core
+} // end namespace api
+} // end namespace allscale
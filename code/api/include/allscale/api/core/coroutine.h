@@ -0,0 +1,353 @@
+#pragma once
+
+/**
+ * This header provides an optional coroutine layer on top of treetures. Within a coroutine
+ * of type core::task<T>, treetures, task references (including loop references of pfor
+ * operations) and other tasks may be co_await-ed. Instead of blocking the current worker
+ * through nested scheduling steps, the coroutine is suspended and resumed by a task
+ * scheduled once the awaited value is available.
+ *
+ * The layer requires C++20 coroutine support. If not available, this header only defines
+ * ALLSCALE_WITH_COROUTINES as 0, such that client code can provide an alternative.
+ */
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+	#if __has_include(<coroutine>)
+		#define ALLSCALE_WITH_COROUTINES 1
+	#endif
+#endif
+
+#ifndef ALLSCALE_WITH_COROUTINES
+	#define ALLSCALE_WITH_COROUTINES 0
+#endif
+
+#if ALLSCALE_WITH_COROUTINES
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+#include "allscale/api/core/treeture.h"
+
+namespace allscale {
+namespace api {
+namespace core {
+
+	template<typename T>
+	class task;
+
+	namespace detail {
+
+		namespace ref = impl::reference;
+
+		/**
+		 * Creates a task resuming the given coroutine, to be started by the caller.
+		 */
+		inline ref::TaskBase* make_resume_task(std::coroutine_handle<> handle) {
+			return ref::detail::make_continuation_task([handle]() { handle.resume(); });
+		}
+
+		/**
+		 * Schedules the resumption of the given coroutine once the given promise is delivered.
+		 * The coroutine may be resumed before this function returns.
+		 */
+		template<typename T>
+		void resume_after(const ref::PromisePtr<T>& promise, std::coroutine_handle<> handle) {
+			auto resume = make_resume_task(handle);
+			ref::detail::waitFor(*resume,promise);
+			resume->start();
+		}
+
+		/**
+		 * Schedules the resumption of the given coroutine once the referenced task is completed.
+		 * The coroutine may be resumed before this function returns.
+		 */
+		inline void resume_after(const ref::task_reference& reference, std::coroutine_handle<> handle) {
+			auto resume = make_resume_task(handle);
+			resume->addDependency(reference);
+			resume->start();
+		}
+
+		/**
+		 * A continuation forwarding the value it is called with.
+		 */
+		struct forward_value {
+
+			template<typename V>
+			V operator()(V&& value) const {
+				return std::move(value);
+			}
+
+			void operator()() const {}
+
+		};
+
+		/**
+		 * An awaiter for treetures, either owning the awaited treeture or referencing it.
+		 */
+		template<typename Treeture>
+		struct treeture_awaiter {
+
+			Treeture treeture;
+
+			bool await_ready() const {
+				return treeture.isDone();
+			}
+
+			void await_suspend(std::coroutine_handle<> handle) {
+				// the coroutine may be resumed right away, so this awaiter must not be touched afterwards
+				resume_after(treeture.getPromise(),handle);
+			}
+
+			auto await_resume() {
+				return std::forward<Treeture>(treeture).get();
+			}
+
+		};
+
+		/**
+		 * An awaiter for task references.
+		 */
+		struct task_reference_awaiter {
+
+			ref::task_reference reference;
+
+			bool await_ready() const {
+				return reference.isDone();
+			}
+
+			void await_suspend(std::coroutine_handle<> handle) {
+				resume_after(reference,handle);
+			}
+
+			void await_resume() const {}
+
+		};
+
+		/**
+		 * An awaiter for treetures of the sequential implementation, which are always completed.
+		 */
+		template<typename Treeture>
+		struct completed_awaiter {
+
+			Treeture treeture;
+
+			bool await_ready() const {
+				return true;
+			}
+
+			void await_suspend(std::coroutine_handle<>) {}
+
+			auto await_resume() {
+				return std::forward<Treeture>(treeture).get();
+			}
+
+		};
+
+		/**
+		 * The part of the promise of a task common to all result types.
+		 */
+		template<typename T>
+		class task_promise_base {
+
+		protected:
+
+			// the runtime promise receiving the result, created when the task is started
+			ref::PromisePtr<T> result;
+
+		public:
+
+			void setResult(const ref::PromisePtr<T>& promise) {
+				result = promise;
+			}
+
+			// tasks are started explicitly, see run(task<T>&&)
+			std::suspend_always initial_suspend() const noexcept {
+				return {};
+			}
+
+			// the frame is destroyed once the task is completed
+			std::suspend_never final_suspend() const noexcept {
+				return {};
+			}
+
+			void unhandled_exception() const {
+				// like other tasks, coroutines must not throw
+				std::terminate();
+			}
+
+			// -- awaitable objects --
+
+			template<typename R>
+			treeture_awaiter<ref::treeture<R>&> await_transform(ref::treeture<R>& treeture) const {
+				return { treeture };
+			}
+
+			template<typename R>
+			treeture_awaiter<ref::treeture<R>> await_transform(ref::treeture<R>&& treeture) const {
+				return { std::move(treeture) };
+			}
+
+			template<typename R>
+			treeture_awaiter<ref::treeture<R>> await_transform(ref::unreleased_treeture<R>&& treeture) const {
+				return { std::move(treeture).release() };
+			}
+
+			template<typename R>
+			treeture_awaiter<ref::treeture<R>> await_transform(task<R>&& task) const {
+				return { run(std::move(task)) };
+			}
+
+			template<typename R>
+			completed_awaiter<impl::sequential::treeture<R>&> await_transform(impl::sequential::treeture<R>& treeture) const {
+				return { treeture };
+			}
+
+			template<typename R>
+			completed_awaiter<impl::sequential::treeture<R>> await_transform(impl::sequential::treeture<R>&& treeture) const {
+				return { std::move(treeture) };
+			}
+
+			task_reference_awaiter await_transform(const ref::task_reference& reference) const {
+				return { reference };
+			}
+
+		};
+
+		template<typename T>
+		class task_promise : public task_promise_base<T> {
+
+		public:
+
+			task<T> get_return_object();
+
+			void return_value(T value) {
+				this->result->setValue(std::move(value));
+			}
+
+		};
+
+		template<>
+		class task_promise<void> : public task_promise_base<void> {
+
+		public:
+
+			task<void> get_return_object();
+
+			void return_void() {
+				this->result->setReady();
+			}
+
+		};
+
+	} // end namespace detail
+
+
+	/**
+	 * A coroutine computing a value of type T. Tasks are created in a suspended state and
+	 * started through run(...), resulting in a treeture, or by being co_await-ed within
+	 * another task. Once started, a task is processed by the workers of the runtime, where
+	 * every co_await on an incomplete treeture suspends the task until its value is available.
+	 */
+	template<typename T>
+	class task {
+
+	public:
+
+		using promise_type = detail::task_promise<T>;
+
+		using value_type = T;
+
+		using treeture_type = impl::reference::treeture<T>;
+
+	private:
+
+		using handle_type = std::coroutine_handle<promise_type>;
+
+		// the suspended coroutine, until it is started
+		handle_type handle;
+
+		friend class detail::task_promise<T>;
+
+		explicit task(handle_type handle) : handle(handle) {}
+
+	public:
+
+		task(const task&) = delete;
+
+		task(task&& other) : handle(other.handle) {
+			other.handle = nullptr;
+		}
+
+		task& operator=(const task&) = delete;
+
+		task& operator=(task&& other) {
+			std::swap(handle,other.handle);
+			return *this;
+		}
+
+		~task() {
+			// tasks never started are discarded
+			if (handle) handle.destroy();
+		}
+
+		/**
+		 * Starts the processing of this task on the runtime's workers.
+		 */
+		treeture_type release() && {
+
+			// there has to be a coroutine
+			assert_true(handle);
+
+			// the result is forwarded by a continuation, a root task which may be referenced
+			auto result = impl::reference::make_promise<T>();
+			handle.promise().setResult(result);
+			auto res = impl::reference::detail::make_continuation_task([result]() {
+				detail::forward_value forward;
+				return impl::reference::detail::continuation_call<T>()(forward,result);
+			});
+			impl::reference::detail::waitFor(*res,result);
+
+			// start the coroutine on a worker
+			detail::make_resume_task(handle)->start();
+			handle = nullptr;
+
+			return impl::reference::detail::init<true>(impl::reference::after(),res).release();
+		}
+
+		operator treeture_type() && {
+			return std::move(*this).release();
+		}
+
+		T get() && {
+			return std::move(*this).release().get();
+		}
+
+	};
+
+	/**
+	 * Starts the processing of the given task, like the release of an unreleased treeture.
+	 */
+	template<typename T>
+	impl::reference::treeture<T> run(task<T>&& task) {
+		return std::move(task).release();
+	}
+
+	namespace detail {
+
+		template<typename T>
+		task<T> task_promise<T>::get_return_object() {
+			return task<T>(std::coroutine_handle<task_promise<T>>::from_promise(*this));
+		}
+
+		inline task<void> task_promise<void>::get_return_object() {
+			return task<void>(std::coroutine_handle<task_promise<void>>::from_promise(*this));
+		}
+
+	} // end namespace detail
+
+} // end namespace core
+} // end namespace api
+} // end namespace allscale
+
+#endif
@@ -0,0 +1,623 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "allscale/utils/assert.h"
+
+#include "allscale/api/core/impl/reference/lock.h"
+
+namespace allscale {
+namespace api {
+namespace core {
+namespace impl {
+namespace reference {
+
+	namespace detail {
+
+		class SlabHeap;
+
+		/**
+		 * The node type utilized for forming lists of free memory blocks.
+		 */
+		struct FreeNode {
+			FreeNode* next;
+		};
+
+		/**
+		 * A bin maintaining the free blocks of a single size class of a heap.
+		 */
+		struct SizeClassBin {
+
+			// the heap this bin belongs to
+			SlabHeap* heap = nullptr;
+
+			// the list of free blocks, only accessed by the owner of the heap
+			FreeNode* local = nullptr;
+
+			// the list of blocks returned by other threads
+			std::atomic<FreeNode*> remote { nullptr };
+
+		};
+
+		/**
+		 * The header preceding every block handed out by a slab heap.
+		 */
+		struct alignas(std::max_align_t) BlockHeader {
+
+			// the bin to return the block to, null for blocks obtained from the global heap
+			SizeClassBin* owner;
+
+		};
+
+		/**
+		 * A thread-local heap for small objects like tasks and promises. Memory is obtained
+		 * from the global heap in large slabs which are carved into blocks of a fixed set of
+		 * size classes. Freed blocks are retained for re-use by the owner of the heap, blocks
+		 * freed by other threads are returned to the owner through a lock-free list.
+		 *
+		 * Slabs are never returned to the global heap, thus the memory footprint of a heap
+		 * is bounded by the peak number of objects allocated through it.
+		 */
+		class SlabHeap {
+
+		public:
+
+			// the granularity of size classes
+			enum { GRANULARITY = sizeof(BlockHeader) };
+
+			// the number of supported size classes
+			enum { NUM_SIZE_CLASSES = 32 };
+
+			// the largest block size served by this heap
+			enum { MAX_BLOCK_SIZE = std::size_t(GRANULARITY) * NUM_SIZE_CLASSES };
+
+			// the size of slabs requested from the global heap
+			enum { SLAB_SIZE = 64 * 1024 };
+
+		private:
+
+			// the bins for the individual size classes
+			std::array<SizeClassBin,NUM_SIZE_CLASSES> bins;
+
+			// the remaining range of the current slab
+			char* cur;
+			char* end;
+
+			// the most recently obtained slab, linked to its predecessors
+			char* slabs;
+
+			// the number of slabs obtained from the global heap
+			std::size_t numSlabs;
+
+		public:
+
+			SlabHeap() : cur(nullptr), end(nullptr), slabs(nullptr), numSlabs(0) {
+				for(auto& bin : bins) bin.heap = this;
+			}
+
+			~SlabHeap() {
+				while(slabs) {
+					char* next = *reinterpret_cast<char**>(slabs);
+					::operator delete(slabs);
+					slabs = next;
+				}
+			}
+
+			SlabHeap(const SlabHeap&) = delete;
+			SlabHeap(SlabHeap&&) = delete;
+
+			SlabHeap& operator=(const SlabHeap&) = delete;
+			SlabHeap& operator=(SlabHeap&&) = delete;
+
+			/**
+			 * Obtains a block of at least the given size. Must only be called by the owner of this heap.
+			 */
+			void* allocate(std::size_t size) {
+
+				// large objects are served by the global heap
+				if (size > MAX_BLOCK_SIZE) {
+					auto header = static_cast<BlockHeader*>(::operator new(sizeof(BlockHeader) + size));
+					header->owner = nullptr;
+					return header + 1;
+				}
+
+				// locate the bin of the size class
+				auto sizeClass = getSizeClass(size);
+				SizeClassBin& bin = bins[sizeClass];
+
+				// if there are no local free blocks, collect those returned by other threads
+				if (!bin.local && bin.remote.load(std::memory_order_relaxed)) {
+					bin.local = bin.remote.exchange(nullptr, std::memory_order_acquire);
+				}
+
+				// re-use a free block if possible
+				BlockHeader* header;
+				if (FreeNode* node = bin.local) {
+					bin.local = node->next;
+					header = reinterpret_cast<BlockHeader*>(node);
+				} else {
+					header = carve((sizeClass + 2) * GRANULARITY);
+				}
+
+				// link block to its bin
+				header->owner = &bin;
+				return header + 1;
+			}
+
+			/**
+			 * Returns the given block to the heap it has been allocated from. May be called by any thread.
+			 */
+			static void deallocate(void* ptr, const SlabHeap* local) {
+				if (!ptr) return;
+
+				// get the header of the block
+				auto header = static_cast<BlockHeader*>(ptr) - 1;
+				SizeClassBin* bin = header->owner;
+
+				// large objects are returned to the global heap
+				if (!bin) {
+					::operator delete(header);
+					return;
+				}
+
+				// re-interpret block as a free-list node
+				auto node = reinterpret_cast<FreeNode*>(header);
+
+				// blocks of the local heap are directly re-used
+				if (bin->heap == local) {
+					node->next = bin->local;
+					bin->local = node;
+					return;
+				}
+
+				// other blocks are returned to their owner
+				node->next = bin->remote.load(std::memory_order_relaxed);
+				while(!bin->remote.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+					// retry until successful
+				}
+			}
+
+			/**
+			 * Obtains the number of slabs requested from the global heap so far.
+			 */
+			std::size_t getNumSlabs() const {
+				return numSlabs;
+			}
+
+		private:
+
+			static std::size_t getSizeClass(std::size_t size) {
+				return (size == 0) ? 0 : (size - 1) / GRANULARITY;
+			}
+
+			BlockHeader* carve(std::size_t blockSize) {
+
+				// get a new slab if the current one is exhausted
+				if (std::size_t(end - cur) < blockSize) {
+					char* slab = static_cast<char*>(::operator new(SLAB_SIZE));
+					*reinterpret_cast<char**>(slab) = slabs;
+					slabs = slab;
+					cur = slab + GRANULARITY;
+					end = slab + SLAB_SIZE;
+					++numSlabs;
+				}
+
+				// cut off a block
+				auto res = reinterpret_cast<BlockHeader*>(cur);
+				cur += blockSize;
+				return res;
+			}
+
+		};
+
+		/**
+		 * A registry of slab heaps. Heaps of terminated threads are kept alive since
+		 * blocks may still be returned to them, and are re-used by new threads.
+		 */
+		class SlabHeapRegistry {
+
+			SpinLock lock;
+
+			std::vector<SlabHeap*> unused;
+
+		public:
+
+			static SlabHeapRegistry& getInstance() {
+				// intentionally never destroyed, since heaps may be used until the very end
+				static SlabHeapRegistry* registry = new SlabHeapRegistry();
+				return *registry;
+			}
+
+			SlabHeap* acquire() {
+				std::lock_guard<SpinLock> g(lock);
+				if (unused.empty()) return new SlabHeap();
+				auto res = unused.back();
+				unused.pop_back();
+				return res;
+			}
+
+			void release(SlabHeap* heap) {
+				std::lock_guard<SpinLock> g(lock);
+				unused.push_back(heap);
+			}
+
+		};
+
+		inline SlabHeap*& getLocalSlabHeapPtr() {
+			static thread_local SlabHeap* heap = nullptr;
+			return heap;
+		}
+
+		/**
+		 * Returns the heap of a thread to the registry upon thread termination.
+		 */
+		struct SlabHeapHandle {
+			~SlabHeapHandle() {
+				auto& heap = getLocalSlabHeapPtr();
+				if (!heap) return;
+				SlabHeapRegistry::getInstance().release(heap);
+				heap = nullptr;
+			}
+		};
+
+		inline SlabHeap& getLocalSlabHeap() {
+			auto& heap = getLocalSlabHeapPtr();
+			if (!heap) {
+				heap = SlabHeapRegistry::getInstance().acquire();
+				static thread_local SlabHeapHandle handle;
+				(void)handle;
+			}
+			return *heap;
+		}
+
+	} // end namespace detail
+
+
+	/**
+	 * Allocates a block of memory of the given size from the heap of the current thread.
+	 */
+	inline void* pool_allocate(std::size_t size) {
+		return detail::getLocalSlabHeap().allocate(size);
+	}
+
+	/**
+	 * Frees a block of memory obtained through pool_allocate. It may be called by any thread.
+	 */
+	inline void pool_deallocate(void* ptr) {
+		detail::SlabHeap::deallocate(ptr, detail::getLocalSlabHeapPtr());
+	}
+
+
+	/**
+	 * A standard-conforming allocator utilizing the thread-local memory pools.
+	 */
+	template<typename T>
+	class PoolAllocator {
+
+	public:
+
+		using value_type = T;
+
+		PoolAllocator() = default;
+
+		template<typename O>
+		PoolAllocator(const PoolAllocator<O>&) {}
+
+		T* allocate(std::size_t n) {
+			return static_cast<T*>(pool_allocate(n * sizeof(T)));
+		}
+
+		void deallocate(T* ptr, std::size_t) {
+			pool_deallocate(ptr);
+		}
+
+		template<typename O>
+		bool operator==(const PoolAllocator<O>&) const {
+			return true;
+		}
+
+		template<typename O>
+		bool operator!=(const PoolAllocator<O>&) const {
+			return false;
+		}
+
+	};
+
+
+	namespace detail {
+
+		/**
+		 * A thread-local bump allocator for short-lived memory of tasks. Memory is handed out
+		 * from a list of chunks in stack order. A mark taken when a task starts is utilized to
+		 * release all memory allocated by the task at once when it ends. Individual
+		 * deallocations are only honored for the most recent allocation.
+		 *
+		 * Chunks are retained for re-use, thus the memory footprint of an arena is bounded
+		 * by the peak amount of memory allocated through it. Chunks exceeding the default
+		 * chunk size, obtained for large blocks, are returned to the global heap once the
+		 * scope utilizing them is left.
+		 */
+		class TaskArena {
+
+		public:
+
+			// the minimal size of chunks requested from the global heap
+			enum { CHUNK_SIZE = 64 * 1024 };
+
+		private:
+
+			struct alignas(std::max_align_t) Chunk {
+
+				// the next chunk, either in use or retained for re-use
+				Chunk* next;
+
+				// the usable size of this chunk
+				std::size_t size;
+
+				char* begin() {
+					return reinterpret_cast<char*>(this + 1);
+				}
+
+				char* end() {
+					return begin() + size;
+				}
+
+			};
+
+			// the list of all chunks of this arena
+			Chunk* chunks;
+
+			// the chunk currently allocated from, null if none
+			Chunk* current;
+
+			// the remaining range of the current chunk
+			char* cur;
+			char* end;
+
+			// the number of open scopes
+			unsigned depth;
+
+		public:
+
+			/**
+			 * A position within the arena to return to.
+			 */
+			struct Mark {
+				Chunk* chunk;
+				char* cur;
+			};
+
+			TaskArena() : chunks(nullptr), current(nullptr), cur(nullptr), end(nullptr), depth(0) {}
+
+			~TaskArena() {
+				while(chunks) {
+					Chunk* next = chunks->next;
+					::operator delete(chunks);
+					chunks = next;
+				}
+			}
+
+			TaskArena(const TaskArena&) = delete;
+			TaskArena(TaskArena&&) = delete;
+
+			TaskArena& operator=(const TaskArena&) = delete;
+			TaskArena& operator=(TaskArena&&) = delete;
+
+			/**
+			 * Tests whether there is an open scope, and thus allocations may be served by this arena.
+			 */
+			bool isActive() const {
+				return depth > 0;
+			}
+
+			/**
+			 * Opens a scope, obtaining the mark to return to when closing it.
+			 */
+			Mark enter() {
+				++depth;
+				return { current, cur };
+			}
+
+			/**
+			 * Closes a scope, releasing all memory allocated since it has been opened.
+			 */
+			void leave(const Mark& mark) {
+				assert_lt(0u,depth);
+				--depth;
+
+				// return oversized chunks utilized within the scope to the global heap
+				if (current != mark.chunk) {
+					Chunk** link = (mark.chunk) ? &mark.chunk->next : &chunks;
+					Chunk* last = current;
+					bool done = false;
+					while(!done) {
+						Chunk* chunk = *link;
+						done = (chunk == last);
+						if (chunk->size > CHUNK_SIZE) {
+							*link = chunk->next;
+							::operator delete(chunk);
+						} else {
+							link = &chunk->next;
+						}
+					}
+				}
+
+				current = mark.chunk;
+				cur = mark.cur;
+				end = (current) ? current->end() : nullptr;
+			}
+
+			/**
+			 * Obtains a block of the given size and alignment.
+			 */
+			void* allocate(std::size_t size, std::size_t align) {
+				char* res = alignUp(cur, align);
+				if (!current || size > std::size_t(end - res)) {
+					res = grow(size, align);
+				}
+				cur = res + size;
+				return res;
+			}
+
+			/**
+			 * Frees the given block, which is only reclaimed if it is the most recent allocation.
+			 */
+			void deallocate(void* ptr, std::size_t size) {
+				if (static_cast<char*>(ptr) + size == cur) cur = static_cast<char*>(ptr);
+			}
+
+			/**
+			 * Tests whether the given block has been allocated from this arena.
+			 */
+			bool contains(const void* ptr) const {
+				auto p = static_cast<const char*>(ptr);
+				for(Chunk* c = chunks; c; c = c->next) {
+					if (c->begin() <= p && p < c->end()) return true;
+				}
+				return false;
+			}
+
+			/**
+			 * Obtains the number of bytes of the chunks obtained from the global heap so far.
+			 */
+			std::size_t getCapacity() const {
+				std::size_t res = 0;
+				for(Chunk* c = chunks; c; c = c->next) {
+					res += c->size;
+				}
+				return res;
+			}
+
+		private:
+
+			static char* alignUp(char* ptr, std::size_t align) {
+				auto addr = reinterpret_cast<std::uintptr_t>(ptr);
+				return reinterpret_cast<char*>((addr + align - 1) & ~(std::uintptr_t)(align - 1));
+			}
+
+			char* grow(std::size_t size, std::size_t align) {
+
+				// continue with the next retained chunk if it is large enough, otherwise insert a new one
+				Chunk* next = (current) ? current->next : chunks;
+				if (!next || next->size < size + align) {
+					std::size_t chunkSize = std::max<std::size_t>(CHUNK_SIZE, size + align);
+					Chunk* chunk = static_cast<Chunk*>(::operator new(sizeof(Chunk) + chunkSize));
+					chunk->next = next;
+					chunk->size = chunkSize;
+					if (current) {
+						current->next = chunk;
+					} else {
+						chunks = chunk;
+					}
+					next = chunk;
+				}
+
+				// make it the current chunk
+				current = next;
+				cur = current->begin();
+				end = current->end();
+				return alignUp(cur, align);
+			}
+
+		};
+
+		inline TaskArena& getLocalTaskArena() {
+			static thread_local TaskArena arena;
+			return arena;
+		}
+
+	} // end namespace detail
+
+
+	/**
+	 * A scope for the temporary memory of a task. All memory allocated through task-local
+	 * allocators by the current thread within this scope is released when it is left.
+	 */
+	class TaskArenaScope {
+
+		detail::TaskArena& arena;
+
+		detail::TaskArena::Mark mark;
+
+	public:
+
+		TaskArenaScope() : arena(detail::getLocalTaskArena()), mark(arena.enter()) {}
+
+		TaskArenaScope(const TaskArenaScope&) = delete;
+		TaskArenaScope& operator=(const TaskArenaScope&) = delete;
+
+		~TaskArenaScope() {
+			arena.leave(mark);
+		}
+
+	};
+
+
+	/**
+	 * A standard-conforming allocator for temporary memory of tasks, served by a thread-local
+	 * arena. The memory is released in bulk once the task allocating it ends, thus it must
+	 * neither escape the task, e.g. as part of its result, nor be passed to other threads.
+	 * Outside of tasks, memory is obtained from the global heap.
+	 */
+	template<typename T>
+	class TaskLocalAllocator {
+
+		// every block is preceded by a header, its last byte tagging the origin of the block
+		enum : std::size_t { HEADER = alignof(T) };
+		enum : char { HEAP, ARENA };
+
+	public:
+
+		using value_type = T;
+
+		TaskLocalAllocator() = default;
+
+		template<typename O>
+		TaskLocalAllocator(const TaskLocalAllocator<O>&) {}
+
+		T* allocate(std::size_t n) {
+			auto& arena = detail::getLocalTaskArena();
+			char* block;
+			if (arena.isActive()) {
+				block = static_cast<char*>(arena.allocate(n * sizeof(T) + HEADER, alignof(T)));
+				block[HEADER-1] = ARENA;
+			} else {
+				block = static_cast<char*>(::operator new(n * sizeof(T) + HEADER));
+				block[HEADER-1] = HEAP;
+			}
+			return reinterpret_cast<T*>(block + HEADER);
+		}
+
+		void deallocate(T* ptr, std::size_t n) {
+			char* block = reinterpret_cast<char*>(ptr) - HEADER;
+			if (block[HEADER-1] == HEAP) {
+				::operator delete(block);
+				return;
+			}
+			detail::getLocalTaskArena().deallocate(block, n * sizeof(T) + HEADER);
+		}
+
+		template<typename O>
+		bool operator==(const TaskLocalAllocator<O>&) const {
+			return true;
+		}
+
+		template<typename O>
+		bool operator!=(const TaskLocalAllocator<O>&) const {
+			return false;
+		}
+
+	};
+
+} // end namespace reference
+} // end namespace impl
+} // end namespace core
+} // end namespace api
+} // end namespace allscale
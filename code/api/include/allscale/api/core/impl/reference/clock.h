@@ -0,0 +1,182 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined _MSC_VER
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace allscale {
+namespace api {
+namespace core {
+namespace impl {
+namespace reference {
+
+	namespace detail {
+
+		/**
+		 * Reads the time stamp counter, or the closest equivalent of the current platform.
+		 * The read may be reordered with surrounding instructions.
+		 */
+		inline uint64_t readTimeStampCounter() {
+			#if defined _MSC_VER || defined(__x86_64__) || defined(__i386__)
+				return __rdtsc();
+			#elif defined (__ppc64__) || defined (_ARCH_PPC64) || defined(__powerpc__) || defined(__ppc__)
+				int64_t tb;
+				asm volatile("mfspr %0, 268" : "=r"(tb));
+				return tb;
+			#elif defined(__aarch64__)
+				uint64_t cnt;
+				asm volatile("mrs %0, cntvct_el0" : "=r"(cnt));
+				return cnt;
+			#else
+				return std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now().time_since_epoch()
+				).count();
+			#endif
+		}
+
+		/**
+		 * Reads the time stamp counter after all preceding instructions have completed and
+		 * before any subsequent instruction gets started.
+		 */
+		inline uint64_t readTimeStampCounterOrdered() {
+			#if defined _MSC_VER || defined(__x86_64__) || defined(__i386__)
+				unsigned aux;
+				uint64_t res = __rdtscp(&aux);
+				_mm_lfence();
+				return res;
+			#elif defined(__aarch64__)
+				uint64_t cnt;
+				asm volatile("isb; mrs %0, cntvct_el0; isb" : "=r"(cnt) :: "memory");
+				return cnt;
+			#else
+				return readTimeStampCounter();
+			#endif
+		}
+
+	} // end namespace detail
+
+
+	/**
+	 * A clock based on the time stamp counter of the processor, the cheapest source of time
+	 * stamps available. The counter is assumed to be invariant and synchronized among cores,
+	 * as it is on contemporary x86 systems. Ticks are converted into nanoseconds of the
+	 * monotonic system clock by a linear mapping, calibrated once on first use.
+	 */
+	class TscClock {
+
+	public:
+
+		using rep = uint64_t;
+
+		/**
+		 * Obtains the current tick count. The read may be reordered with surrounding instructions,
+		 * which is acceptable for time stamps of events.
+		 */
+		static rep now() {
+			return detail::readTimeStampCounter();
+		}
+
+		/**
+		 * Obtains the current tick count, ordered with respect to surrounding instructions, as
+		 * required for measuring the duration of code regions.
+		 */
+		static rep nowOrdered() {
+			return detail::readTimeStampCounterOrdered();
+		}
+
+		/**
+		 * Triggers the calibration of this clock, if not done already. The calibration takes a
+		 * few milliseconds, and should thus be conducted before measurements are taken.
+		 */
+		static void calibrate() {
+			getCalibration();
+		}
+
+		/**
+		 * Obtains the number of ticks per nanosecond.
+		 */
+		static double getTicksPerNanosecond() {
+			return 1 / getCalibration().nsPerTick;
+		}
+
+		/**
+		 * Converts the given tick count into a time stamp of the monotonic system clock, in nanoseconds.
+		 */
+		static uint64_t toNanoseconds(rep ticks) {
+			const auto& calibration = getCalibration();
+			double res = double(calibration.nsBase) + double(int64_t(ticks - calibration.tscBase)) * calibration.nsPerTick;
+			return (res > 0) ? uint64_t(res) : 0;
+		}
+
+		/**
+		 * Converts the given number of ticks into a duration in nanoseconds.
+		 */
+		static std::chrono::nanoseconds toDuration(rep ticks) {
+			return std::chrono::nanoseconds(uint64_t(double(ticks) * getCalibration().nsPerTick));
+		}
+
+	private:
+
+		struct Calibration {
+			rep tscBase;           // < the tick count at the reference point
+			uint64_t nsBase;       // < the system time at the reference point
+			double nsPerTick;      // < the slope of the mapping
+		};
+
+		static uint64_t getMonotonicTime() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()
+			).count();
+		}
+
+		/**
+		 * Samples both clocks, such that the tick count corresponds to the system time
+		 * as closely as possible.
+		 */
+		static void sample(rep& tsc, uint64_t& ns) {
+			// take the sample with the tightest bracket of ticks
+			rep best = 0;
+			for(int i=0; i<5; i++) {
+				auto a = nowOrdered();
+				auto t = getMonotonicTime();
+				auto b = nowOrdered();
+				if (i == 0 || b - a < best) {
+					best = b - a;
+					tsc = a + (b - a) / 2;
+					ns = t;
+				}
+			}
+		}
+
+		static Calibration doCalibrate() {
+			Calibration res { 0, 0, 1.0 };
+			sample(res.tscBase, res.nsBase);
+
+			// observe both clocks for a while
+			rep tsc = 0;
+			uint64_t ns = 0;
+			do {
+				sample(tsc, ns);
+			} while(ns - res.nsBase < 10*1000*1000);
+
+			res.nsPerTick = (tsc > res.tscBase) ? double(ns - res.nsBase) / double(tsc - res.tscBase) : 1.0;
+			return res;
+		}
+
+		static const Calibration& getCalibration() {
+			static const Calibration calibration = doCalibrate();
+			return calibration;
+		}
+
+	};
+
+} // end namespace reference
+} // end namespace impl
+} // end namespace core
+} // end namespace api
+} // end namespace allscale
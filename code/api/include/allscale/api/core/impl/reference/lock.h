@@ -3,6 +3,15 @@
 #include <atomic>
 #include <thread>
 
+#ifdef __linux__
+	#include <linux/futex.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#else
+	#include <condition_variable>
+	#include <mutex>
+#endif
+
 #if defined _MSC_VER
 // required for YieldProcessor macro
 #define NOMINMAX
@@ -72,6 +81,92 @@ inline namespace simple {
         }
     };
 
+	/**
+	 * A parking spot enabling a single thread to suspend its execution until
+	 * being notified by another thread. To avoid lost notifications, the thread
+	 * first announces its intention to park, re-checks its wake-up condition,
+	 * and only then either cancels the request or parks. A notification issued
+	 * after the announcement will either cancel the parking or end it.
+	 */
+	class Parker {
+
+		enum : int { Running = 0, Parked = 1, Notified = 2 };
+
+		std::atomic<int> state;
+
+		#ifndef __linux__
+			std::mutex m;
+			std::condition_variable cv;
+		#endif
+
+	public:
+
+		Parker() : state(Running) {}
+
+		Parker(const Parker&) = delete;
+		Parker& operator=(const Parker&) = delete;
+
+		/**
+		 * Announces the intention of the owning thread to park.
+		 */
+		void prepare() {
+			state.store(Parked, std::memory_order_seq_cst);
+		}
+
+		/**
+		 * Withdraws a prior announcement.
+		 *
+		 * @return true if it was withdrawn, false if a notification has been consumed instead
+		 */
+		bool cancel() {
+			int expected = Parked;
+			if (state.compare_exchange_strong(expected, Running)) return true;
+			state.store(Running, std::memory_order_relaxed);
+			return false;
+		}
+
+		/**
+		 * Suspends the owning thread until being notified. Must be preceded by prepare().
+		 */
+		void park() {
+			while(state.load(std::memory_order_acquire) == Parked) {
+				#ifdef __linux__
+					syscall(SYS_futex, reinterpret_cast<int*>(&state), FUTEX_WAIT_PRIVATE, Parked, nullptr, nullptr, 0);
+				#else
+					std::unique_lock<std::mutex> lk(m);
+					if (state.load(std::memory_order_acquire) == Parked) cv.wait(lk);
+				#endif
+			}
+			state.store(Running, std::memory_order_relaxed);
+		}
+
+		/**
+		 * Notifies the owning thread if it is parked or about to park.
+		 *
+		 * @return true if this call ended a parking request, false otherwise
+		 */
+		bool notify() {
+			int expected = Parked;
+			if (!state.compare_exchange_strong(expected, Notified)) return false;
+			#ifdef __linux__
+				syscall(SYS_futex, reinterpret_cast<int*>(&state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+			#else
+				std::lock_guard<std::mutex> g(m);
+				cv.notify_one();
+			#endif
+			return true;
+		}
+
+		/**
+		 * Tests whether the owning thread is parked or about to park.
+		 */
+		bool isParked() const {
+			return state.load(std::memory_order_relaxed) == Parked;
+		}
+
+	};
+
+
 	/**
 	 * An optimistic read/write lock.
 	 */
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+namespace allscale {
+namespace api {
+namespace core {
+namespace impl {
+namespace reference {
+
+	/**
+	 * The priority bands of tasks. Workers process ready tasks of higher bands first, both
+	 * from their local queues and when stealing. Tasks on the critical path of a computation,
+	 * e.g. those other tasks depend on, should be assigned a high priority, bulk work not
+	 * urgently needed a low one.
+	 */
+	enum class TaskPriority : std::uint8_t {
+		Low,
+		Normal,
+		High
+	};
+
+	inline std::ostream& operator<<(std::ostream& out, TaskPriority priority) {
+		switch(priority) {
+			case TaskPriority::Low:    return out << "low";
+			case TaskPriority::Normal: return out << "normal";
+			case TaskPriority::High:   return out << "high";
+		}
+		return out << "invalid";
+	}
+
+
+	namespace detail {
+
+		inline TaskPriority& getCurrentTaskPriorityRef() {
+			static thread_local TaskPriority priority = TaskPriority::Normal;
+			return priority;
+		}
+
+	}
+
+	/**
+	 * Obtains the priority to be assigned to tasks created by the current thread.
+	 */
+	inline TaskPriority getCurrentTaskPriority() {
+		return detail::getCurrentTaskPriorityRef();
+	}
+
+	/**
+	 * A scope within which created tasks are assigned the given priority. Like the split
+	 * policy, the priority is inherited by the tasks created while processing a task,
+	 * including its sub-tasks when being split.
+	 */
+	class TaskPriorityScope {
+
+		TaskPriority old;
+
+	public:
+
+		TaskPriorityScope(TaskPriority priority) : old(getCurrentTaskPriority()) {
+			detail::getCurrentTaskPriorityRef() = priority;
+		}
+
+		TaskPriorityScope(const TaskPriorityScope&) = delete;
+		TaskPriorityScope& operator=(const TaskPriorityScope&) = delete;
+
+		~TaskPriorityScope() {
+			detail::getCurrentTaskPriorityRef() = old;
+		}
+
+	};
+
+} // end namespace reference
+} // end namespace impl
+} // end namespace core
+} // end namespace api
+} // end namespace allscale
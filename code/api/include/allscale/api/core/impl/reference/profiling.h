@@ -1,12 +1,28 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
 #include <vector>
 #include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
 
+#include "allscale/utils/assert.h"
+
+#include "allscale/api/core/impl/reference/clock.h"
 #include "allscale/api/core/impl/reference/task_id.h"
 
 namespace allscale {
@@ -40,6 +56,7 @@ namespace reference {
 
 			// control events
 			EndOfStream,			// < the last event, to mark the end of a stream
+			EntriesDropped,			// < a number of preceding events got lost since a bounded buffer was full
 		};
 
 	private:
@@ -74,6 +91,14 @@ namespace reference {
 			return task;
 		}
 
+		/**
+		 * Obtains the number of lost events reported by an EntriesDropped entry.
+		 */
+		uint64_t getNumDropped() const {
+			assert_eq(EntriesDropped, kind);
+			return task.getRootID();
+		}
+
 		// -- factories --
 
 		static ProfileLogEntry createWorkerCreatedEntry() {
@@ -96,6 +121,10 @@ namespace reference {
 			return ProfileLogEntry(getCurrentTime(), TaskStolen, task);
 		}
 
+		static ProfileLogEntry createTaskSplitEntry(const TaskID& task) {
+			return ProfileLogEntry(getCurrentTime(), TaskSplit, task);
+		}
+
 		static ProfileLogEntry createTaskStartedEntry(const TaskID& task) {
 			return ProfileLogEntry(getCurrentTime(), TaskStarted, task);
 		}
@@ -104,6 +133,15 @@ namespace reference {
 			return ProfileLogEntry(getCurrentTime(), TaskEnded, task);
 		}
 
+		static ProfileLogEntry createEntriesDroppedEntry(uint64_t count) {
+			// the count is stored in place of a task ID, such that it is retained by all log formats
+			return ProfileLogEntry(getCurrentTime(), EntriesDropped, TaskID(count));
+		}
+
+		static ProfileLogEntry restore(uint64_t time, Kind kind, const TaskID& task) {
+			return ProfileLogEntry(time, kind, task);
+		}
+
 		// -- utility functions --
 
 		bool operator<(const ProfileLogEntry& other) {
@@ -128,23 +166,30 @@ namespace reference {
 			case TaskStarted:     return out << "Task " << entry.task << " started";
 			case TaskEnded:       return out << "Task " << entry.task << " ended";
 
+			// control events
+			case EntriesDropped:  return out << entry.getNumDropped() << " entries dropped";
+
 			// everything else
 			default:              return out << "Unknown event!";
 			}
 		}
 
-	private:
+		/**
+		 * Obtains a copy of this entry with its time stamp converted from ticks of the
+		 * TscClock into nanoseconds, as it is done when saving logs.
+		 */
+		ProfileLogEntry toNanoseconds() const {
+			return ProfileLogEntry(TscClock::toNanoseconds(time), kind, task);
+		}
 
 		/**
-		 * A utility to retrieve a timestamp for events.
+		 * A utility to retrieve a timestamp for events, in ticks of the TscClock.
 		 */
 		static uint64_t getCurrentTime() {
 			static thread_local uint64_t last = 0;
 
 			// get current time
-			uint64_t cur = std::chrono::duration_cast<std::chrono::nanoseconds>(
-				std::chrono::high_resolution_clock::now().time_since_epoch()
-			).count();
+			uint64_t cur = TscClock::now();
 
 			// make sure time is progressing
 			if (cur > last) {
@@ -160,6 +205,102 @@ namespace reference {
 
 
 
+	namespace detail {
+
+		// the marker at the begin of log files consisting of encoded chunks
+		const char CHUNKED_LOG_MAGIC[8] = { 'A', 'S', 'P', 'L', 'O', 'G', '0', '1' };
+
+		inline void writeVarInt(std::string& out, uint64_t value) {
+			while(value >= 0x80) {
+				out.push_back(char((value & 0x7f) | 0x80));
+				value >>= 7;
+			}
+			out.push_back(char(value));
+		}
+
+		inline bool readVarInt(const char*& cur, const char* end, uint64_t& res) {
+			res = 0;
+			for(unsigned shift = 0; cur != end && shift < 64; shift += 7) {
+				auto byte = (unsigned char)*cur++;
+				res |= uint64_t(byte & 0x7f) << shift;
+				if (!(byte & 0x80)) return true;
+			}
+			return false;
+		}
+
+		/**
+		 * Encodes the given entries compactly: time stamps are delta encoded, and together with
+		 * the task IDs stored as variable length integers. Chunks may be decoded independently.
+		 */
+		inline std::string encodeChunk(const std::vector<ProfileLogEntry>& entries) {
+			std::string res;
+			uint64_t last = 0;
+			for(const auto& cur : entries) {
+				// time stamps are expected to be increasing, yet decreasing ones are supported
+				auto time = cur.getTimestamp();
+				uint64_t delta = (time >= last) ? (time - last) << 1 : ((last - time) << 1) | 1;
+				last = time;
+
+				res.push_back(char(cur.getKind()));
+				writeVarInt(res, delta);
+				writeVarInt(res, cur.getTask().getRootID());
+				writeVarInt(res, cur.getTask().getPath().getPath());
+				res.push_back(char(cur.getTask().getPath().getLength()));
+			}
+			return res;
+		}
+
+		/**
+		 * Decodes a chunk produced by encodeChunk, passing the entries to the given operation.
+		 * Returns false if the chunk is malformed.
+		 */
+		template<typename Op>
+		bool decodeChunk(const std::string& chunk, const Op& op) {
+			const char* cur = chunk.data();
+			const char* end = cur + chunk.size();
+			uint64_t last = 0;
+			while(cur != end) {
+				auto kind = ProfileLogEntry::Kind((unsigned char)*cur++);
+				uint64_t delta, id, path;
+				if (!readVarInt(cur, end, delta)) return false;
+				if (!readVarInt(cur, end, id)) return false;
+				if (!readVarInt(cur, end, path)) return false;
+				if (cur == end) return false;
+				unsigned length = (unsigned char)*cur++;
+				if (length > 64) return false;
+
+				last = (delta & 1) ? last - (delta >> 1) : last + (delta >> 1);
+
+				// rebuild the task path from the root
+				auto taskPath = TaskPath::root();
+				for(unsigned i=length; i>0; --i) {
+					taskPath = ((path >> (i-1)) & 1) ? taskPath.getRightChildPath() : taskPath.getLeftChildPath();
+				}
+
+				op(ProfileLogEntry::restore(last, kind, TaskID(id, taskPath)));
+			}
+			return true;
+		}
+
+		/**
+		 * Appends a chunk of the given number of encoded entries to a chunked log file.
+		 */
+		inline void writeChunk(std::ostream& out, std::size_t numEntries, const std::string& data) {
+			uint32_t header[2] = { uint32_t(numEntries), uint32_t(data.size()) };
+			out.write((char*)&header, sizeof(header));
+			out.write(data.data(), data.size());
+		}
+
+		/**
+		 * Obtains the name of the file retaining the previous segment of a log written in the Recent mode.
+		 */
+		inline std::string getPreviousSegmentFileName(const std::string& file) {
+			return file + ".old";
+		}
+
+	} // end namespace detail
+
+
 	class ProfileLog {
 
 	public:
@@ -209,7 +350,7 @@ namespace reference {
 
 		// -- log entry iteration --
 
-		class iterator : public std::iterator<std::input_iterator_tag,ProfileLogEntry> {
+		class iterator {
 
 			block_const_iter b_cur;
 			block_const_iter b_end;
@@ -221,6 +362,12 @@ namespace reference {
 
 		public:
 
+			using iterator_category = std::input_iterator_tag;
+			using value_type = ProfileLogEntry;
+			using difference_type = std::ptrdiff_t;
+			using pointer = ProfileLogEntry*;
+			using reference = ProfileLogEntry&;
+
 			static iterator begin(const block_list_t& blocks, const entry_const_iter& log_end) {
 				iterator res;
 				res.b_cur = blocks.begin();
@@ -305,9 +452,14 @@ namespace reference {
 			}
 			out.write((char*)&offset,sizeof(offset));
 
-			// save all blocks
-			for(const auto& cur : data) {
-				out.write((char*)&cur,sizeof(block_t));
+			// save all blocks, with time stamps converted into nanoseconds
+			std::unique_ptr<block_t> buffer(new block_t());
+			for(auto it = data.begin(); it != data.end(); ++it) {
+				auto end = (std::next(it) == data.end()) ? next : it->end();
+				std::transform(it->begin(), end, buffer->begin(), [](const ProfileLogEntry& entry) {
+					return entry.toNanoseconds();
+				});
+				out.write((char*)buffer.get(),sizeof(block_t));
 			}
 		}
 
@@ -317,6 +469,17 @@ namespace reference {
 		}
 
 		static ProfileLog loadFrom(std::istream& in) {
+
+			// check for a log consisting of encoded chunks
+			char magic[sizeof(detail::CHUNKED_LOG_MAGIC)] = { 0 };
+			auto start = in.tellg();
+			in.read(magic, sizeof(magic));
+			if (in && std::equal(magic, magic + sizeof(magic), detail::CHUNKED_LOG_MAGIC)) {
+				return loadChunksFrom(in);
+			}
+			in.clear();
+			in.seekg(start);
+
 			// load the number of blocks
 			std::size_t num_blocks;
 			in.read((char*)&num_blocks,sizeof(num_blocks));
@@ -345,6 +508,33 @@ namespace reference {
 			return loadFrom(src);
 		}
 
+		/**
+		 * Loads a log written in the Recent mode, consisting of the previous segment, if present,
+		 * followed by the current segment stored in the given file.
+		 */
+		static ProfileLog loadRecentFrom(const std::string& file) {
+			std::fstream previous(detail::getPreviousSegmentFileName(file).c_str(), std::ios::in | std::ios::binary);
+			ProfileLog log = (previous) ? loadFrom(previous) : ProfileLog();
+			for(const auto& entry : loadFrom(file)) {
+				log << entry;
+			}
+			return log;
+		}
+
+	private:
+
+		static ProfileLog loadChunksFrom(std::istream& in) {
+			ProfileLog log;
+			uint32_t header[2];
+			std::string data;
+			while(in.read((char*)&header, sizeof(header))) {
+				data.resize(header[1]);
+				if (!in.read(&data[0], header[1])) break;		// a truncated chunk, e.g. due to a crash
+				detail::decodeChunk(data, [&](const ProfileLogEntry& entry) { log << entry; });
+			}
+			return log;
+		}
+
 	};
 
 	inline std::string getLogFileNameForWorker(int id) {
@@ -364,24 +554,700 @@ namespace reference {
 		getCurrentWorkerID() = id;
 	}
 
+	// -- trace export --
+
+	/**
+	 * A writer emitting events in the JSON array format of the Chrome trace event format,
+	 * as accepted by chrome://tracing and the Perfetto UI. Events are written as they are
+	 * added. The closing bracket is optional in this format, thus the produced stream is a
+	 * valid trace at any point in time. Time stamps are given in nanoseconds.
+	 */
+	class TraceEventWriter {
+
+		std::ostream& out;
+
+		bool empty;
+
+		bool closed;
+
+	public:
+
+		TraceEventWriter(std::ostream& out) : out(out), empty(true), closed(false) {
+			out << "[";
+		}
+
+		TraceEventWriter(const TraceEventWriter&) = delete;
+		TraceEventWriter& operator=(const TraceEventWriter&) = delete;
+
+		~TraceEventWriter() {
+			close();
+		}
+
+		/**
+		 * Adds a meta data event naming the given thread.
+		 */
+		void addThreadName(int thread, const std::string& name) {
+			start('M', thread) << ",\"name\":\"thread_name\",\"args\":{\"name\":\"" << name << "\"}}";
+		}
+
+		/**
+		 * Adds a slice covering the given time interval on the given thread.
+		 */
+		void addSlice(int thread, const std::string& name, const std::string& category, uint64_t begin, uint64_t end) {
+			start('X', thread) << ",\"name\":\"" << name << "\",\"cat\":\"" << category << "\",\"ts\":";
+			printTime(begin);
+			out << ",\"dur\":";
+			printTime(end - begin);
+			out << "}";
+		}
+
+		/**
+		 * Adds an event of the flow of the given task, connecting the slices enclosing
+		 * the given time stamps. The phase is either 's' (start), 't' (step), or 'f' (end).
+		 */
+		void addFlow(char phase, int thread, uint64_t time, const TaskID& task) {
+			start(phase, thread) << ",\"name\":\"spawn\",\"cat\":\"task\",\"id\":\"" << task << "\",\"ts\":";
+			printTime(time);
+			if (phase != 's') out << ",\"bp\":\"e\"";
+			out << "}";
+		}
+
+		/**
+		 * Terminates the event list. No events may be added afterwards.
+		 */
+		void close() {
+			if (closed) return;
+			out << "\n]\n";
+			out.flush();
+			closed = true;
+		}
+
+	private:
+
+		std::ostream& start(char phase, int thread) {
+			assert_false(closed) << "Trace is already closed.";
+			out << (empty ? "\n" : ",\n");
+			empty = false;
+			return out << "{\"ph\":\"" << phase << "\",\"pid\":0,\"tid\":" << thread;
+		}
+
+		void printTime(uint64_t ns) {
+			// the format expects micro-seconds, fractions are retained
+			char buffer[32];
+			snprintf(buffer, 32, "%llu.%03u", (unsigned long long)(ns / 1000), (unsigned)(ns % 1000));
+			out << buffer;
+		}
+
+	};
+
+	/**
+	 * Converts profile log entries of workers into trace events. TaskStarted/TaskEnded pairs
+	 * become task slices and WorkerSuspended/WorkerResumed pairs become idle slices. TaskSplit
+	 * and TaskStolen entries become short slices, linked through flow events to the processing
+	 * of the resulting sub-tasks. The entries of each worker have to be processed in the order
+	 * they have been logged, while the entries of different workers may be interleaved.
+	 */
+	class TraceConverter {
+
+		struct WorkerState {
+
+			// the tasks currently processed by the worker, innermost last
+			std::vector<std::pair<TaskID,uint64_t>> tasks;
+
+			// the time the worker got suspended, if it is suspended
+			bool suspended = false;
+			uint64_t suspendTime = 0;
+
+			// the last time stamp observed for the worker
+			uint64_t lastTime = 0;
+		};
+
+		TraceEventWriter& writer;
+
+		// the time stamp to be mapped to the begin of the trace
+		uint64_t base;
+
+		std::map<int,WorkerState> workers;
+
+	public:
+
+		TraceConverter(TraceEventWriter& writer, uint64_t base = 0)
+			: writer(writer), base(base) {}
+
+		void process(int worker, const ProfileLogEntry& entry) {
+
+			// register new workers
+			auto pos = workers.find(worker);
+			if (pos == workers.end()) {
+				pos = workers.insert({ worker, WorkerState() }).first;
+				writer.addThreadName(worker, "Worker " + std::to_string(worker));
+			}
+			auto& state = pos->second;
+
+			// events preceding the begin of the trace are moved to its begin
+			auto time = (entry.getTimestamp() > base) ? entry.getTimestamp() - base : 0;
+			state.lastTime = std::max(state.lastTime, time);
+
+			const auto& task = entry.getTask();
+			switch(entry.getKind()) {
+
+			case ProfileLogEntry::TaskStarted: {
+				state.tasks.push_back({ task, time });
+				if (task.getDepth() > 0) writer.addFlow('f', worker, time, task);
+				break;
+			}
+
+			case ProfileLogEntry::TaskEnded: {
+				// search from the innermost task, to tolerate lost entries
+				for(auto it = state.tasks.rbegin(); it != state.tasks.rend(); ++it) {
+					if (it->first != task) continue;
+					writer.addSlice(worker, toString(task), "task", it->second, time);
+					state.tasks.erase(std::next(it).base(), state.tasks.end());
+					break;
+				}
+				break;
+			}
+
+			case ProfileLogEntry::TaskSplit: {
+				writer.addSlice(worker, "split " + toString(task), "scheduler", time, time);
+				writer.addFlow('s', worker, time, task.getLeftChild());
+				writer.addFlow('s', worker, time, task.getRightChild());
+				break;
+			}
+
+			case ProfileLogEntry::TaskStolen: {
+				writer.addSlice(worker, "steal " + toString(task), "scheduler", time, time);
+				if (task.getDepth() > 0) writer.addFlow('t', worker, time, task);
+				break;
+			}
+
+			case ProfileLogEntry::WorkerSuspended: {
+				state.suspended = true;
+				state.suspendTime = time;
+				break;
+			}
+
+			case ProfileLogEntry::WorkerResumed: {
+				if (!state.suspended) break;
+				writer.addSlice(worker, "idle", "worker", state.suspendTime, time);
+				state.suspended = false;
+				break;
+			}
+
+			case ProfileLogEntry::EntriesDropped: {
+				writer.addSlice(worker, "lost " + std::to_string(entry.getNumDropped()) + " events", "profiler", time, time);
+				break;
+			}
+
+			default: break;
+			}
+		}
+
+		/**
+		 * Closes the slices of unfinished tasks and suspended workers at the last time stamp of the
+		 * corresponding worker.
+		 */
+		void finish() {
+			for(auto& cur : workers) {
+				finish(cur.first, cur.second);
+			}
+		}
+
+		/**
+		 * Closes the unfinished slices of the given worker, e.g. since it terminated.
+		 */
+		void finish(int worker) {
+			auto pos = workers.find(worker);
+			if (pos != workers.end()) finish(worker, pos->second);
+		}
+
+	private:
+
+		void finish(int worker, WorkerState& state) {
+			for(auto it = state.tasks.rbegin(); it != state.tasks.rend(); ++it) {
+				writer.addSlice(worker, toString(it->first), "task", it->second, state.lastTime);
+			}
+			state.tasks.clear();
+			if (state.suspended) {
+				writer.addSlice(worker, "idle", "worker", state.suspendTime, state.lastTime);
+				state.suspended = false;
+			}
+		}
+
+		static std::string toString(const TaskID& task) {
+			std::stringstream res;
+			res << task;
+			return res.str();
+		}
+
+	};
+
+	/**
+	 * Merges the logs of the given workers, indexed by their ID, into a single trace. Time stamps
+	 * are expected in nanoseconds, as in logs loaded from files.
+	 */
+	inline void exportTrace(const std::vector<ProfileLog>& logs, std::ostream& out) {
+
+		// shift time stamps such that the trace starts at 0
+		uint64_t base = std::numeric_limits<uint64_t>::max();
+		for(const auto& log : logs) {
+			if (log.begin() != log.end()) base = std::min(base, (*log.begin()).getTimestamp());
+		}
+
+		TraceEventWriter writer(out);
+		TraceConverter converter(writer, base);
+		for(std::size_t i=0; i<logs.size(); ++i) {
+			for(const auto& entry : logs[i]) {
+				converter.process(int(i), entry);
+			}
+		}
+		converter.finish();
+		writer.close();
+	}
+
+	// -- bounded profiling --
+
+	/**
+	 * The modes of recording profile logs, selected through the environment variable PROFILE_MODE.
+	 */
+	enum class ProfilingMode {
+		Full,       // < all events are retained in memory and saved when the worker terminates
+		Stream,     // < events are buffered in bounded memory and periodically appended to the log file
+		Recent      // < like Stream, yet the log files only retain about the events of the last PROFILE_KEEP_SECONDS seconds
+	};
+
+	inline std::ostream& operator<<(std::ostream& out, const ProfilingMode& mode) {
+		switch(mode) {
+			case ProfilingMode::Full:   return out << "full";
+			case ProfilingMode::Stream: return out << "stream";
+			case ProfilingMode::Recent: return out << "recent";
+		}
+		return out << "invalid";
+	}
+
+	/**
+	 * Parses the name of a profiling mode. Unknown names result in the given default.
+	 */
+	inline ProfilingMode parseProfilingMode(const std::string& name, ProfilingMode def = ProfilingMode::Full) {
+		if (name == "full") return ProfilingMode::Full;
+		if (name == "stream") return ProfilingMode::Stream;
+		if (name == "recent") return ProfilingMode::Recent;
+		return def;
+	}
+
+	/**
+	 * A bounded buffer of profile log entries, filled by a single worker and drained by a single
+	 * flusher, concurrently and without locks. Entries not fitting into the buffer are dropped
+	 * and counted, such that the consumer may report the loss.
+	 */
+	class ProfileRingBuffer {
+
+		std::vector<ProfileLogEntry> entries;
+
+		std::size_t mask;
+
+		// avoid false sharing between producer and consumer
+		char padding_head[64];
+
+		// the position of the next entry to be written, only updated by the producer
+		std::atomic<std::size_t> head;
+
+		// the number of entries dropped since the buffer was full
+		std::atomic<std::uint64_t> dropped;
+
+		char padding_tail[64];
+
+		// the position of the next entry to be read, only updated by the consumer
+		std::atomic<std::size_t> tail;
+
+	public:
+
+		/**
+		 * Creates a buffer for the given number of entries, rounded up to the next power of 2.
+		 */
+		explicit ProfileRingBuffer(std::size_t capacity) : head(0), dropped(0), tail(0) {
+			std::size_t size = 1;
+			while(size < capacity) size <<= 1;
+			entries.resize(size);
+			mask = size - 1;
+		}
+
+		ProfileRingBuffer(const ProfileRingBuffer&) = delete;
+		ProfileRingBuffer& operator=(const ProfileRingBuffer&) = delete;
+
+		/**
+		 * Adds an entry, to be called by the producer only. Returns false if the entry got dropped.
+		 */
+		bool push(const ProfileLogEntry& entry) {
+			auto h = head.load(std::memory_order_relaxed);
+			if (h - tail.load(std::memory_order_acquire) > mask) {
+				dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+				return false;
+			}
+			entries[h & mask] = entry;
+			head.store(h + 1, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * Passes all buffered entries to the given operation and removes them, to be called by
+		 * the consumer only. Returns the number of processed entries.
+		 */
+		template<typename Op>
+		std::size_t drain(const Op& op) {
+			auto t = tail.load(std::memory_order_relaxed);
+			auto h = head.load(std::memory_order_acquire);
+			for(auto i = t; i != h; ++i) {
+				op(entries[i & mask]);
+			}
+			tail.store(h, std::memory_order_release);
+			return h - t;
+		}
+
+		std::size_t size() const {
+			return head.load(std::memory_order_relaxed) - tail.load(std::memory_order_relaxed);
+		}
+
+		std::size_t getCapacity() const {
+			return entries.size();
+		}
+
+		std::uint64_t getNumDropped() const {
+			return dropped.load(std::memory_order_relaxed);
+		}
+
+	};
+
+	/**
+	 * A log file receiving the entries of a worker in chunks, which are appended to the file. In the
+	 * Recent mode, the file is a segment rotated whenever it covers the given period of time. The
+	 * previous segment is retained next to it, such that the two of them cover at least this period
+	 * before the latest entry, while every chunk is only written once. Use ProfileLog::loadRecentFrom
+	 * to load both segments.
+	 */
+	class ChunkedProfileLogFile {
+
+		std::string file;
+
+		ProfilingMode mode;
+
+		// the period to be covered in the Recent mode, in nanoseconds
+		uint64_t keepTime;
+
+		// the stream of the current segment, being the entire log in the Stream mode
+		std::ofstream out;
+
+		// the time stamps of the first and the last entry of the current segment
+		uint64_t first;
+		uint64_t last;
+
+		// the number of chunks in the current and the previous segment
+		std::size_t numChunks;
+		std::size_t numPreviousChunks;
+
+	public:
+
+		ChunkedProfileLogFile(const std::string& file, ProfilingMode mode, uint64_t keepTime = 0)
+			: file(file), mode(mode), keepTime(keepTime), first(0), last(0), numChunks(0), numPreviousChunks(0) {
+			assert_ne(ProfilingMode::Full, mode);
+			if (mode == ProfilingMode::Recent) {
+				// remove the segment of a previous run
+				std::remove(detail::getPreviousSegmentFileName(file).c_str());
+			}
+			open();
+		}
+
+		/**
+		 * Adds a chunk of entries, which is written before returning.
+		 */
+		void write(const std::vector<ProfileLogEntry>& entries) {
+			if (entries.empty()) return;
+
+			// start a new segment once the current one covers the requested period
+			if (mode == ProfilingMode::Recent && numChunks > 0 && last >= first + keepTime) {
+				rotate();
+			}
+
+			if (numChunks == 0) first = entries.front().getTimestamp();
+			last = entries.back().getTimestamp();
+			numChunks++;
+
+			detail::writeChunk(out, entries.size(), detail::encodeChunk(entries));
+			out.flush();
+		}
+
+		/**
+		 * Obtains the number of retained chunks.
+		 */
+		std::size_t getNumChunks() const {
+			return numChunks + numPreviousChunks;
+		}
+
+	private:
+
+		void open() {
+			out.open(file.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+			out.write(detail::CHUNKED_LOG_MAGIC, sizeof(detail::CHUNKED_LOG_MAGIC));
+			out.flush();
+		}
+
+		void rotate() {
+			out.close();
+
+			// the current segment becomes the previous one, the target is removed since rename does not replace files everywhere
+			auto previous = detail::getPreviousSegmentFileName(file);
+			std::remove(previous.c_str());
+			if (std::rename(file.c_str(), previous.c_str()) == 0) {
+				numPreviousChunks = numChunks;
+			} else {
+				std::cerr << "Warning: unable to rename profile log " << file << " to " << previous << ", dropping " << numChunks << " chunks\n";
+				numPreviousChunks = 0;
+			}
+			numChunks = 0;
+
+			open();
+		}
+
+	};
+
 	namespace detail {
 
+		/**
+		 * The profiling configuration obtained from environment variables.
+		 */
+		struct ProfilingConfig {
+
+			ProfilingMode mode = ProfilingMode::Full;
+
+			// the capacity of the per-worker buffers in the bounded modes
+			std::size_t bufferSize = 1 << 16;
+
+			// the interval between flushes of the buffers, in milliseconds
+			unsigned flushInterval = 100;
+
+			// the period retained in the Recent mode, in seconds
+			unsigned keepSeconds = 10;
+
+			ProfilingConfig() {
+				if (char* val = std::getenv("PROFILE_MODE")) mode = parseProfilingMode(val);
+				if (char* val = std::getenv("PROFILE_BUFFER_SIZE")) bufferSize = std::max(std::atoi(val), 1);
+				if (char* val = std::getenv("PROFILE_FLUSH_INTERVAL")) flushInterval = std::max(std::atoi(val), 1);
+				if (char* val = std::getenv("PROFILE_KEEP_SECONDS")) keepSeconds = std::max(std::atoi(val), 1);
+			}
+
+		};
+
+		inline const ProfilingConfig& getProfilingConfig() {
+			static const ProfilingConfig config;
+			return config;
+		}
+
+		/**
+		 * The trace written while the application is running if the environment variable
+		 * PROFILE_TRACE names a target file. In the bounded modes, the events of workers are
+		 * added whenever their buffers are flushed, such that the trace covers the run up to
+		 * the latest flush. In the Full mode, workers add their events when terminating.
+		 */
+		class OnlineTrace {
+
+			std::mutex lock;
+
+			std::ofstream out;
+
+			TraceEventWriter writer;
+
+			// the converter shared by all workers, tracking the unfinished slices between additions
+			TraceConverter converter;
+
+		public:
+
+			OnlineTrace(const std::string& file)
+				: out(file.c_str()), writer(out), converter(writer, TscClock::toNanoseconds(TscClock::now())) {}
+
+			/**
+			 * Adds the given events of the given worker, with time stamps in nanoseconds. Events
+			 * of a worker have to be added in the order they have been logged.
+			 */
+			template<typename Entries>
+			void add(int worker, const Entries& entries) {
+				std::lock_guard<std::mutex> guard(lock);
+				for(const auto& entry : entries) {
+					converter.process(worker, entry);
+				}
+				out.flush();
+			}
+
+			/**
+			 * Closes the unfinished slices of the given worker, to be called when it terminates.
+			 */
+			void finish(int worker) {
+				std::lock_guard<std::mutex> guard(lock);
+				converter.finish(worker);
+				out.flush();
+			}
+
+		};
+
+		/**
+		 * Obtains the online trace, or null if disabled. The first call fixes the begin of the trace.
+		 */
+		inline OnlineTrace* getOnlineTrace() {
+			// never destroyed, since workers may terminate during the destruction of static objects
+			static OnlineTrace* trace = (std::getenv("PROFILE_TRACE")) ? new OnlineTrace(std::getenv("PROFILE_TRACE")) : nullptr;
+			return trace;
+		}
+
+		/**
+		 * The bounded log of a worker, consisting of a buffer and the file it is flushed to. Flushed
+		 * entries are also added to the given online trace, if there is any.
+		 */
+		struct BoundedProfileLog {
+
+			ProfileRingBuffer buffer;
+
+			ChunkedProfileLogFile file;
+
+			OnlineTrace* trace;
+
+			int worker;
+
+			// the number of dropped entries already reported in the log
+			std::uint64_t reportedDrops;
+
+			BoundedProfileLog(std::size_t capacity, const std::string& file, ProfilingMode mode, uint64_t keepTime, OnlineTrace* trace = nullptr, int worker = 0)
+				: buffer(capacity), file(file, mode, keepTime), trace(trace), worker(worker), reportedDrops(0) {}
+
+			void flush() {
+				std::vector<ProfileLogEntry> entries;
+				entries.reserve(buffer.size() + 1);
+				buffer.drain([&](const ProfileLogEntry& entry) { entries.push_back(entry.toNanoseconds()); });
+
+				// entries got dropped after the drained ones, since the buffer was full
+				auto dropped = buffer.getNumDropped();
+				if (dropped != reportedDrops) {
+					entries.push_back(ProfileLogEntry::createEntriesDroppedEntry(dropped - reportedDrops).toNanoseconds());
+					reportedDrops = dropped;
+				}
+
+				file.write(entries);
+				if (trace && !entries.empty()) trace->add(worker, entries);
+			}
+
+		};
+
+		/**
+		 * A background thread periodically flushing the buffers of all registered bounded logs.
+		 */
+		class ProfileLogFlusher {
+
+			std::mutex lock;
+
+			std::vector<BoundedProfileLog*> logs;
+
+			ProfileLogFlusher(unsigned interval) {
+				// the thread is never stopped, since workers may terminate during the destruction of static objects
+				std::thread([this,interval]() {
+					while(true) {
+						std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+						flushAll();
+					}
+				}).detach();
+			}
+
+		public:
+
+			static ProfileLogFlusher& getInstance() {
+				// never destroyed, like its thread
+				static ProfileLogFlusher* instance = new ProfileLogFlusher(getProfilingConfig().flushInterval);
+				return *instance;
+			}
+
+			void add(BoundedProfileLog& log) {
+				std::lock_guard<std::mutex> guard(lock);
+				logs.push_back(&log);
+			}
+
+			/**
+			 * Removes the given log after flushing it a last time.
+			 */
+			void remove(BoundedProfileLog& log) {
+				std::lock_guard<std::mutex> guard(lock);
+				log.flush();
+				logs.erase(std::remove(logs.begin(), logs.end(), &log), logs.end());
+			}
+
+			void flushAll() {
+				std::lock_guard<std::mutex> guard(lock);
+				for(auto cur : logs) {
+					cur->flush();
+				}
+			}
+
+		};
+
 		struct ProfileLogHandler {
+
+			// the log of the Full mode
 			ProfileLog log;
 
+			// the log of the bounded modes
+			std::unique_ptr<BoundedProfileLog> bounded;
+
+			ProfileLogHandler() {
+				// calibrate the clock and start the online trace before the first event gets logged
+				TscClock::calibrate();
+				getOnlineTrace();
+
+				// set up a bounded log if requested
+				const auto& config = getProfilingConfig();
+				if (config.mode == ProfilingMode::Full) return;
+				bounded = std::make_unique<BoundedProfileLog>(
+					config.bufferSize, getLogFileNameForWorker(getCurrentWorkerID()),
+					config.mode, uint64_t(config.keepSeconds) * 1000 * 1000 * 1000,
+					getOnlineTrace(), getCurrentWorkerID()
+				);
+				ProfileLogFlusher::getInstance().add(*bounded);
+			}
+
 			~ProfileLogHandler() {
-				// save log to the chosen filename
-				log.saveTo(getLogFileNameForWorker(getCurrentWorkerID()));
+				auto file = getLogFileNameForWorker(getCurrentWorkerID());
+
+				if (bounded) {
+					// write remaining entries, which also adds them to the online trace
+					ProfileLogFlusher::getInstance().remove(*bounded);
+
+					// point out incomplete logs
+					if (auto dropped = bounded->buffer.getNumDropped()) {
+						std::cerr << "Warning: profile log " << file << " is missing " << dropped << " events, consider increasing PROFILE_BUFFER_SIZE\n";
+					}
+				} else {
+					// save log to the chosen filename
+					log.saveTo(file);
+
+					// contribute to the online trace
+					if (auto trace = getOnlineTrace()) trace->add(getCurrentWorkerID(), ProfileLog::loadFrom(file));
+				}
+
+				// close the slices left open by this worker
+				if (auto trace = getOnlineTrace()) trace->finish(getCurrentWorkerID());
+			}
+
+			void add(const ProfileLogEntry& entry) {
+				if (bounded) {
+					bounded->buffer.push(entry);
+				} else {
+					log << entry;
+				}
 			}
 		};
 
-		inline ProfileLog& getProfileLog() {
+		inline ProfileLogHandler& getProfileLogHandler() {
 			static thread_local ProfileLogHandler logHandler;
-			return logHandler.log;
+			return logHandler;
 		}
 
 		inline void logProfilerEventInternal(const ProfileLogEntry& entry) {
-			getProfileLog() << entry;
+			getProfileLogHandler().add(entry);
 		}
 
 	}
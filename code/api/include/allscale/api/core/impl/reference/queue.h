@@ -1,11 +1,17 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <ostream>
+#include <type_traits>
+#include <vector>
 
+#include "allscale/utils/assert.h"
 #include "allscale/utils/printer/arrays.h"
 #include "allscale/api/core/impl/reference/lock.h"
 
@@ -171,6 +177,15 @@ namespace reference {
 			++num_entries;
 		}
 
+		/**
+		 * Appends the given elements, in order, while acquiring the lock only once.
+		 */
+		void push_back(const T* ts, std::size_t n) {
+			guard g(lock);
+			data.insert(data.end(), ts, ts + n);
+			num_entries += n;
+		}
+
 	private:
 
 		T pop_front_internal() {
@@ -373,6 +388,393 @@ namespace reference {
 	};
 
 
+	namespace detail {
+
+		/**
+		 * The keys recorded next to the elements of a work stealing queue. Keys are stored
+		 * word-wise in atomics, such that they can be read while the owner is overwriting
+		 * them -- a torn key is only read if the corresponding element can not be claimed.
+		 */
+		template<typename Key>
+		class WorkStealingQueueKeys {
+
+			static_assert(std::is_trivially_copyable<Key>::value, "Keys of a work stealing queue must be trivially copyable!");
+
+			using word_t = std::uint64_t;
+
+			static constexpr std::size_t words = (sizeof(Key) + sizeof(word_t) - 1) / sizeof(word_t);
+
+			std::unique_ptr<std::atomic<word_t>[]> data;
+
+		public:
+
+			WorkStealingQueueKeys(std::size_t capacity)
+				: data(new std::atomic<word_t>[capacity * words]) {}
+
+			Key get(std::size_t slot) const {
+				word_t buffer[words];
+				for(std::size_t i=0; i<words; ++i) {
+					buffer[i] = data[slot * words + i].load(std::memory_order_relaxed);
+				}
+				Key res;
+				std::memcpy(&res,buffer,sizeof(Key));
+				return res;
+			}
+
+			void put(std::size_t slot, const Key& key) {
+				word_t buffer[words] = {};
+				std::memcpy(buffer,&key,sizeof(Key));
+				for(std::size_t i=0; i<words; ++i) {
+					data[slot * words + i].store(buffer[i], std::memory_order_relaxed);
+				}
+			}
+
+		};
+
+		/**
+		 * The key-less version, for queues without a key extractor.
+		 */
+		template<>
+		class WorkStealingQueueKeys<void> {
+		public:
+			WorkStealingQueueKeys(std::size_t) {}
+		};
+
+		template<typename T, typename KeyOf>
+		struct work_stealing_queue_key {
+			using type = decltype(std::declval<const KeyOf&>()(std::declval<const T&>()));
+		};
+
+		template<typename T>
+		struct work_stealing_queue_key<T,void> {
+			using type = void;
+		};
+
+	} // end namespace detail
+
+
+	/**
+	 * A growable, lock-free work-stealing deque following the design of Chase and Lev
+	 * (with the memory orderings proposed by Le et al. for weak memory models).
+	 *
+	 * The front end (bottom) of the queue is exclusively accessed by a single owner
+	 * thread, which may push and pop elements. Any other thread may only steal
+	 * elements from the back end (top) of the queue.
+	 *
+	 * If a key extractor KeyOf is given, the key of each element is recorded when it is
+	 * pushed. Elements may then be removed conditionally based on their key, without
+	 * accessing elements that have not been claimed (and may thus be in use by others).
+	 */
+	template<typename T, typename KeyOf = void>
+	class WorkStealingQueue {
+
+		static_assert(std::is_trivially_copyable<T>::value, "Elements of a work stealing queue must be trivially copyable!");
+
+		using index_t = std::int64_t;
+
+	public:
+
+		using key_type = typename detail::work_stealing_queue_key<T,KeyOf>::type;
+
+	private:
+
+		/**
+		 * A fixed-size circular buffer storing the elements of the queue.
+		 */
+		class Buffer {
+
+			index_t capacity;
+
+			index_t mask;
+
+			std::unique_ptr<std::atomic<T>[]> data;
+
+			// the keys of the stored elements, if there are any
+			detail::WorkStealingQueueKeys<key_type> keys;
+
+		public:
+
+			Buffer(index_t capacity)
+				: capacity(capacity), mask(capacity-1), data(new std::atomic<T>[capacity]), keys((std::size_t)capacity) {
+				// the capacity needs to be a power of 2
+				assert_eq(0,(capacity & mask)) << "Capacity " << capacity << " is not a power of 2";
+			}
+
+			index_t size() const {
+				return capacity;
+			}
+
+			T get(index_t i) const {
+				return data[i & mask].load(std::memory_order_relaxed);
+			}
+
+			template<typename K = key_type>
+			K getKey(index_t i) const {
+				return keys.get((std::size_t)(i & mask));
+			}
+
+			void put(index_t i, const T& value) {
+				data[i & mask].store(value, std::memory_order_relaxed);
+				putKey<KeyOf>(i,value);
+			}
+
+			Buffer* grow(index_t front, index_t back) const {
+				auto res = new Buffer(capacity * 2);
+				for(index_t i = back; i != front; ++i) {
+					res->data[i & res->mask].store(get(i), std::memory_order_relaxed);
+					copyKey<KeyOf>(*res,i);
+				}
+				return res;
+			}
+
+		private:
+
+			template<typename K>
+			typename std::enable_if<!std::is_void<K>::value>::type putKey(index_t i, const T& value) {
+				keys.put((std::size_t)(i & mask), K()(value));
+			}
+
+			template<typename K>
+			typename std::enable_if<std::is_void<K>::value>::type putKey(index_t, const T&) {}
+
+			template<typename K>
+			typename std::enable_if<!std::is_void<K>::value>::type copyKey(Buffer& trg, index_t i) const {
+				trg.keys.put((std::size_t)(i & trg.mask), getKey(i));
+			}
+
+			template<typename K>
+			typename std::enable_if<std::is_void<K>::value>::type copyKey(Buffer&, index_t) const {}
+
+		};
+
+		// the index of the next free slot at the owner's end (bottom)
+		std::atomic<index_t> front;
+
+		// keep the owner's and the thieves' index on different cache lines
+		char padding[64 - sizeof(std::atomic<index_t>)];
+
+		// the index of the oldest element, where thieves are stealing from (top)
+		std::atomic<index_t> back;
+
+		// the currently active buffer
+		std::atomic<Buffer*> buffer;
+
+		// retired buffers, kept alive since thieves might still be reading them
+		std::vector<std::unique_ptr<Buffer>> buffers;
+
+	public:
+
+		WorkStealingQueue(std::size_t initialCapacity = 64)
+			: front(0), back(0), buffer(nullptr) {
+			buffers.emplace_back(new Buffer((index_t)initialCapacity));
+			buffer = buffers.back().get();
+		}
+
+		WorkStealingQueue(const WorkStealingQueue&) = delete;
+		WorkStealingQueue(WorkStealingQueue&&) = delete;
+
+		WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+		WorkStealingQueue& operator=(WorkStealingQueue&&) = delete;
+
+		/**
+		 * Adds an element to the front of this queue. May only be called by the owner.
+		 */
+		void push_front(const T& t) {
+			index_t f = front.load(std::memory_order_relaxed);
+			index_t b = back.load(std::memory_order_acquire);
+			Buffer* buf = buffer.load(std::memory_order_relaxed);
+
+			// grow the buffer if necessary
+			if (f - b > buf->size() - 1) {
+				buffers.emplace_back(buf->grow(f,b));
+				buf = buffers.back().get();
+				buffer.store(buf, std::memory_order_release);
+			}
+
+			// insert the element and publish it
+			buf->put(f,t);
+			std::atomic_thread_fence(std::memory_order_release);
+			front.store(f + 1, std::memory_order_relaxed);
+		}
+
+		/**
+		 * Adds the given elements to the front of this queue, as if pushed one after another,
+		 * but publishes all of them at once. May only be called by the owner.
+		 */
+		void push_front(const T* ts, std::size_t n) {
+			index_t f = front.load(std::memory_order_relaxed);
+			index_t b = back.load(std::memory_order_acquire);
+			Buffer* buf = buffer.load(std::memory_order_relaxed);
+
+			// grow the buffer until all elements fit
+			while (f - b + (index_t)n > buf->size()) {
+				buffers.emplace_back(buf->grow(f,b));
+				buf = buffers.back().get();
+				buffer.store(buf, std::memory_order_release);
+			}
+
+			// insert the elements and publish them
+			for(std::size_t i=0; i<n; ++i) {
+				buf->put(f + (index_t)i, ts[i]);
+			}
+			std::atomic_thread_fence(std::memory_order_release);
+			front.store(f + (index_t)n, std::memory_order_relaxed);
+		}
+
+		/**
+		 * Removes the most recently added element from the front of this queue. May only
+		 * be called by the owner.
+		 *
+		 * @return the removed element or a default constructed T if the queue is empty
+		 */
+		T pop_front() {
+			index_t f = front.load(std::memory_order_relaxed) - 1;
+			Buffer* buf = buffer.load(std::memory_order_relaxed);
+			front.store(f, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			index_t b = back.load(std::memory_order_relaxed);
+
+			// check whether the queue was empty
+			if (b > f) {
+				front.store(f + 1, std::memory_order_relaxed);
+				return T();
+			}
+
+			// retrieve the element
+			T res = buf->get(f);
+			if (b != f) return res;
+
+			// this is the last element => compete with thieves
+			if (!back.compare_exchange_strong(b, b + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				res = T();
+			}
+			front.store(f + 1, std::memory_order_relaxed);
+			return res;
+		}
+
+		/**
+		 * Removes the most recently added element from the front of this queue if its key
+		 * satisfies the given predicate. May only be called by the owner. Only the key recorded
+		 * when pushing the element is inspected, never the element itself, since it may be
+		 * stolen concurrently.
+		 *
+		 * @return the removed element or a default constructed T if the queue is empty, the
+		 * 		predicate is not satisfied, or the element got stolen
+		 */
+		template<typename Predicate>
+		T pop_front_if(const Predicate& pred) {
+			static_assert(!std::is_void<key_type>::value, "Conditional removal requires a key extractor!");
+			index_t f = front.load(std::memory_order_relaxed);
+			index_t b = back.load(std::memory_order_acquire);
+			if (b >= f) return T();
+
+			// only the owner may replace the front element, thus it is popped if not stolen
+			if (!pred(buffer.load(std::memory_order_relaxed)->getKey(f - 1))) return T();
+			return pop_front();
+		}
+
+		template<bool tryOnlyOnce>
+		T pop_back_internal() {
+			// manual tail-recursion optimization since
+			// debug builds may fail to do so
+			while(true) {
+
+				index_t b = back.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				index_t f = front.load(std::memory_order_acquire);
+
+				// check whether there is anything to steal
+				if (b >= f) return T();
+
+				// read the element and try to claim it
+				T res = buffer.load(std::memory_order_acquire)->get(b);
+				if (back.compare_exchange_strong(b, b + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+					return res;
+				}
+
+				// if claiming failed, restart procedure if requested
+				if (tryOnlyOnce) return T();
+			}
+		}
+
+	public:
+
+		/**
+		 * Steals the oldest element of this queue, retrying on contention. May be called by any thread.
+		 *
+		 * @return the stolen element or a default constructed T if the queue is empty
+		 */
+		T pop_back() {
+			return pop_back_internal<false>();
+		}
+
+		/**
+		 * Attempts to steal the oldest element of this queue. May be called by any thread.
+		 *
+		 * @return the stolen element or a default constructed T if the queue is empty or
+		 *      a concurrent operation interfered
+		 */
+		T try_pop_back() {
+			return pop_back_internal<true>();
+		}
+
+		/**
+		 * Attempts to steal the oldest element of this queue if its key satisfies the given predicate.
+		 * May be called by any thread. Only the key recorded when pushing the element is inspected,
+		 * never the element itself, since it may be claimed by others while being inspected. A key
+		 * read while being overwritten is only observed if the element can not be claimed anymore.
+		 *
+		 * @return the stolen element or a default constructed T if the queue is empty, the
+		 * 		predicate is not satisfied, or a concurrent operation interfered
+		 */
+		template<typename Predicate>
+		T try_pop_back_if(const Predicate& pred) {
+			static_assert(!std::is_void<key_type>::value, "Conditional removal requires a key extractor!");
+			index_t b = back.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			index_t f = front.load(std::memory_order_acquire);
+
+			// check whether there is anything to steal
+			if (b >= f) return T();
+
+			// inspect the key of the element and try to claim it
+			Buffer* buf = buffer.load(std::memory_order_acquire);
+			if (!pred(buf->getKey(b))) return T();
+			T res = buf->get(b);
+			if (back.compare_exchange_strong(b, b + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				return res;
+			}
+			return T();
+		}
+
+		bool empty() const {
+			return size() == 0;
+		}
+
+		size_t size() const {
+			index_t b = back.load(std::memory_order_relaxed);
+			index_t f = front.load(std::memory_order_relaxed);
+			return (f > b) ? (size_t)(f - b) : 0;
+		}
+
+		/**
+		 * Obtains a (potentially inconsistent) snapshot of the queue's content
+		 * for debugging purposes, ordered from the back to the front.
+		 */
+		std::vector<T> getSnapshot() const {
+			std::vector<T> res;
+			index_t b = back.load(std::memory_order_acquire);
+			index_t f = front.load(std::memory_order_acquire);
+			Buffer* buf = buffer.load(std::memory_order_acquire);
+			for(index_t i = b; i < f; ++i) {
+				res.push_back(buf->get(i));
+			}
+			return res;
+		}
+
+	};
+
+
 } // end namespace reference
 } // end namespace impl
 } // end namespace core
@@ -1,31 +1,24 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <cmath>
+#include <fstream>
 #include <thread>
 #include <chrono>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <ostream>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <vector>
 
-#if defined _MSC_VER
-#include <intrin.h>
-#elif defined (__ppc64__) || defined (_ARCH_PPC64) || defined(__powerpc__) || defined(__ppc__)
-static __inline__ unsigned long long __rdtsc(void)
-{
-  int64_t tb;
-  asm("mfspr %0, 268" : "=r"(tb));
-  return tb;
-}
-#elif defined(__aarch64__)
-static __inline__ unsigned long long __rdtsc(void)
-{
-	struct timeval tv;
-	gettimeofday(&tv, nullptr);
-	return static_cast<int64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
-}
-#else
-#include <x86intrin.h>
-#endif
+#include "allscale/api/core/impl/reference/clock.h"
 
 namespace allscale {
 namespace api {
@@ -99,7 +92,7 @@ namespace reference {
 	}
 
 	/**
-	 * A cycle clock for the time prediction.
+	 * A cycle clock for the time prediction, sharing its time base with the profiler.
 	 */
 	struct CycleClock {
 
@@ -107,7 +100,8 @@ namespace reference {
 		using duration = CycleCount;
 
 		static time_point now() {
-			return __rdtsc();
+			// ordered, since used for measuring the execution time of tasks
+			return TscClock::nowOrdered();
 		}
 
 	};
@@ -115,7 +109,8 @@ namespace reference {
 
 	/**
 	 * A utility to estimate the execution time of tasks on different
-	 * levels of task-decomposition steps.
+	 * levels of task-decomposition steps. Predictors may be updated
+	 * and queried by multiple threads concurrently.
 	 */
 	class RuntimePredictor {
 
@@ -129,67 +124,105 @@ namespace reference {
 
 	private:
 
-		/**
-		 * The number of samples recorded per task level.
-		 */
-		std::array<std::size_t,MAX_LEVELS> samples;
+		using time_t = unsigned long long;
+
+		// the number of levels a prediction is extrapolated to if there are no samples for a level
+		enum { EXTRAPOLATION_RANGE = 4 };
 
 		/**
-		 * The current estimates of execution times of tasks.
+		 * The estimate of a single level. Levels are updated independently, such that workers
+		 * completing tasks on different levels do not compete for the same cache line.
 		 */
-		std::array<duration,MAX_LEVELS> times;
+		struct Level {
+
+			// the number of samples recorded for this level
+			std::atomic<std::size_t> samples;
+
+			// the current estimate of the execution time of tasks on this level
+			std::atomic<time_t> time;
+
+			char padding[64 - sizeof(std::atomic<std::size_t>) - sizeof(std::atomic<time_t>)];
+
+		};
+
+		std::array<Level,MAX_LEVELS> levels;
 
 	public:
 
 		RuntimePredictor(unsigned numWorkers = std::thread::hardware_concurrency()) {
-			// reset number of collected samples
-			samples.fill(0);
-
-			// initialize time estimates
-			times.fill(duration::zero());
+			// reset number of collected samples and time estimates
+			for(auto& cur : levels) {
+				cur.samples = 0;
+				cur.time = 0;
+			}
 
 			// initialize execution times up to a given level
 			for(int i=0; i<std::log2(numWorkers) + 4; ++i) {
-				times[i] = duration::max();
+				levels[i].time = duration::max().count();
 			}
 		}
 
+		RuntimePredictor(const RuntimePredictor&) = delete;
+		RuntimePredictor& operator=(const RuntimePredictor&) = delete;
+
 		/**
-		 * Obtain a prediction of a given level.
+		 * Obtain a prediction of a given level. Levels without samples are extrapolated from
+		 * the closest level with samples, assuming that the time halves with each level.
 		 */
 		duration predictTime(std::size_t level) const {
 			if (level >= MAX_LEVELS) return duration::zero();
-			return times[level];
-		}
 
-		/**
-		 * Update the predictions for a level.
-		 */
-		void registerTime(std::size_t level, const duration& time) {
-
-			// update matching level
-			updateTime(level,time);
+			// use the estimate of the level itself if there is any
+			if (getNumSamples(level) > 0) return getTime(level);
 
-			// update higher levels (with reduced weight)
-			auto smallerTime = time / 2;
-			auto largerTime = time * 2;
-			for(std::size_t d = 1; d < 5; d++) {
-
-				// update higher element
-				if (d <= level) {
-					updateTime(level-d,largerTime);
+			// otherwise, extrapolate from the closest level with samples
+			for(std::size_t d = 1; d <= EXTRAPOLATION_RANGE; d++) {
+				if (d <= level && getNumSamples(level-d) > 0) {
+					return getTime(level-d) / (1ul << d);
 				}
-
-				// update smaller element
-				if (level+d < MAX_LEVELS) {
-					updateTime(level+d,smallerTime);
+				if (level+d < MAX_LEVELS && getNumSamples(level+d) > 0) {
+					return getTime(level+d) * (1ul << d);
 				}
-
-				// update parameters
-				smallerTime = smallerTime / 2;
-				largerTime = largerTime * 2;
 			}
 
+			// fall back to the initial estimate
+			return getTime(level);
+		}
+
+		/**
+		 * Obtain the number of samples the prediction of a given level is based on.
+		 */
+		std::size_t getNumSamples(std::size_t level) const {
+			if (level >= MAX_LEVELS) return 0;
+			return levels[level].samples.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * Update the prediction for a level. Only the given level is updated, the
+		 * predictions of neighboring levels are derived from it when being queried.
+		 */
+		void registerTime(std::size_t level, const duration& time) {
+			if (level >= MAX_LEVELS) return;
+			Level& cur = levels[level];
+
+			// obtain the number of samples the current estimate is based on
+			long unsigned N = (long unsigned)cur.samples.fetch_add(1, std::memory_order_relaxed);
+
+			// update estimate of time of a task on this level, without locks
+			time_t old = cur.time.load(std::memory_order_relaxed);
+			time_t next;
+			do {
+				next = ((N * duration(old) + time) / (N+1)).count();
+			} while(!cur.time.compare_exchange_weak(old, next, std::memory_order_relaxed));
+		}
+
+		/**
+		 * Replaces the prediction of a level, e.g. by one recorded in a previous run.
+		 */
+		void setTime(std::size_t level, const duration& time, std::size_t numSamples) {
+			if (level >= MAX_LEVELS) return;
+			levels[level].time.store(time.count(), std::memory_order_relaxed);
+			levels[level].samples.store(numSamples, std::memory_order_relaxed);
 		}
 
 		/**
@@ -198,7 +231,7 @@ namespace reference {
 		friend std::ostream& operator<<(std::ostream& out, const RuntimePredictor& pred) {
 			out << "Predictions:\n";
 			for(int i = 0; i<MAX_LEVELS; i++) {
-				auto us = pred.times[i].count();
+				auto us = pred.predictTime(i).count();
 				out << "\t" << i << ": " << us << "\n";
 				if (us == 0) return out;
 			}
@@ -207,29 +240,175 @@ namespace reference {
 
 	private:
 
-		void updateTime(std::size_t level, const duration& time) {
-
-			// update estimate of time of a task on this level
-			long unsigned N = (long unsigned)samples[level];
-			times[level] = (N * times[level] + time) / (N+1);
-
-			// update sample count
-			++samples[level];
+		duration getTime(std::size_t level) const {
+			return levels[level].time.load(std::memory_order_relaxed);
 		}
 
 	};
 
 
+	namespace detail {
+
+		/**
+		 * The registry of the runtime predictors of all task types. Predictors are keyed by the
+		 * address of a tag unique to each task type, since the names of types with internal
+		 * linkage may coincide among translation units. Names are only utilized for persisting
+		 * predictions, and thus only match between runs of the same binary.
+		 */
+		class RuntimePredictorRegistry {
+
+			struct Entry {
+				std::string name;
+				std::unique_ptr<RuntimePredictor> predictor;
+			};
+
+			struct LoadedLevel {
+				std::size_t level;
+				RuntimePredictor::duration time;
+				std::size_t samples;
+			};
+
+			std::mutex lock;
+
+			// the predictors of all task types encountered so far, keyed by their tag
+			std::map<const void*,Entry> predictors;
+
+			// the predictions loaded from a previous run, keyed by the name of the task type
+			std::map<std::string,std::vector<LoadedLevel>> loaded;
+
+		public:
+
+			// the maximum number of samples a loaded prediction is considered to be based on,
+			// such that predictions may still adapt to the current run
+			enum { MAX_LOADED_SAMPLES = 16 };
+
+			static RuntimePredictorRegistry& getInstance() {
+				// never destroyed, since workers may still utilize predictors during the destruction of static objects
+				static RuntimePredictorRegistry* instance = new RuntimePredictorRegistry();
+				return *instance;
+			}
+
+			/**
+			 * Obtains the predictor of the task type identified by the given tag, starting from
+			 * the predictions loaded for the given name, if any.
+			 */
+			RuntimePredictor& get(const void* tag, const std::string& name) {
+				std::lock_guard<std::mutex> guard(lock);
+				auto& res = predictors[tag];
+				if (!res.predictor) {
+					res.name = name;
+					res.predictor = std::make_unique<RuntimePredictor>();
+					auto pos = loaded.find(name);
+					if (pos != loaded.end()) apply(*res.predictor, pos->second);
+				}
+				return *res.predictor;
+			}
+
+			/**
+			 * Writes all predictions to the given stream, one line per task type. Times are
+			 * stored in nanoseconds, such that they may be transferred between systems. The
+			 * type name is terminated by a tab, since names may contain spaces (e.g. on MSVC).
+			 * Types sharing their name with another type are skipped, since their predictions
+			 * could not be told apart when being loaded.
+			 */
+			void save(std::ostream& out) {
+				std::lock_guard<std::mutex> guard(lock);
+				std::map<std::string,unsigned> numTypes;
+				for(const auto& cur : predictors) {
+					numTypes[cur.second.name]++;
+				}
+				for(const auto& cur : predictors) {
+					if (numTypes[cur.second.name] > 1) continue;
+					const auto& predictor = *cur.second.predictor;
+					out << cur.second.name << '\t';
+					for(std::size_t i=0; i<RuntimePredictor::MAX_LEVELS; i++) {
+						auto samples = predictor.getNumSamples(i);
+						if (samples == 0) continue;
+						out << i << ":" << TscClock::toDuration(predictor.predictTime(i).count()).count() << ":" << samples << " ";
+					}
+					out << "\n";
+				}
+			}
+
+			/**
+			 * Loads the predictions stored by save. Returns false if the stream is malformed.
+			 */
+			bool load(std::istream& in) {
+				std::string line;
+				while(std::getline(in, line)) {
+					if (line.empty()) continue;
+					std::stringstream entries(line);
+					std::string key;
+					if (!std::getline(entries, key, '\t') || entries.eof()) return false;
+
+					std::vector<LoadedLevel> levels;
+					std::size_t level;
+					unsigned long long ns;
+					std::size_t samples;
+					char sep1, sep2;
+					while(entries >> level >> sep1 >> ns >> sep2 >> samples) {
+						if (sep1 != ':' || sep2 != ':') return false;
+						auto ticks = (unsigned long long)(double(ns) * TscClock::getTicksPerNanosecond());
+						levels.push_back({ level, ticks, std::min<std::size_t>(samples, MAX_LOADED_SAMPLES) });
+					}
+					if (!entries.eof()) return false;
+
+					// record the predictions for task types encountered later on, and update present ones
+					std::lock_guard<std::mutex> guard(lock);
+					for(auto& cur : predictors) {
+						if (cur.second.name == key) apply(*cur.second.predictor, levels);
+					}
+					loaded[key] = std::move(levels);
+				}
+				return true;
+			}
+
+		private:
+
+			static void apply(RuntimePredictor& predictor, const std::vector<LoadedLevel>& levels) {
+				for(const auto& cur : levels) {
+					predictor.setTime(cur.level, cur.time, cur.samples);
+				}
+			}
+
+		};
+
+	} // end namespace detail
+
+
 	/**
 	 * A global singleton dispatcher associating to each task type
-	 * a thread local runtime predictor.
+	 * a runtime predictor shared among all threads.
 	 */
 	template<typename TaskType>
 	inline RuntimePredictor& getRuntimePredictor() {
-		static thread_local RuntimePredictor predictor = RuntimePredictor();
+		// the address of this tag is unique for each task type, even for types with internal linkage
+		static const char tag = 0;
+		static RuntimePredictor& predictor = detail::RuntimePredictorRegistry::getInstance().get(&tag, typeid(TaskType).name());
 		return predictor;
 	}
 
+	/**
+	 * Saves the predictions of all task types to the given file, such that subsequent runs of
+	 * the same binary may start from those. Since task types are identified by their names,
+	 * and the names of e.g. closure types change whenever the program is modified, files
+	 * should not be utilized with other binaries. Returns false if the file could not be written.
+	 */
+	inline bool saveRuntimePredictors(const std::string& file) {
+		std::ofstream out(file.c_str());
+		detail::RuntimePredictorRegistry::getInstance().save(out);
+		return bool(out);
+	}
+
+	/**
+	 * Loads the predictions saved by a previous run. Returns false if the file could not be read.
+	 */
+	inline bool loadRuntimePredictors(const std::string& file) {
+		std::ifstream in(file.c_str());
+		if (!in) return false;
+		return detail::RuntimePredictorRegistry::getInstance().load(in);
+	}
+
 
 } // end namespace reference
 } // end namespace impl
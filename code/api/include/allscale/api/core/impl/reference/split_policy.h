@@ -0,0 +1,279 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include "allscale/api/core/impl/reference/runtime_predictor.h"
+
+namespace allscale {
+namespace api {
+namespace core {
+namespace impl {
+namespace reference {
+
+	/**
+	 * The information available to a split policy when deciding whether a task should be split.
+	 */
+	struct SplitContext {
+
+		// the depth of the task within its task family
+		std::size_t depth;
+
+		// the predictor for the execution time of the task, may be null
+		const RuntimePredictor* predictor;
+
+		// the number of tasks in the queue of the deciding worker
+		std::size_t queueLength;
+
+		// whether the task has just been stolen from another worker
+		bool stolen;
+
+		// the number of workers currently looking for work
+		std::size_t numIdleWorkers;
+
+		// the total number of workers
+		std::size_t numWorkers;
+
+		/**
+		 * Obtains the estimated execution time of the task if processed sequentially.
+		 */
+		CycleCount estimateRuntime() const {
+			return (predictor) ? predictor->predictTime(depth) : CycleCount::max();
+		}
+
+	};
+
+	/**
+	 * The interface of policies deciding on the splitting of splitable tasks.
+	 * Policies are shared among all workers, thus decisions must be thread safe.
+	 */
+	class SplitPolicy {
+
+	public:
+
+		virtual ~SplitPolicy() {}
+
+		/**
+		 * Determines whether a task should be split in the given context.
+		 */
+		virtual bool shouldSplit(const SplitContext& context) const = 0;
+
+		/**
+		 * Obtains a short name for this policy.
+		 */
+		virtual std::string getName() const = 0;
+
+		friend std::ostream& operator<<(std::ostream& out, const SplitPolicy& policy) {
+			return out << policy.getName();
+		}
+
+	};
+
+
+	/**
+	 * Splits tasks estimated to exceed a fixed execution time, as long as the queue
+	 * of the deciding worker is not sufficiently filled. Stolen tasks are split whenever
+	 * they exceed the threshold.
+	 */
+	class FixedThresholdSplitPolicy : public SplitPolicy {
+
+		CycleCount threshold;
+
+		std::size_t maxQueueLength;
+
+	public:
+
+		FixedThresholdSplitPolicy(CycleCount threshold = 3*1000*1000, std::size_t maxQueueLength = 6)
+			: threshold(threshold), maxQueueLength(maxQueueLength) {}
+
+		bool shouldSplit(const SplitContext& context) const override {
+			if (!context.stolen && context.queueLength >= maxQueueLength) return false;
+			return context.depth == 0 || context.estimateRuntime() > threshold;
+		}
+
+		std::string getName() const override {
+			return "fixed";
+		}
+
+	};
+
+
+	/**
+	 * Lazy binary splitting: tasks are only split if there is demand for parallelism,
+	 * thus if the local queue is (almost) empty or other workers are looking for work.
+	 * Execution time estimates are not considered.
+	 */
+	class LazySplitPolicy : public SplitPolicy {
+
+		std::size_t minQueueLength;
+
+		std::size_t maxQueueLength;
+
+	public:
+
+		LazySplitPolicy(std::size_t minQueueLength = 1, std::size_t maxQueueLength = 6)
+			: minQueueLength(minQueueLength), maxQueueLength(maxQueueLength) {}
+
+		bool shouldSplit(const SplitContext& context) const override {
+			// stolen tasks are split to quickly create local work
+			if (context.stolen || context.depth == 0) return true;
+			// split if the local queue may not satisfy local demand
+			if (context.queueLength < minQueueLength) return true;
+			// or if there are thieves, as long as the queue is not full
+			return context.numIdleWorkers > 0 && context.queueLength < maxQueueLength;
+		}
+
+		std::string getName() const override {
+			return "lazy";
+		}
+
+	};
+
+
+	/**
+	 * A threshold based policy adapting its threshold to the observed idle time: as
+	 * long as workers are found idle, the threshold is lowered to create more parallelism,
+	 * otherwise it is raised to reduce the task management overhead. Workers collect their
+	 * observations locally and only apply them to the shared threshold periodically, such
+	 * that the threshold is read-mostly on the path of split decisions.
+	 */
+	class AdaptiveSplitPolicy : public SplitPolicy {
+
+		using time_t = unsigned long long;
+
+		mutable std::atomic<time_t> threshold;
+
+		time_t minThreshold;
+
+		time_t maxThreshold;
+
+		std::size_t maxQueueLength;
+
+		// the observations of a worker not yet applied to the threshold
+		struct Observations {
+			const AdaptiveSplitPolicy* policy;
+			unsigned idle;
+			unsigned total;
+		};
+
+	public:
+
+		// the number of decisions of a worker after which its observations are applied
+		enum { ADAPTATION_PERIOD = 64 };
+
+		AdaptiveSplitPolicy(CycleCount minThreshold = 10*1000, CycleCount maxThreshold = 100*1000*1000, std::size_t maxQueueLength = 6)
+			: threshold(3*1000*1000), minThreshold(minThreshold.count()), maxThreshold(maxThreshold.count()), maxQueueLength(maxQueueLength) {
+			threshold = std::min(std::max(threshold.load(), this->minThreshold), this->maxThreshold);
+		}
+
+		bool shouldSplit(const SplitContext& context) const override {
+			time_t cur = threshold.load(std::memory_order_relaxed);
+
+			// record the observation, observations for other policies are discarded
+			Observations& local = getLocalObservations();
+			if (local.policy != this) local = { this, 0, 0 };
+			if (context.numIdleWorkers > 0) local.idle++;
+			if (++local.total == ADAPTATION_PERIOD) {
+				adapt(cur, local.idle, local.total - local.idle);
+				local.idle = 0;
+				local.total = 0;
+			}
+
+			// decide like the fixed threshold policy
+			if (!context.stolen && context.queueLength >= maxQueueLength) return false;
+			return context.depth == 0 || context.estimateRuntime() > CycleCount(cur);
+		}
+
+		CycleCount getThreshold() const {
+			return threshold.load(std::memory_order_relaxed);
+		}
+
+		std::string getName() const override {
+			return "adaptive";
+		}
+
+	private:
+
+		static Observations& getLocalObservations() {
+			static thread_local Observations observations = { nullptr, 0, 0 };
+			return observations;
+		}
+
+		void adapt(time_t cur, unsigned idle, unsigned busy) const {
+			time_t next = cur;
+			for(unsigned i=0; i<idle; i++) {
+				next = std::max(next - next / 8, minThreshold);
+			}
+			for(unsigned i=0; i<busy; i++) {
+				next = std::min(next + next / 64 + 1, maxThreshold);
+			}
+			// only publish changes (lost updates are tolerated)
+			if (next != cur) threshold.store(next, std::memory_order_relaxed);
+		}
+
+	};
+
+
+	/**
+	 * Obtains the shared instance of a built-in split policy by its name (fixed, lazy,
+	 * or adaptive). Unknown names result in a null pointer.
+	 */
+	inline const SplitPolicy* getSplitPolicy(const std::string& name) {
+		static const FixedThresholdSplitPolicy fixed;
+		static const LazySplitPolicy lazy;
+		static const AdaptiveSplitPolicy adaptive;
+		if (name == "fixed") return &fixed;
+		if (name == "lazy") return &lazy;
+		if (name == "adaptive") return &adaptive;
+		return nullptr;
+	}
+
+
+	namespace detail {
+
+		inline const SplitPolicy*& getCurrentSplitPolicyRef() {
+			static thread_local const SplitPolicy* policy = nullptr;
+			return policy;
+		}
+
+	}
+
+	/**
+	 * Obtains the split policy to be assigned to tasks created by the current thread,
+	 * null if the runtime wide policy should be utilized.
+	 */
+	inline const SplitPolicy* getCurrentSplitPolicy() {
+		return detail::getCurrentSplitPolicyRef();
+	}
+
+	/**
+	 * A scope within which created tasks are assigned the given split policy. A null
+	 * policy retains the policy of the enclosing scope.
+	 */
+	class SplitPolicyScope {
+
+		const SplitPolicy* old;
+
+	public:
+
+		SplitPolicyScope(const SplitPolicy* policy) : old(getCurrentSplitPolicy()) {
+			if (policy) detail::getCurrentSplitPolicyRef() = policy;
+		}
+
+		SplitPolicyScope(const SplitPolicyScope&) = delete;
+		SplitPolicyScope& operator=(const SplitPolicyScope&) = delete;
+
+		~SplitPolicyScope() {
+			detail::getCurrentSplitPolicyRef() = old;
+		}
+
+	};
+
+} // end namespace reference
+} // end namespace impl
+} // end namespace core
+} // end namespace api
+} // end namespace allscale
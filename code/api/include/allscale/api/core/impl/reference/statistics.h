@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace allscale {
+namespace api {
+namespace core {
+namespace impl {
+namespace reference {
+
+	/**
+	 * A snapshot of the statistics of a single worker.
+	 */
+	struct WorkerStatistics {
+
+		using duration = std::chrono::nanoseconds;
+
+		// the number of tasks processed by the worker
+		std::uint64_t tasksExecuted = 0;
+
+		// the number of tasks split by the worker
+		std::uint64_t tasksSplit = 0;
+
+		// the number of tasks successfully stolen from other workers
+		std::uint64_t stealsSucceeded = 0;
+
+		// the number of attempts to steal from another worker without success
+		std::uint64_t stealsFailed = 0;
+
+		// the number of times the worker got parked
+		std::uint64_t numParked = 0;
+
+		// the time spent looking for work, including the time being parked
+		duration idleTime = duration::zero();
+
+		// the time spent being parked
+		duration parkedTime = duration::zero();
+
+		// the maximum length of the worker's queue observed
+		std::uint64_t queueHighWaterMark = 0;
+
+		WorkerStatistics& operator+=(const WorkerStatistics& other) {
+			tasksExecuted += other.tasksExecuted;
+			tasksSplit += other.tasksSplit;
+			stealsSucceeded += other.stealsSucceeded;
+			stealsFailed += other.stealsFailed;
+			numParked += other.numParked;
+			idleTime += other.idleTime;
+			parkedTime += other.parkedTime;
+			queueHighWaterMark = std::max(queueHighWaterMark, other.queueHighWaterMark);
+			return *this;
+		}
+
+		friend std::ostream& operator<<(std::ostream& out, const WorkerStatistics& stats) {
+			return out
+				<< "executed: " << stats.tasksExecuted
+				<< ", split: " << stats.tasksSplit
+				<< ", steals: " << stats.stealsSucceeded << "/" << (stats.stealsSucceeded + stats.stealsFailed)
+				<< ", idle: " << std::chrono::duration_cast<std::chrono::microseconds>(stats.idleTime).count() << "us"
+				<< ", parked: " << stats.numParked << "x " << std::chrono::duration_cast<std::chrono::microseconds>(stats.parkedTime).count() << "us"
+				<< ", queue high-water mark: " << stats.queueHighWaterMark;
+		}
+
+	};
+
+	/**
+	 * A snapshot of the statistics of all workers of a runtime.
+	 */
+	struct RuntimeStatistics {
+
+		// the statistics of the individual workers, indexed by the worker id
+		std::vector<WorkerStatistics> workers;
+
+		/**
+		 * Obtains the accumulated statistics of all workers. The queue high-water
+		 * mark is the maximum among all workers.
+		 */
+		WorkerStatistics getTotal() const {
+			WorkerStatistics res;
+			for(const auto& cur : workers) {
+				res += cur;
+			}
+			return res;
+		}
+
+		friend std::ostream& operator<<(std::ostream& out, const RuntimeStatistics& stats) {
+			for(std::size_t i=0; i<stats.workers.size(); ++i) {
+				out << "Worker " << i << ": " << stats.workers[i] << "\n";
+			}
+			return out << "Total: " << stats.getTotal() << "\n";
+		}
+
+	};
+
+	namespace detail {
+
+		/**
+		 * A counter updated by a single thread only, readable by any thread. Updates
+		 * are plain loads and stores, thus concurrent updates by multiple threads may
+		 * get lost, rendering values approximations.
+		 */
+		class StatisticsCounter {
+
+			std::atomic<std::uint64_t> value;
+
+		public:
+
+			StatisticsCounter() : value(0) {}
+
+			void add(std::uint64_t delta = 1) {
+				value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+			}
+
+			void updateMax(std::uint64_t candidate) {
+				if (candidate > value.load(std::memory_order_relaxed)) {
+					value.store(candidate, std::memory_order_relaxed);
+				}
+			}
+
+			std::uint64_t get() const {
+				return value.load(std::memory_order_relaxed);
+			}
+
+		};
+
+		/**
+		 * The counters maintained by each worker, padded to occupy their own cache lines.
+		 */
+		struct WorkerStatisticsCounters {
+
+			// avoid false sharing with preceding fields
+			char padding_front[64];
+
+			StatisticsCounter tasksExecuted;
+			StatisticsCounter tasksSplit;
+			StatisticsCounter stealsSucceeded;
+			StatisticsCounter stealsFailed;
+			StatisticsCounter numParked;
+			StatisticsCounter idleTime;          // < in nanoseconds
+			StatisticsCounter parkedTime;        // < in nanoseconds
+			StatisticsCounter queueHighWaterMark;
+
+			// avoid false sharing with subsequent fields
+			char padding_back[64];
+
+			WorkerStatistics getSnapshot() const {
+				WorkerStatistics res;
+				res.tasksExecuted = tasksExecuted.get();
+				res.tasksSplit = tasksSplit.get();
+				res.stealsSucceeded = stealsSucceeded.get();
+				res.stealsFailed = stealsFailed.get();
+				res.numParked = numParked.get();
+				res.idleTime = WorkerStatistics::duration(idleTime.get());
+				res.parkedTime = WorkerStatistics::duration(parkedTime.get());
+				res.queueHighWaterMark = queueHighWaterMark.get();
+				return res;
+			}
+
+		};
+
+	} // end namespace detail
+
+} // end namespace reference
+} // end namespace impl
+} // end namespace core
+} // end namespace api
+} // end namespace allscale
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <ostream>
 #include <iterator>
@@ -115,7 +116,7 @@ namespace reference {
 		};
 
 
-		class path_iterator : public std::iterator<std::forward_iterator_tag,Direction> {
+		class path_iterator {
 
 			path_t path;
 			length_t pos;
@@ -126,6 +127,12 @@ namespace reference {
 
 		public:
 
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = Direction;
+			using difference_type = std::ptrdiff_t;
+			using pointer = Direction*;
+			using reference = Direction&;
+
 			static path_iterator begin(path_t path, length_t length) {
 				if (length == 0) return end(path);
 				return path_iterator( path, length, Direction((path >> (length-1)) % 2) );
@@ -0,0 +1,364 @@
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#ifdef __linux__
+	#include <sched.h>
+#endif
+
+namespace allscale {
+namespace api {
+namespace core {
+namespace impl {
+namespace reference {
+
+	/**
+	 * The policies supported for placing workers on CPUs.
+	 */
+	enum class PlacementPolicy {
+		Compact,        // < fill SMT siblings, L3 domains and nodes one after another
+		Scatter,        // < spread workers over nodes and L3 domains as widely as possible
+		OnePerCore      // < occupy one SMT thread per core before utilizing siblings
+	};
+
+	inline std::ostream& operator<<(std::ostream& out, const PlacementPolicy& policy) {
+		switch(policy) {
+			case PlacementPolicy::Compact:    return out << "compact";
+			case PlacementPolicy::Scatter:    return out << "scatter";
+			case PlacementPolicy::OnePerCore: return out << "one-per-core";
+		}
+		return out << "invalid";
+	}
+
+	/**
+	 * Parses the name of a placement policy. Unknown names result in the given default.
+	 */
+	inline PlacementPolicy parsePlacementPolicy(const std::string& name, PlacementPolicy def = PlacementPolicy::OnePerCore) {
+		if (name == "compact") return PlacementPolicy::Compact;
+		if (name == "scatter") return PlacementPolicy::Scatter;
+		if (name == "one-per-core") return PlacementPolicy::OnePerCore;
+		return def;
+	}
+
+	/**
+	 * The location of a CPU (hardware thread) within the system.
+	 */
+	struct CpuInfo {
+		int id;         // < the OS index of this CPU
+		int core;       // < the id of the core, unique within a package
+		int package;    // < the id of the socket
+		int l3;         // < the id of the L3 domain, unique within the system
+		int node;       // < the id of the NUMA node
+	};
+
+	namespace detail {
+
+		/**
+		 * Parses a list of CPUs in the format used by sysfs, e.g. "0-3,8,10-11".
+		 */
+		inline std::vector<int> parseCpuList(const std::string& list) {
+			std::vector<int> res;
+			std::size_t pos = 0;
+			while(pos < list.size()) {
+				auto end = list.find(',', pos);
+				if (end == std::string::npos) end = list.size();
+				auto item = list.substr(pos, end - pos);
+				auto dash = item.find('-');
+				try {
+					if (dash == std::string::npos) {
+						res.push_back(std::stoi(item));
+					} else {
+						int from = std::stoi(item.substr(0,dash));
+						int to = std::stoi(item.substr(dash+1));
+						for(int i=from; i<=to; i++) res.push_back(i);
+					}
+				} catch (const std::exception&) {
+					// ignore malformed entries
+				}
+				pos = end + 1;
+			}
+			return res;
+		}
+
+		inline bool readLine(const std::string& file, std::string& res) {
+			std::ifstream in(file);
+			if (!in) return false;
+			return bool(std::getline(in, res));
+		}
+
+		inline int readInt(const std::string& file, int def) {
+			std::string line;
+			if (!readLine(file, line)) return def;
+			try {
+				return std::stoi(line);
+			} catch (const std::exception&) {
+				return def;
+			}
+		}
+
+		/**
+		 * Groups the given CPUs by the given key, preserving the order of CPUs and groups.
+		 */
+		template<typename Key>
+		std::vector<std::vector<CpuInfo>> groupBy(const std::vector<CpuInfo>& cpus, const Key& key) {
+			std::vector<std::vector<CpuInfo>> res;
+			std::map<int,std::size_t> index;
+			for(const auto& cur : cpus) {
+				auto pos = index.find(key(cur));
+				if (pos == index.end()) {
+					pos = index.insert({ key(cur), res.size() }).first;
+					res.emplace_back();
+				}
+				res[pos->second].push_back(cur);
+			}
+			return res;
+		}
+
+		/**
+		 * Merges the given lists of CPUs by picking elements in a round-robin fashion.
+		 */
+		inline std::vector<CpuInfo> interleave(const std::vector<std::vector<CpuInfo>>& lists) {
+			std::vector<CpuInfo> res;
+			for(std::size_t i=0; ; i++) {
+				bool done = true;
+				for(const auto& cur : lists) {
+					if (i >= cur.size()) continue;
+					res.push_back(cur[i]);
+					done = false;
+				}
+				if (done) return res;
+			}
+		}
+
+	} // end namespace detail
+
+
+	/**
+	 * The topology of the CPUs available to this process.
+	 */
+	class Topology {
+
+		// the list of available CPUs
+		std::vector<CpuInfo> cpus;
+
+	public:
+
+		/**
+		 * The distance levels between CPUs.
+		 */
+		enum Distance {
+			SameCpu = 0,
+			SameCore = 1,
+			SameL3 = 2,
+			SameNode = 3,
+			Remote = 4
+		};
+
+		explicit Topology(const std::vector<CpuInfo>& cpus) : cpus(cpus) {
+			if (this->cpus.empty()) this->cpus = createFlat(1).cpus;
+		}
+
+		/**
+		 * Creates a topology of the given number of independent cores sharing a single L3 domain.
+		 */
+		static Topology createFlat(int numCpus) {
+			std::vector<CpuInfo> cpus;
+			for(int i=0; i<std::max(numCpus,1); i++) {
+				cpus.push_back({ i, i, 0, 0, 0 });
+			}
+			return Topology(cpus);
+		}
+
+		/**
+		 * Loads the topology from the given sysfs directory. If no information can be obtained,
+		 * a flat topology covering the hardware concurrency is returned.
+		 */
+		static Topology load(const std::string& root = "/sys/devices/system") {
+			using namespace detail;
+
+			std::string line;
+			if (!readLine(root + "/cpu/online", line)) return createFlat(std::thread::hardware_concurrency());
+
+			std::vector<CpuInfo> cpus;
+			for(int id : parseCpuList(line)) {
+				auto dir = root + "/cpu/cpu" + std::to_string(id);
+
+				CpuInfo info;
+				info.id = id;
+				info.core = readInt(dir + "/topology/core_id", id);
+				info.package = readInt(dir + "/topology/physical_package_id", 0);
+				info.node = 0;
+
+				// the L3 domain is identified by the lowest CPU sharing it, by default the package
+				info.l3 = -1 - info.package;
+				for(int i=0; ; i++) {
+					auto cache = dir + "/cache/index" + std::to_string(i);
+					int level = readInt(cache + "/level", -1);
+					if (level < 0) break;
+					if (level != 3) continue;
+					if (!readLine(cache + "/shared_cpu_list", line)) break;
+					auto shared = parseCpuList(line);
+					if (!shared.empty()) info.l3 = *std::min_element(shared.begin(), shared.end());
+					break;
+				}
+
+				cpus.push_back(info);
+			}
+
+			// assign NUMA nodes
+			if (readLine(root + "/node/online", line)) {
+				for(int node : parseCpuList(line)) {
+					if (!readLine(root + "/node/node" + std::to_string(node) + "/cpulist", line)) continue;
+					for(int id : parseCpuList(line)) {
+						for(auto& cur : cpus) {
+							if (cur.id == id) cur.node = node;
+						}
+					}
+				}
+			}
+
+			return Topology(cpus);
+		}
+
+		/**
+		 * Obtains the topology of the CPUs this process is allowed to run on.
+		 */
+		static Topology getSystemTopology() {
+			Topology res = load();
+			#ifdef __linux__
+				cpu_set_t mask;
+				CPU_ZERO(&mask);
+				if (sched_getaffinity(0, sizeof(cpu_set_t), &mask) == 0) {
+					std::vector<CpuInfo> allowed;
+					for(const auto& cur : res.cpus) {
+						if (cur.id < CPU_SETSIZE && CPU_ISSET(cur.id, &mask)) allowed.push_back(cur);
+					}
+					if (!allowed.empty()) res.cpus = allowed;
+				}
+			#endif
+			return res;
+		}
+
+		const std::vector<CpuInfo>& getCpus() const {
+			return cpus;
+		}
+
+		std::size_t getNumCpus() const {
+			return cpus.size();
+		}
+
+		const CpuInfo* getCpu(int id) const {
+			for(const auto& cur : cpus) {
+				if (cur.id == id) return &cur;
+			}
+			return nullptr;
+		}
+
+		static Distance getDistance(const CpuInfo& a, const CpuInfo& b) {
+			if (a.id == b.id) return SameCpu;
+			if (a.package == b.package && a.core == b.core) return SameCore;
+			if (a.l3 == b.l3) return SameL3;
+			if (a.node == b.node) return SameNode;
+			return Remote;
+		}
+
+		Distance getDistance(int a, int b) const {
+			auto x = getCpu(a);
+			auto y = getCpu(b);
+			if (!x || !y) return (a == b) ? SameCpu : Remote;
+			return getDistance(*x,*y);
+		}
+
+		/**
+		 * Obtains the CPUs to place the given number of workers on. If there are more
+		 * workers than CPUs, CPUs are assigned repeatedly.
+		 */
+		std::vector<int> getPlacement(PlacementPolicy policy, std::size_t numWorkers) const {
+			using namespace detail;
+
+			// list CPUs such that neighbors are close to each other
+			auto compact = cpus;
+			std::stable_sort(compact.begin(), compact.end(), [](const CpuInfo& a, const CpuInfo& b) {
+				return std::tie(a.node, a.package, a.l3, a.core, a.id) < std::tie(b.node, b.package, b.l3, b.core, b.id);
+			});
+
+			std::vector<CpuInfo> order;
+			if (policy == PlacementPolicy::Compact) {
+				order = compact;
+			} else {
+
+				// the first SMT threads of all cores, then the second, and so on
+				auto byCore = groupBy(compact, [&](const CpuInfo& c) { return c.package * (1<<16) + c.core; });
+				std::vector<std::vector<CpuInfo>> levels;
+				for(const auto& core : byCore) {
+					for(std::size_t i=0; i<core.size(); i++) {
+						if (levels.size() <= i) levels.emplace_back();
+						levels[i].push_back(core[i]);
+					}
+				}
+
+				for(const auto& level : levels) {
+					if (policy == PlacementPolicy::OnePerCore) {
+						order.insert(order.end(), level.begin(), level.end());
+						continue;
+					}
+
+					// alternate between nodes and, within those, between L3 domains
+					std::vector<std::vector<CpuInfo>> nodes;
+					for(const auto& node : groupBy(level, [](const CpuInfo& c) { return c.node; })) {
+						nodes.push_back(interleave(groupBy(node, [](const CpuInfo& c) { return c.l3; })));
+					}
+					auto cur = interleave(nodes);
+					order.insert(order.end(), cur.begin(), cur.end());
+				}
+			}
+
+			std::vector<int> res;
+			for(std::size_t i=0; i<numWorkers; i++) {
+				res.push_back(order[i % order.size()].id);
+			}
+			return res;
+		}
+
+		/**
+		 * Obtains the order in which the given worker should attempt to steal tasks from the
+		 * other workers, placed as given: SMT siblings first, followed by workers sharing the
+		 * same L3 domain, the same node, and finally remote workers. Within each level, workers
+		 * are ordered by their distance in the ring of workers.
+		 */
+		std::vector<std::size_t> getStealingOrder(const std::vector<int>& placement, std::size_t worker) const {
+			auto numWorkers = placement.size();
+
+			// start with the ring order
+			std::vector<std::size_t> res;
+			auto add = [&](std::size_t idx) {
+				if (idx == worker) return;
+				if (std::find(res.begin(), res.end(), idx) != res.end()) return;
+				res.push_back(idx);
+			};
+			for(std::size_t d=1; d<numWorkers; ++d) {
+				add((worker + d) % numWorkers);
+				add((worker - d + numWorkers) % numWorkers);
+			}
+
+			// order by topological distance
+			std::stable_sort(res.begin(), res.end(), [&](std::size_t a, std::size_t b) {
+				return getDistance(placement[worker], placement[a]) < getDistance(placement[worker], placement[b]);
+			});
+			return res;
+		}
+
+	};
+
+} // end namespace reference
+} // end namespace impl
+} // end namespace core
+} // end namespace api
+} // end namespace allscale
@@ -5,12 +5,19 @@
 #include <atomic>
 #include <bitset>
 #include <cassert>
-#include <condition_variable>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <random>
 #include <set>
+#include <string>
+#include <thread>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #ifdef __linux__
 	#include <pthread.h>
@@ -19,10 +26,16 @@
 #include "allscale/utils/assert.h"
 #include "allscale/utils/bitmanipulation.h"
 
+#include "allscale/api/core/impl/reference/allocator.h"
 #include "allscale/api/core/impl/reference/lock.h"
+#include "allscale/api/core/impl/reference/priority.h"
 #include "allscale/api/core/impl/reference/profiling.h"
 #include "allscale/api/core/impl/reference/queue.h"
 #include "allscale/api/core/impl/reference/runtime_predictor.h"
+#include "allscale/api/core/impl/reference/split_policy.h"
+#include "allscale/api/core/impl/reference/statistics.h"
+#include "allscale/api/core/impl/reference/topology.h"
+#include "allscale/api/core/impl/when_any_result.h"
 
 namespace allscale {
 namespace api {
@@ -282,34 +295,82 @@ namespace reference {
 	//								 	Task Dependency Manager
 	// ---------------------------------------------------------------------------------------------
 
+	/**
+	 * An entry in the list of tasks waiting for the completion of a task. Entries are
+	 * embedded in the waiting tasks, thus registering a dependency does usually not
+	 * require any memory allocation (see TaskBase::acquireDependencyEntry).
+	 */
+	struct DependencyEntry {
+		TaskBase* task;
+		DependencyEntry* next;
+	};
+
+	/**
+	 * A manager of the dependencies on the tasks of a task family. Tasks up to a dense depth,
+	 * selected at construction, are tracked in an array holding a cell for each possible task.
+	 * Deeper tasks, up to the given max_depth, are tracked in hash tables allocated on demand,
+	 * yet only while being split -- thus only tasks that actually exist consume space. Whenever
+	 * a table gets crowded, tasks are tracked in a larger one. Tasks not tracked are represented
+	 * by their closest tracked ancestor.
+	 */
 	template<std::size_t max_depth>
 	class TaskDependencyManager {
 
 		// dependencies are stored in a linked list
-		struct Entry {
-			TaskBase* task;
-			Entry* next;
+		using Entry = DependencyEntry;
+
+		// cells either point to the list of dependencies of a pending task, or, if the
+		// last bit is set, record the epoch in which the corresponding task got completed
+		using cell_type = std::atomic<std::uintptr_t>;
+
+		// an entry of the tables of deep tasks
+		struct Slot {
+			std::atomic<std::uint64_t> key;		// < the encoded path of the tracked task, 0 if free
+			cell_type cell;
 		};
 
-		using cell_type = std::atomic<Entry*>;
+		// the number of slots inspected for locating a deep task in a table
+		enum { max_probes = 16 };
 
-		enum { num_entries = 1<<(max_depth+1) };
+		// the maximum number of tables of deep tasks, each four times the size of its predecessor
+		enum { max_tables = 8 };
 
 		// an epoch counter to facilitate re-use
 		std::atomic<std::size_t> epoch;
 
+		// the depth up to which tasks are tracked by the dense array
+		std::size_t dense_depth;
+
 		// the container for storing task dependencies, pointer tagging is used to test for completeness
-		cell_type data[num_entries];
+		std::unique_ptr<cell_type[]> data;
+
+		// the tables of tracked deep tasks, allocated on demand once the previous one is crowded
+		std::atomic<Slot*> tables[max_tables];
+
+		// the number of tables deep tasks have been tracked in during the current epoch
+		std::atomic<std::size_t> tables_used;
 
 	public:
 
-		TaskDependencyManager(std::size_t epoch = 0) : epoch(epoch) {
-			for(auto& cur : data) cur = nullptr;
+		TaskDependencyManager(std::size_t epoch = 0, std::size_t dense_depth = 6)
+			: epoch(epoch), dense_depth(std::min(dense_depth, max_depth)),
+			  data(new cell_type[getNumCells()]), tables_used(0) {
+			// tasks completed in an earlier epoch are pending in the current one
+			for(std::size_t i=0; i<getNumCells(); i++) data[i] = completedIn(0);
+			for(auto& cur : tables) cur = nullptr;
 		}
 
 		~TaskDependencyManager() {
-			for(auto& cur : data) {
-				if (!isDone(cur)) delete cur;
+			for(std::size_t i=0; i<getNumCells(); i++) {
+				clear(data[i]);
+			}
+			for(std::size_t t=0; t<max_tables; t++) {
+				Slot* slots = tables[t].load();
+				if (!slots) continue;
+				for(std::size_t i=0; i<getNumSlots(t); i++) {
+					clear(slots[i].cell);
+				}
+				delete [] slots;
 			}
 		}
 
@@ -323,40 +384,140 @@ namespace reference {
 			return epoch.load();
 		}
 
+		std::size_t getDenseDepth() const {
+			return dense_depth;
+		}
+
+		/**
+		 * Starts a new epoch, resetting all tasks to be pending. Since cells record the epoch of
+		 * completion, no cell needs to be touched; only the first table of deep tasks is emptied
+		 * and retained, larger ones are released to not pin their memory while being re-used.
+		 */
 		void startEpoch(std::size_t newEpoch) {
-			// make sure there is a change
-			assert_ne(epoch.load(),newEpoch);
+			// make sure there is progress
+			assert_lt(epoch.load(),newEpoch);
 
-			// re-set state
-			epoch = newEpoch;
-			for(auto& cur : data) {
-				// there should not be any dependencies left
-				assert_true(cur == nullptr || isDone(cur));
+			// there should not be any dependencies left
+			for(std::size_t i=0; i<getNumCells(); i++) {
+				assert_true(isDone(data[i]));
+			}
 
-				// reset dependencies
-				cur = nullptr;
+			// forget about tracked deep tasks
+			std::size_t used = tables_used.exchange(0);
+			for(std::size_t t=0; t<used; t++) {
+				Slot* slots = tables[t].load();
+				for(std::size_t i=0; i<getNumSlots(t); i++) {
+					assert_true(isDone(slots[i].cell));
+					slots[i].key.store(0, std::memory_order_relaxed);
+				}
+			}
+
+			// release the larger tables, they are re-allocated on demand
+			for(std::size_t t=1; t<max_tables; t++) {
+				delete [] tables[t].exchange(nullptr);
 			}
+
+			// re-set state
+			epoch = newEpoch;
 		}
 
 
+		/**
+		 * Starts tracking the given task of the given epoch, if it is beyond the dense depth.
+		 * Should be called before the task may be split.
+		 */
+		void addTask(const TaskPath& task, std::size_t epoch);
+
 		/**
 		 * Adds a dependency between the given tasks such that
-		 * task x depends on the completion of the task y.
+		 * task x depends on the completion of the task y of the given epoch.
 		 */
-		void addDependency(TaskBase* x, const TaskPath& y);
+		void addDependency(TaskBase* x, const TaskPath& y, std::size_t epoch);
 
-		void markComplete(const TaskPath& task);
+		/**
+		 * Marks the given task of the given epoch as completed. Returns true if this
+		 * call completed the task, false if it had been completed before, is not
+		 * tracked, or the epoch is over.
+		 */
+		bool markComplete(const TaskPath& task, std::size_t epoch);
 
-		bool isComplete(const TaskPath& path) const {
-			return isDone(data[getPosition(path)]);
+		/**
+		 * Tests whether the given task of the given epoch is completed. All tasks
+		 * of past epochs are completed.
+		 */
+		bool isComplete(const TaskPath& path, std::size_t epoch) const {
+			if (isDoneIn(getCell(path).load(), epoch)) return true;
+			// the epoch is only over once all its tasks are completed
+			return this->epoch.load() != epoch;
 		}
 
 	private:
 
-		std::size_t getPosition(const TaskPath& path) const {
+		std::size_t getNumCells() const {
+			return std::size_t(2) << dense_depth;
+		}
+
+		std::size_t getNumSlots(std::size_t table) const {
+			// the first table may hold as many tasks as the dense array, at least 1024
+			return std::max(std::size_t(2) << dense_depth, std::size_t(1024)) << (2*table);
+		}
+
+		static std::uint64_t getKey(std::size_t length, std::uint64_t path) {
+			return (std::uint64_t(1) << length) | path;
+		}
+
+		/**
+		 * Locates the slot of the task with the given key in the given table, or claims
+		 * a free slot for it if requested. Returns null if there is no such slot, in which
+		 * case the crowded flag tells whether all inspected slots have been occupied.
+		 */
+		static Slot* findSlot(Slot* slots, std::size_t numSlots, std::uint64_t key, bool claim, bool& crowded) {
+			const std::size_t mask = numSlots - 1;
+			std::size_t pos = std::size_t((key * 0x9E3779B97F4A7C15ull) >> 32);
+			crowded = false;
+			for(std::size_t i=0; i<max_probes; i++) {
+				Slot& cur = slots[(pos + i) & mask];
+				auto curKey = cur.key.load(std::memory_order_acquire);
+				if (curKey == key) return &cur;
+				if (curKey != 0) continue;
+				// slots are filled in probing order, thus the key is not present
+				if (!claim) return nullptr;
+				if (cur.key.compare_exchange_strong(curKey, key, std::memory_order_acq_rel)) return &cur;
+				if (curKey == key) return &cur;
+			}
+			crowded = true;
+			return nullptr;
+		}
+
+		/**
+		 * Locates the slot of the task with the given key among the tables used in the
+		 * current epoch. Returns null if the task is not tracked.
+		 */
+		Slot* lookup(std::uint64_t key) const {
+			std::size_t used = tables_used.load(std::memory_order_acquire);
+			for(std::size_t t=0; t<used; t++) {
+				Slot* slots = tables[t].load(std::memory_order_acquire);
+				if (!slots) return nullptr;
+				bool crowded;
+				if (Slot* slot = findSlot(slots, getNumSlots(t), key, false, crowded)) return slot;
+				// tasks are only tracked in the next table if this one was crowded
+				if (!crowded) return nullptr;
+			}
+			return nullptr;
+		}
+
+		/**
+		 * Obtains the given table of deep tasks, allocating it if necessary.
+		 */
+		Slot* getTable(std::size_t t);
+
+		/**
+		 * Obtains the cell of the given task, or of its closest tracked ancestor.
+		 */
+		cell_type& getCell(const TaskPath& path) const {
 
 			// get length and path
-			auto l = path.getLength();
+			std::size_t l = path.getLength();
 			auto p = path.getPath();
 
 			// limit length to max_depth
@@ -365,15 +526,48 @@ namespace reference {
 				l = max_depth;				// effective depth
 			}
 
-			// compute result
-			return (decltype(p)(1) << l) | p;
+			// search for the closest tracked task among deep ancestors
+			if (l > dense_depth) {
+				if (tables_used.load() > 0) {
+					for(; l > dense_depth; l--, p >>= 1) {
+						if (Slot* slot = lookup(getKey(l,p))) return slot->cell;
+					}
+				} else {
+					p = p >> (l - dense_depth);
+					l = dense_depth;
+				}
+			}
+
+			// use the dense array
+			return data[getKey(l,p)];
+		}
+
+		static std::uintptr_t completedIn(std::size_t epoch) {
+			return (std::uintptr_t(epoch) << 1) | 0x1;
 		}
 
-		bool isDone(const Entry* ptr) const {
+		static bool isDone(std::uintptr_t cell) {
 			// if the last bit is set, the task already finished
-			return (intptr_t)(ptr) & 0x1;
+			return cell & 0x1;
+		}
+
+		static bool isDoneIn(std::uintptr_t cell, std::size_t epoch) {
+			// tasks completed in a later epoch have been completed in this epoch as well
+			return isDone(cell) && (cell >> 1) >= epoch;
+		}
+
+		static Entry* toEntry(std::uintptr_t cell) {
+			return reinterpret_cast<Entry*>(cell);
+		}
+
+		static std::uintptr_t toCell(Entry* entry) {
+			return reinterpret_cast<std::uintptr_t>(entry);
 		}
 
+		static void clear(cell_type& cell);
+
+		bool markComplete(cell_type& cell, std::size_t epoch);
+
 	};
 
 
@@ -383,6 +577,8 @@ namespace reference {
 	// ---------------------------------------------------------------------------------------------
 
 
+	class TaskFamilyManager;
+
 	/**
 	 * A task family is a collection of tasks descending from a common (single) ancestor.
 	 * Task families are created by root-level prec operator calls, and manage the dependencies
@@ -390,12 +586,19 @@ namespace reference {
 	 *
 	 * Tasks being created through recursive or combine calls are initially not members of
 	 * any family, but may get adapted (by being the result of a split operation).
+	 *
+	 * Families obtained from the family manager are re-used once their root task is completed.
+	 * Each use is an epoch of the family, identified by the family ID. Tasks and references
+	 * thus have to present the ID of the family they have been created for.
 	 */
 	class TaskFamily {
 
-		// TODO: make task dependency manager depth target system dependent
+		friend class TaskFamilyManager;
+
+		// tasks deeper than this are represented by their ancestor on this level
+		using DependencyManager = TaskDependencyManager<24>;
 
-		using DependencyManager = TaskDependencyManager<6>;
+		enum : std::uint32_t { unmanaged = ~std::uint32_t(0) };
 
 		// the manager of all dependencies on members of this family
 		DependencyManager dependencies;
@@ -404,15 +607,22 @@ namespace reference {
 		// (it is not created nested by a treeture but by the main thread)
 		bool top_level;
 
+		// the index of this family within the family manager, if managed
+		std::uint32_t index;
+
+		// the index of the next family in the free list of the family manager
+		std::atomic<std::uint32_t> next_free;
+
 	public:
 
 		/**
-		 * Creates a new family, using a new ID.
+		 * Creates a new family, using a new ID, tracking all tasks up to the given depth densely.
 		 */
-		TaskFamily(bool top_level = false) : dependencies(getNextID()), top_level(top_level) {}
+		TaskFamily(bool top_level = false, std::size_t dependency_depth = 6)
+			: dependencies(getNextID(),dependency_depth), top_level(top_level), index(unmanaged), next_free(unmanaged) {}
 
 		/**
-		 * Obtain the family ID.
+		 * Obtain the ID of the current epoch of this family.
 		 */
 		std::size_t getId() const {
 			return dependencies.getEpoch();
@@ -428,32 +638,55 @@ namespace reference {
 		/**
 		 * Tests whether the given sub-task is complete.
 		 */
-		bool isComplete(const TaskPath& path) const {
-			return dependencies.isComplete(path);
+		bool isComplete(const TaskPath& path, std::size_t id) const {
+			return dependencies.isComplete(path,id);
 		}
 
 		/**
-		 * Register a dependency ensuring that a task x is depending on a task y.
+		 * Obtains the depth up to which all tasks of this family are tracked densely.
+		 */
+		std::size_t getDependencyDepth() const {
+			return dependencies.getDenseDepth();
+		}
+
+		/**
+		 * Registers a new member of this family, before it may be split.
 		 */
-		void addDependency(TaskBase* x, const TaskPath& y) {
-			dependencies.addDependency(x,y);
+		void addMember(const TaskPath& x, std::size_t id) {
+			dependencies.addTask(x,id);
 		}
 
 		/**
-		 * Mark the given task as being finished.
+		 * Register a dependency ensuring that a task x is depending on a task y.
 		 */
-		void markDone(const TaskPath& x) {
-			dependencies.markComplete(x);
+		void addDependency(TaskBase* x, const TaskPath& y, std::size_t id) {
+			dependencies.addDependency(x,y,id);
 		}
 
+		/**
+		 * Mark the given task as being finished. Once the root task is finished,
+		 * this family is handed back to its manager for being re-used.
+		 */
+		void markDone(const TaskPath& x, std::size_t id);
+
 		/**
 		 * A family ID generator.
 		 */
-		static unsigned getNextID() {
-			static std::atomic<int> counter(0);
+		static std::size_t getNextID() {
+			static std::atomic<std::size_t> counter(0);
 			return ++counter;
 		}
 
+	private:
+
+		/**
+		 * Prepares this family for being re-used, starting a new epoch.
+		 */
+		void reset(bool top_level) {
+			dependencies.startEpoch(getNextID());
+			this->top_level = top_level;
+		}
+
 	};
 
 
@@ -461,40 +694,176 @@ namespace reference {
 	using TaskFamilyPtr = TaskFamily*;
 
 	/**
-	 * A manager keeping track of created families.
+	 * A manager keeping track of created families. Since references to tasks may outlive their
+	 * families, families are never destroyed but re-used once their root task is completed.
+	 * Families are allocated in chunks of growing size, and free families are kept in a
+	 * lock-free stack of family indices.
 	 */
 	class TaskFamilyManager {
 
-		SpinLock lock;
+		enum : std::uint32_t {
+			first_chunk_size = 64,
+			num_chunks = 26,		// < sufficient for 2^32 - 64 families
+			none = TaskFamily::unmanaged
+		};
+
+		// the chunks of families, the i-th chunk being of size first_chunk_size * 2^i
+		std::atomic<TaskFamily*> chunks[num_chunks];
+
+		// the number of families created so far
+		std::atomic<std::uint32_t> numFamilies;
+
+		// the top of the stack of free families in the lower 32 bits, a
+		// modification counter preventing ABA problems in the upper 32 bits
+		std::atomic<std::uint64_t> freeList;
+
+		// the dense dependency tracking depth of new families
+		std::atomic<std::size_t> dependencyDepth;
 
-		std::vector<std::unique_ptr<TaskFamily>> families;
+		// the maximum dense dependency tracking depth, bounding the dense array of each family
+		enum { max_dependency_depth = 16 };
 
 	public:
 
-		TaskFamilyPtr getFreshFamily(bool topLevel) {
-			std::lock_guard<SpinLock> lease(lock);
+		TaskFamilyManager()
+			: numFamilies(0), freeList(none),
+			  dependencyDepth(getDefaultDependencyDepth(std::thread::hardware_concurrency())) {
+			for(auto& cur : chunks) cur = nullptr;
+		}
 
-			// TODO: replace this by a re-use based solution
+		TaskFamilyManager(const TaskFamilyManager&) = delete;
+		TaskFamilyManager& operator=(const TaskFamilyManager&) = delete;
+
+		TaskFamilyPtr getFreshFamily(bool topLevel) {
 
-			// gradually drain old family references
-			/*
-			if (families.size() > 20000) {
-				families.erase(families.begin(),families.begin() + families.size()/2);
+			// re-use a free family, if available
+			auto top = freeList.load(std::memory_order_acquire);
+			while(getIndex(top) != none) {
+				TaskFamily& family = getFamily(getIndex(top));
+				auto next = pack(getCounter(top) + 1, family.next_free.load(std::memory_order_relaxed));
+				if (freeList.compare_exchange_weak(top, next, std::memory_order_acquire)) {
+					family.reset(topLevel);
+					return &family;
+				}
 			}
-			*/
 
 			// create a new family
-			families.push_back(std::make_unique<TaskFamily>(topLevel));
-			return families.back().get();
+			auto index = numFamilies++;
+			assert_lt(index, none) << "Too many task families!";
+			TaskFamily* res = new (getSlot(index)) TaskFamily(topLevel, dependencyDepth.load(std::memory_order_relaxed));
+			res->index = index;
+			return res;
+		}
+
+		/**
+		 * Hands back the given family for being re-used.
+		 */
+		void release(TaskFamily& family) {
+			assert_ne(family.index, none) << "Unable to release an unmanaged family!";
+			auto top = freeList.load(std::memory_order_relaxed);
+			do {
+				family.next_free.store(getIndex(top), std::memory_order_relaxed);
+			} while(!freeList.compare_exchange_weak(top, pack(getCounter(top) + 1, family.index), std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		/**
+		 * Obtains the number of families created so far, thus the number of families
+		 * having been in use simultaneously at some point.
+		 */
+		std::size_t getNumFamilies() const {
+			return numFamilies.load();
+		}
+
+		/**
+		 * Obtains the depth up to which newly created families track all tasks densely.
+		 */
+		std::size_t getDependencyDepth() const {
+			return dependencyDepth.load();
+		}
+
+		/**
+		 * Updates the dense dependency tracking depth of families created from now on, bounded
+		 * by max_dependency_depth. Re-used families retain the depth they have been created with.
+		 */
+		void setDependencyDepth(std::size_t depth) {
+			dependencyDepth = std::min<std::size_t>(depth, max_dependency_depth);
+		}
+
+		/**
+		 * Determines the dense dependency tracking depth for the given number of workers,
+		 * such that the deepest densely tracked level offers 16 tasks per worker.
+		 */
+		static std::size_t getDefaultDependencyDepth(std::size_t numWorkers) {
+			std::size_t depth = 4;
+			while((std::size_t(1) << (depth - 4)) < numWorkers) depth++;
+			return std::min<std::size_t>(std::max<std::size_t>(depth, 6), 12);
+		}
+
+		static TaskFamilyManager& getInstance() {
+			// families are never destroyed, since references may outlive any static object
+			static TaskFamilyManager* manager = new TaskFamilyManager();
+			return *manager;
+		}
+
+	private:
+
+		static std::uint64_t pack(std::uint64_t counter, std::uint32_t index) {
+			return (counter << 32) | index;
+		}
+
+		static std::uint32_t getIndex(std::uint64_t top) {
+			return std::uint32_t(top);
+		}
+
+		static std::uint64_t getCounter(std::uint64_t top) {
+			return top >> 32;
+		}
+
+		static void locate(std::uint32_t index, std::uint32_t& chunk, std::uint32_t& offset) {
+			// chunk i covers the indices [ first_chunk_size * (2^i - 1), first_chunk_size * (2^(i+1) - 1) )
+			std::uint32_t i = 0;
+			for(std::uint32_t j = index / first_chunk_size + 1; j > 1; j >>= 1) i++;
+			chunk = i;
+			offset = index - first_chunk_size * ((std::uint32_t(1) << i) - 1);
+		}
+
+		TaskFamily& getFamily(std::uint32_t index) {
+			std::uint32_t chunk, offset;
+			locate(index,chunk,offset);
+			return chunks[chunk].load(std::memory_order_acquire)[offset];
+		}
+
+		void* getSlot(std::uint32_t index) {
+			std::uint32_t chunk, offset;
+			locate(index,chunk,offset);
+
+			// allocate the chunk if necessary, racing with other threads
+			TaskFamily* cur = chunks[chunk].load(std::memory_order_acquire);
+			if (!cur) {
+				std::size_t size = std::size_t(first_chunk_size) << chunk;
+				auto fresh = static_cast<TaskFamily*>(::operator new(sizeof(TaskFamily) * size));
+				if (chunks[chunk].compare_exchange_strong(cur, fresh, std::memory_order_acq_rel)) {
+					cur = fresh;
+				} else {
+					::operator delete(fresh);
+				}
+			}
+			return cur + offset;
 		}
 
 	};
 
 
+	inline void TaskFamily::markDone(const TaskPath& x, std::size_t id) {
+		// the completion of the root completes all tasks
+		if (dependencies.markComplete(x,id) && x.isRoot() && index != unmanaged) {
+			TaskFamilyManager::getInstance().release(*this);
+		}
+	}
+
 	// a factory for a new task family
 	inline TaskFamilyPtr createFamily(bool topLevel = false) {
-		static TaskFamilyManager familyManager;
-		return familyManager.getFreshFamily(topLevel);
+		return TaskFamilyManager::getInstance().getFreshFamily(topLevel);
 	}
 
 
@@ -513,20 +882,23 @@ namespace reference {
 		// a weak reference to a task's family
 		TaskFamilyPtr family;
 
+		// the ID of the family at the time the task was a member
+		std::size_t familyId;
+
 		TaskPath path;
 
-		task_reference(const TaskFamilyPtr& family, const TaskPath& path)
-			: family(family), path(path) {}
+		task_reference(const TaskFamilyPtr& family, std::size_t familyId, const TaskPath& path)
+			: family(family), familyId(familyId), path(path) {}
 
 	public:
 
-		task_reference() : family(nullptr), path(TaskPath::root()) {}
+		task_reference() : family(nullptr), familyId(0), path(TaskPath::root()) {}
 
 		task_reference(const TaskBase& task);
 
 		task_reference(const task_reference&) = default;
 
-		task_reference(task_reference&& other) : family(other.family), path(other.path) {
+		task_reference(task_reference&& other) : family(other.family), familyId(other.familyId), path(other.path) {
 			other.family = nullptr;
 		}
 
@@ -534,13 +906,14 @@ namespace reference {
 
 		task_reference& operator=(task_reference&& other) {
 			family = other.family;
+			familyId = other.familyId;
 			path = other.path;
 			other.family = nullptr;
 			return *this;
 		}
 
 		bool isDone() const {
-			return (!family || family->isComplete(path));
+			return (!family || family->isComplete(path,familyId));
 		}
 
 		bool valid() const {
@@ -550,11 +923,11 @@ namespace reference {
 		void wait() const;
 
 		task_reference getLeft() const {
-			return task_reference ( family, path.getLeftChildPath() );
+			return task_reference ( family, familyId, path.getLeftChildPath() );
 		}
 
 		task_reference getRight() const {
-			return task_reference ( family, path.getRightChildPath() );
+			return task_reference ( family, familyId, path.getRightChildPath() );
 		}
 
 		task_reference& descentLeft() {
@@ -573,6 +946,10 @@ namespace reference {
 			return family;
 		}
 
+		std::size_t getFamilyId() const {
+			return familyId;
+		}
+
 		const TaskPath& getPath() const {
 			return path;
 		}
@@ -740,36 +1117,77 @@ namespace reference {
 
 
 	/**
-	 * A promise, forming the connection between a task and a treeture
-	 * waiting for the task's result.
+	 * The state shared by all promises: a marker for delivered values and the list of
+	 * tasks waiting for the delivery, utilized for attaching continuations to treetures.
 	 */
-	template<typename T>
-	class Promise {
+	class PromiseBase {
 
 		// a marker for delivered values
 		std::atomic<bool> ready;
 
-		// the delivered value
-		T value;
+		// the list of waiting tasks, closed once the value is delivered
+		std::atomic<DependencyEntry*> waiting;
 
-	public:
+		static DependencyEntry* closed() {
+			return reinterpret_cast<DependencyEntry*>(std::uintptr_t(1));
+		}
+
+	protected:
 
-		Promise() : ready(false) {}
+		PromiseBase(bool ready)
+			: ready(ready), waiting(ready ? closed() : nullptr) {}
 
-		Promise(T&& value)
-			: ready(true), value(std::move(value)) {}
+		// marks this promise as delivered and releases the waiting tasks
+		void markReady();
+
+	public:
+
+		PromiseBase(const PromiseBase&) = delete;
+		PromiseBase& operator=(const PromiseBase&) = delete;
 
 		bool isReady() const {
 			return ready;
 		}
 
+		/**
+		 * Registers the given entry as waiting for this promise. If the value has
+		 * already been delivered, the entry is not registered and false is returned.
+		 */
+		bool addWaiting(DependencyEntry* entry) {
+			DependencyEntry* head = waiting.load();
+			do {
+				if (head == closed()) return false;
+				entry->next = head;
+			} while(!waiting.compare_exchange_weak(head,entry));
+			return true;
+		}
+
+	};
+
+	/**
+	 * A promise, forming the connection between a task and a treeture
+	 * waiting for the task's result.
+	 */
+	template<typename T>
+	class Promise : public PromiseBase {
+
+		// the delivered value
+		T value;
+
+	public:
+
+		Promise() : PromiseBase(false) {}
+
+		Promise(T&& value)
+			: PromiseBase(true), value(std::move(value)) {}
+
 		const T& getValue() const {
 			return value;
 		}
 
 		void setValue(T&& newValue) {
 			value = std::move(newValue);
-			ready = true;
+			markReady();
 		}
 
 		T&& extractValue() {
@@ -781,22 +1199,15 @@ namespace reference {
 	 * A specialization for void promises.
 	 */
 	template<>
-	class Promise<void> {
-
-		// a marker for delivered promises
-		std::atomic<bool> ready;
+	class Promise<void> : public PromiseBase {
 
 	public:
 
 		Promise(bool ready = false)
-			: ready(ready) {}
-
-		bool isReady() const {
-			return ready;
-		}
+			: PromiseBase(ready) {}
 
 		void setReady() {
-			ready = true;
+			markReady();
 		}
 
 	};
@@ -805,6 +1216,109 @@ namespace reference {
 	template<typename T>
 	using PromisePtr = std::shared_ptr<Promise<T>>;
 
+	/**
+	 * Creates a new promise, allocated from the pool of the current worker.
+	 */
+	template<typename T, typename ... Args>
+	PromisePtr<T> make_promise(Args&& ... args) {
+		return std::allocate_shared<Promise<T>>(PoolAllocator<Promise<T>>(), std::forward<Args>(args)...);
+	}
+
+
+	// ---------------------------------------------------------------------------------------------
+	//										   Task Batches
+	// ---------------------------------------------------------------------------------------------
+
+	namespace runtime {
+
+		class Worker;
+
+		/**
+		 * A batch of tasks released by the current thread. While a batch is open, tasks becoming
+		 * ready are collected instead of being enqueued one by one. When the batch is flushed, they
+		 * are pushed to the queues of their target workers with a single operation per queue, and
+		 * sleeping workers are woken up once for the entire batch.
+		 */
+		class TaskBatch {
+
+			// the number of tasks collected before the batch is flushed implicitly
+			enum { capacity = 16 };
+
+			struct Entry {
+				Worker* worker;
+				TaskBase* task;
+			};
+
+			Entry entries[capacity];
+
+			std::size_t size;
+
+			static TaskBatch*& getCurrentRef() {
+				static thread_local TaskBatch* batch = nullptr;
+				return batch;
+			}
+
+			friend class TaskBatchScope;
+
+		public:
+
+			TaskBatch() : size(0) {}
+
+			TaskBatch(const TaskBatch&) = delete;
+			TaskBatch& operator=(const TaskBatch&) = delete;
+
+			/**
+			 * Obtains the batch currently open by this thread, null if there is none.
+			 */
+			static TaskBatch* getCurrent() {
+				return getCurrentRef();
+			}
+
+			/**
+			 * Adds a task to be enqueued at the given worker to this batch.
+			 */
+			void add(Worker& worker, TaskBase& task) {
+				if (size == capacity) flush();
+				entries[size++] = { &worker, &task };
+			}
+
+			/**
+			 * Enqueues all tasks collected so far.
+			 */
+			void flush();
+
+		};
+
+		/**
+		 * A scope within which the tasks released by the current thread are collected in a batch,
+		 * enqueued when the scope is left. Nested scopes join the batch of the outermost scope.
+		 * Collected tasks are enqueued before the current thread starts waiting for any task.
+		 */
+		class TaskBatchScope {
+
+			TaskBatch batch;
+
+			bool outermost;
+
+		public:
+
+			TaskBatchScope() : outermost(!TaskBatch::getCurrent()) {
+				if (outermost) TaskBatch::getCurrentRef() = &batch;
+			}
+
+			TaskBatchScope(const TaskBatchScope&) = delete;
+			TaskBatchScope& operator=(const TaskBatchScope&) = delete;
+
+			~TaskBatchScope() {
+				if (!outermost) return;
+				TaskBatch::getCurrentRef() = nullptr;
+				batch.flush();
+			}
+
+		};
+
+	} // end namespace runtime
+
 
 	// ---------------------------------------------------------------------------------------------
 	//											  Tasks
@@ -888,6 +1402,27 @@ namespace reference {
 		// substitute got cut lose
 		std::atomic<bool> substituted;
 
+		// the policy deciding on the splitting of this task, null for the runtime's default
+		const SplitPolicy* splitPolicy;
+
+		// the priority band this task is scheduled in
+		TaskPriority priority;
+
+		// set if a treeture owns this task, which keeps its result alive beyond its completion
+		std::atomic<bool> retained;
+
+		// set once a treeture took over this task, enabling the delivery of its result to a promise
+		bool owned;
+
+		// the state of the delivery of the result to a promise attached by a sharing treeture
+		enum class PromiseState : std::uint8_t { None, Attached, Delivered };
+		std::atomic<PromiseState> promiseState;
+
+		// the entries for registering this task as waiting for other tasks
+		enum { num_inline_dependency_entries = 4 };
+		DependencyEntry dependency_entries[num_inline_dependency_entries];
+		std::uint8_t num_dependency_entries;
+
 	public:
 
 		TaskBase(bool done = false)
@@ -898,7 +1433,12 @@ namespace reference {
 			  splitable(false),
 			  left(nullptr), right(nullptr), substitute(nullptr),
 			  parallel(false), parent(nullptr),
-			  substituted(false) {
+			  substituted(false),
+			  splitPolicy(getCurrentSplitPolicy()),
+			  priority(getCurrentTaskPriority()),
+			  retained(false), owned(false),
+			  promiseState(PromiseState::None),
+			  num_dependency_entries(0) {
 
 			LOG_TASKS( "Created " << *this );
 
@@ -916,7 +1456,12 @@ namespace reference {
 			  left(left), right(right), substitute(nullptr),
 			  parallel(parallel),
 			  parent(nullptr), alive_child_counter(0),
-			  substituted(false) {
+			  substituted(false),
+			  splitPolicy(getCurrentSplitPolicy()),
+			  priority(getCurrentTaskPriority()),
+			  retained(false), owned(false),
+			  promiseState(PromiseState::None),
+			  num_dependency_entries(0) {
 
 			LOG_TASKS( "Created " << *this );
 			assert(this->left);
@@ -941,6 +1486,18 @@ namespace reference {
 
 	public:
 
+		// -- memory management --
+
+		// tasks are allocated from the pool of the creating worker
+		static void* operator new(std::size_t size) {
+			return pool_allocate(size);
+		}
+
+		// and returned to it, no matter which worker is destroying them
+		static void operator delete(void* ptr) {
+			pool_deallocate(ptr);
+		}
+
 		// -- observers --
 
 		const TaskFamilyPtr& getTaskFamily() const {
@@ -955,8 +1512,16 @@ namespace reference {
 			return id;
 		}
 
-		bool isOrphan() const {
-			return !family;
+		const SplitPolicy* getSplitPolicy() const {
+			return splitPolicy;
+		}
+
+		TaskPriority getPriority() const {
+			return priority;
+		}
+
+		bool isOrphan() const {
+			return !family;
 		}
 
 		std::size_t getDepth() const {
@@ -1007,11 +1572,62 @@ namespace reference {
 
 				// add dependency
 				assert_true(cur.getFamily());
-				cur.getFamily()->addDependency(this,cur.getPath());
+				cur.getFamily()->addDependency(this,cur.getPath(),cur.getFamilyId());
 			}
 
 		}
 
+		/**
+		 * Makes this task wait for the delivery of the given promise, the basis of
+		 * continuations attached to treetures of arbitrary tasks, including orphans.
+		 */
+		void addDependency(PromiseBase& promise) {
+
+			// we must still be in the new state
+			assert_eq(getState(),State::New);
+
+			// this task must not yet be started nor must the parent be lost
+			assert_le(2,num_active_dependencies);
+
+			// filter out delivered promises
+			if (promise.isReady()) return;
+
+			// register as waiting for the promise
+			num_active_dependencies++;
+			DependencyEntry* entry = acquireDependencyEntry();
+			if (promise.addWaiting(entry)) return;
+
+			// the promise got delivered in the meanwhile
+			releaseDependencyEntry(entry);
+			dependencyDone();
+		}
+
+		/**
+		 * Obtains an entry for registering this task as waiting for another task. The first
+		 * entries are embedded in this task, further entries are obtained from the memory pool
+		 * of the current thread. Must only be called while adding dependencies.
+		 */
+		DependencyEntry* acquireDependencyEntry() {
+			DependencyEntry* res = (num_dependency_entries < num_inline_dependency_entries)
+					? &dependency_entries[num_dependency_entries++]
+					: static_cast<DependencyEntry*>(pool_allocate(sizeof(DependencyEntry)));
+			res->task = this;
+			res->next = nullptr;
+			return res;
+		}
+
+		/**
+		 * Releases an entry obtained through acquireDependencyEntry. Must be called before
+		 * notifying the task of the entry, since the task may be destroyed afterwards.
+		 */
+		static void releaseDependencyEntry(DependencyEntry* entry) {
+			auto addr = reinterpret_cast<std::uintptr_t>(entry);
+			auto begin = reinterpret_cast<std::uintptr_t>(&entry->task->dependency_entries[0]);
+			auto end = reinterpret_cast<std::uintptr_t>(&entry->task->dependency_entries[num_inline_dependency_entries]);
+			// embedded entries are released along with their task
+			if (addr < begin || end <= addr) pool_deallocate(entry);
+		}
+
 		void adopt(const TaskFamilyPtr& family, const TaskPath& path = TaskPath()) {
 			// check that this task is not member of another family
 			assert_true(isOrphan()) << "Can not adopt a member of another family.";
@@ -1026,8 +1642,9 @@ namespace reference {
 			// update the id
 			this->id = TaskID(family->getId(),path);
 
-			// mark as complete, if already complete
-			if(isDone()) family->markDone(path);
+			// mark as complete, if already complete, otherwise track it
+			if(isDone()) family->markDone(path,id.getRootID());
+			else family->addMember(path,id.getRootID());
 
 			// propagate adoption to descendants
 			if (substitute) substitute->adopt(family,path);
@@ -1036,6 +1653,50 @@ namespace reference {
 		}
 
 
+		// -- ownership by treetures --
+
+		/**
+		 * Makes the treeture this task is released to its owner, keeping this task and its
+		 * result alive until it is disowned. Must be called before the task is started, or
+		 * once it is done.
+		 */
+		void own() {
+			owned = true;
+			retained.store(true, std::memory_order_relaxed);
+		}
+
+		/**
+		 * Releases the ownership of the treeture, destroying this task if it is no longer
+		 * needed otherwise.
+		 */
+		void disown() {
+			// synchronizes with the final accesses of the worker in case this call deletes the task
+			if (retained.exchange(false, std::memory_order_acq_rel)) return;
+			delete this;
+		}
+
+	protected:
+
+		/**
+		 * Registers a promise, to be stored by the derived class, for the delivery of the result
+		 * of this task. If the result has already been delivered, false is returned.
+		 */
+		bool attachPromise() {
+			assert_true(owned);
+			PromiseState expected = PromiseState::None;
+			return promiseState.compare_exchange_strong(expected, PromiseState::Attached);
+		}
+
+		/**
+		 * Marks the result of this task as delivered, to be called once it is available. Returns
+		 * true if it is to be passed on to an attached promise.
+		 */
+		bool deliverResult() {
+			return owned && promiseState.exchange(PromiseState::Delivered) == PromiseState::Attached;
+		}
+
+	public:
+
 		// -- state transitions --
 
 		// New -> Blocked
@@ -1104,8 +1765,9 @@ namespace reference {
 				// check which child tasks need to be started
 				if (lState == State::New && rState == State::New) {
 
-					// both need to be started
+					// both need to be started, released as a single batch
 					alive_child_counter = 2;
+					runtime::TaskBatchScope batch;
 					left->start();
 					right->start();
 
@@ -1402,7 +2064,7 @@ namespace reference {
 			// inform the family that the job is done
 			if (!parent || parent->substitute != this) {
 				// only due this if you are not the substitute
-				if (family) family->markDone(path);
+				if (family) family->markDone(path,id.getRootID());
 
 				// if there is no parent, don't wait for it to signal its release
 				if (!parent) dependencyDone();
@@ -1514,82 +2176,193 @@ namespace reference {
 	// ----------- Task Dependency Manager Implementations ---------------
 
 	template<std::size_t max_depth>
-	void TaskDependencyManager<max_depth>::addDependency(TaskBase* x, const TaskPath& y) {
+	void TaskDependencyManager<max_depth>::addTask(const TaskPath& task, std::size_t epoch) {
 
-		// locate entry
-		std::size_t pos = getPosition(y);
+		// tasks within the dense depth are always tracked, tasks beyond max_depth never
+		std::size_t l = task.getLength();
+		if (l <= dense_depth || l > max_depth) return;
 
-		// load epoch
-		auto curEpoch = epoch.load();
+		// ignore tasks of past epochs
+		if (epoch != this->epoch.load()) return;
 
-		// load the head
-		Entry* head = data[pos].load();
+		// claim a slot in the first table that is not crowded
+		auto key = getKey(l,task.getPath());
+		for(std::size_t t=0; t<max_tables; t++) {
+			Slot* slots = getTable(t);
+
+			// make the table visible to lookups before claiming a slot in it
+			std::size_t used = tables_used.load(std::memory_order_acquire);
+			while(used <= t && !tables_used.compare_exchange_weak(used, t+1, std::memory_order_acq_rel)) {}
+
+			bool crowded;
+			if (findSlot(slots, getNumSlots(t), key, true, crowded)) return;
+		}
+
+		// all tables are crowded, the task is represented by its ancestor
+	}
+
+	template<std::size_t max_depth>
+	typename TaskDependencyManager<max_depth>::Slot* TaskDependencyManager<max_depth>::getTable(std::size_t t) {
+		Slot* slots = tables[t].load(std::memory_order_acquire);
+		if (slots) return slots;
+
+		Slot* fresh = new Slot[getNumSlots(t)];
+		for(std::size_t i=0; i<getNumSlots(t); i++) {
+			fresh[i].key = 0;
+			fresh[i].cell = completedIn(0);
+		}
+		if (tables[t].compare_exchange_strong(slots, fresh, std::memory_order_acq_rel)) return fresh;
+		delete [] fresh;
+		return slots;
+	}
+
+	template<std::size_t max_depth>
+	void TaskDependencyManager<max_depth>::addDependency(TaskBase* x, const TaskPath& y, std::size_t epoch) {
 
-		// check whether we are still in the same epoch
-		if (curEpoch != epoch.load()) {
-			// the epoch has changed, the previous is gone
+		// ignore dependencies on past epochs
+		if (epoch != this->epoch.load()) {
+			// the epoch is over, and so is the task
 			x->dependencyDone();
 			return;
 		}
 
-		// check whether this task is already completed
-		if (isDone(head)) {
+		// locate entry
+		cell_type& cell = getCell(y);
+
+		// load the head
+		std::uintptr_t head = cell.load();
+
+		// check whether the task is already completed, or its epoch is over
+		if (isDoneIn(head, epoch) || epoch != this->epoch.load()) {
 			// signal that this dependency is done
 			x->dependencyDone();
 			return;
 		}
 
 		// insert element
-		Entry* entry = new Entry();
-		entry->task = x;
-		entry->next = head;
+		Entry* entry = x->acquireDependencyEntry();
+		entry->next = isDone(head) ? nullptr : toEntry(head);
 
 		// update entry pointer lock-free
-		while (!data[pos].compare_exchange_weak(entry->next,entry)) {
+		// (note: a list head of the current epoch can only be mistaken for a head of a later
+		//  epoch if this thread is delayed for the entire life time of the family in between)
+		while (!cell.compare_exchange_weak(head,toCell(entry))) {
 
 			// check whether the task has been completed in the meanwhile
-			if (isDone(entry->next)) {
-				delete entry;
+			if (isDoneIn(head, epoch) || epoch != this->epoch.load()) {
+				TaskBase::releaseDependencyEntry(entry);
 				// signal that this dependency is done
 				x->dependencyDone();
 				return;
 			}
 
 			// otherwise, repeat until it worked
+			entry->next = isDone(head) ? nullptr : toEntry(head);
 		}
 
 		// successfully inserted
 	}
 
 	template<std::size_t max_depth>
-	void TaskDependencyManager<max_depth>::markComplete(const TaskPath& task) {
+	bool TaskDependencyManager<max_depth>::markComplete(const TaskPath& task, std::size_t epoch) {
 
 		// ignore tasks that are too small
-		if (task.getLength() > max_depth) return;
+		std::size_t l = task.getLength();
+		if (l > max_depth) return false;
+
+		// deep tasks are only considered if tracked
+		if (l > dense_depth) {
+			if (tables_used.load() == 0) return false;
+			Slot* slot = lookup(getKey(l,task.getPath()));
+			return slot && markComplete(slot->cell, epoch);
+		}
+
+		// mark the task as complete
+		if (!markComplete(data[getKey(l,task.getPath())], epoch)) return false;
+
+		// and its children
+		if (l < dense_depth) {
+			markComplete(task.getLeftChildPath(),epoch);
+			markComplete(task.getRightChildPath(),epoch);
+		}
+
+		// this call completed the task
+		return true;
+	}
+
+	template<std::size_t max_depth>
+	bool TaskDependencyManager<max_depth>::markComplete(cell_type& cell, std::size_t epoch) {
 
 		// mark as complete and obtain head of depending list
-		auto pos = getPosition(task);
-		Entry* cur = data[pos].exchange((Entry*)0x1);
+		std::uintptr_t head = cell.load();
+		do {
+			// do not process list twice (may be called multiple times due to substitutes)
+			if (isDoneIn(head, epoch)) return false;
 
-		// do not process list twice (may be called multiple times due to substitutes)
-		if (isDone(cur)) return;
+			// ignore completions of past epochs
+			if (epoch != this->epoch.load()) return false;
+
+		} while(!cell.compare_exchange_weak(head,completedIn(epoch)));
 
 		// signal the completion of this task
+		Entry* cur = isDone(head) ? nullptr : toEntry(head);
 		while(cur) {
 
+			// release the entry, since it may be destroyed with its task
+			Entry* next = cur->next;
+			TaskBase* task = cur->task;
+			TaskBase::releaseDependencyEntry(cur);
+
 			// signal a completed dependency
-			cur->task->dependencyDone();
+			task->dependencyDone();
 
 			// move on to next entry
-			Entry* next = cur->next;
-			delete cur;
 			cur = next;
 		}
 
-		// and its children
-		if (pos >= num_entries/2) return;
-		markComplete(task.getLeftChildPath());
-		markComplete(task.getRightChildPath());
+		return true;
+	}
+
+	template<std::size_t max_depth>
+	void TaskDependencyManager<max_depth>::clear(cell_type& cell) {
+		if (isDone(cell)) return;
+		Entry* entry = toEntry(cell);
+		while(entry) {
+			Entry* next = entry->next;
+			TaskBase::releaseDependencyEntry(entry);
+			entry = next;
+		}
+	}
+
+	// -------------------------------------------------------------------
+
+
+
+	// ------------------------------ Promise ----------------------------
+
+	inline void PromiseBase::markReady() {
+
+		// mark as delivered
+		ready = true;
+
+		// close the list of waiting tasks
+		DependencyEntry* cur = waiting.exchange(closed());
+		assert_ne(closed(),cur) << "Promise delivered twice!";
+
+		// and release those tasks
+		while(cur) {
+
+			// release the entry, since it may be destroyed with its task
+			DependencyEntry* next = cur->next;
+			TaskBase* task = cur->task;
+			TaskBase::releaseDependencyEntry(cur);
+
+			// signal a completed dependency
+			task->dependencyDone();
+
+			// move on to next entry
+			cur = next;
+		}
 	}
 
 	// -------------------------------------------------------------------
@@ -1599,7 +2372,7 @@ namespace reference {
 	// ------------------------- Task Reference --------------------------
 
 	inline task_reference::task_reference(const TaskBase& task)
-		: family(task.getTaskFamily()), path(task.getTaskPath()) {
+		: family(task.getTaskFamily()), familyId(task.getId().getRootID()), path(task.getTaskPath()) {
 		assert_false(task.isOrphan()) << "Unable to reference an orphan task!";
 	}
 
@@ -1612,7 +2385,8 @@ namespace reference {
 
 		T value;
 
-		mutable PromisePtr<T> promise;
+		// the promise the value is delivered to, if the owning treeture got shared
+		PromisePtr<T> promise;
 
 	public:
 
@@ -1636,16 +2410,20 @@ namespace reference {
 			return std::move(value);
 		}
 
-		void setPromise(const PromisePtr<T>& newPromise) const {
-
-			// this task must not be started yet
-			assert_eq(State::New,this->getState());
+		/**
+		 * Obtains a promise delivering the value of this task, taking the value over if
+		 * it is already available. May only be called once, by the owning treeture.
+		 */
+		PromisePtr<T> share() {
 
-			// there must not be a previous promise
-			assert_false(promise);
+			// completed tasks hand over their value directly
+			if (isDone()) return make_promise<T>(std::move(value));
 
-			// register promise
-			promise = newPromise;
+			// otherwise the value is delivered to the promise, unless it got delivered in the meanwhile
+			promise = make_promise<T>();
+			if (attachPromise()) return promise;
+			promise.reset();
+			return make_promise<T>(std::move(value));
 		}
 
 	protected:
@@ -1656,7 +2434,7 @@ namespace reference {
 
 		void aggregate() override {
 			value = computeAggregate();
-			if(promise) {
+			if (deliverResult()) {
 				promise->setValue(std::move(value));
 			}
 		}
@@ -1680,7 +2458,8 @@ namespace reference {
 	template<>
 	class Task<void> : public TaskBase {
 
-		mutable PromisePtr<void> promise;
+		// the promise signaled upon completion, if the owning treeture got shared
+		PromisePtr<void> promise;
 
 	public:
 
@@ -1694,16 +2473,20 @@ namespace reference {
 		void getValue() const {
 		}
 
-		void setPromise(const PromisePtr<void>& newPromise) const {
-
-			// this task must not be started yet
-			assert_eq(State::New,this->getState());
+		/**
+		 * Obtains a promise signaling the completion of this task. May only
+		 * be called once, by the owning treeture.
+		 */
+		PromisePtr<void> share() {
 
-			// there must not be a previous promise
-			assert_false(promise);
+			// completed tasks are represented by a ready promise
+			if (isDone()) return make_promise<void>(true);
 
-			// register promise
-			promise = newPromise;
+			// otherwise the promise is signaled, unless the task completed in the meanwhile
+			promise = make_promise<void>();
+			if (attachPromise()) return promise;
+			promise.reset();
+			return make_promise<void>(true);
 		}
 
 	protected:
@@ -1714,7 +2497,7 @@ namespace reference {
 
 		void aggregate() override {
 			computeAggregate();
-			if(promise) {
+			if (deliverResult()) {
 				promise->setReady();
 			}
 		}
@@ -1932,17 +2715,21 @@ namespace reference {
 
 			task_reference taskRef;
 
-			PromisePtr<T> promise;
+			// the task computing the value, owned by this treeture until the value is shared
+			mutable Task<T>* task;
+
+			// the promise delivering the value, once shared
+			mutable PromisePtr<T> promise;
 
-			treeture_base() : promise() {}
+			treeture_base() : task(nullptr), promise() {}
 
-			treeture_base(const Task<T>& task) : promise(std::make_shared<Promise<T>>()) {
+			treeture_base(Task<T>& task) : task(&task), promise() {
 
-				// make sure task has not been started yet
-				assert_eq(TaskBase::State::New, task.getState());
+				// make sure task has not been started yet, or is already done
+				assert_true(TaskBase::State::New == task.getState() || task.isDone());
 
-				// register the promise
-				task.setPromise(promise);
+				// the value will be obtained from the task itself
+				task.own();
 
 				// also create task reference if available
 				if (!task.isOrphan()) {
@@ -1951,7 +2738,7 @@ namespace reference {
 			}
 
 			treeture_base(PromisePtr<T>&& promise)
-				: promise(std::move(promise)) {
+				: task(nullptr), promise(std::move(promise)) {
 
 				// make sure the promise is valid and set
 				assert_true(this->promise);
@@ -1964,19 +2751,32 @@ namespace reference {
 			using value_type = T;
 
 			treeture_base(const treeture_base&) = delete;
-			treeture_base(treeture_base&& other) = default;
+			treeture_base(treeture_base&& other)
+				: taskRef(std::move(other.taskRef)), task(other.task), promise(std::move(other.promise)) {
+				other.task = nullptr;
+			}
 
 			treeture_base& operator=(const treeture_base&) = delete;
-			treeture_base& operator=(treeture_base&& other) = default;
+			treeture_base& operator=(treeture_base&& other) {
+				std::swap(taskRef,other.taskRef);
+				std::swap(task,other.task);
+				std::swap(promise,other.promise);
+				return *this;
+			}
+
+			~treeture_base() {
+				if (task) task->disown();
+			}
 
 			void wait() const;
 
 			bool isDone() const {
+				if (task) return task->isDone();
 				return !promise || promise->isReady();
 			}
 
 			bool isValid() const {
-				return (bool)promise;
+				return task || promise;
 			}
 
 			task_reference getLeft() const {
@@ -1995,6 +2795,21 @@ namespace reference {
 				return getTaskReference();
 			}
 
+			// -- implementation details --
+
+			/**
+			 * Obtains a promise delivering the value of this treeture, to be shared with continuations.
+			 * Only upon the first call, a promise is attached to the task computing the value.
+			 */
+			const PromisePtr<T>& getPromise() const {
+				if (task) {
+					promise = task->share();
+					task->disown();
+					task = nullptr;
+				}
+				return promise;
+			}
+
 		};
 
 	}
@@ -2012,7 +2827,7 @@ namespace reference {
 
 	protected:
 
-		treeture(const Task<T>& task) : super(task) {}
+		treeture(Task<T>& task) : super(task) {}
 
 	public:
 
@@ -2021,7 +2836,7 @@ namespace reference {
 		treeture() {}
 
 		treeture(T&& value)
-			: super(std::make_shared<Promise<T>>(std::move(value))) {}
+			: super(make_promise<T>(std::move(value))) {}
 
 		treeture(const treeture&) = delete;
 		treeture(treeture&& other) = default;
@@ -2031,14 +2846,16 @@ namespace reference {
 
 		const T& get() const & {
 			static const T defaultValue = T();
-			if (!this->promise) return defaultValue;
+			if (!this->isValid()) return defaultValue;
 			super::wait();
+			if (this->task) return this->task->getValue();
 			return this->promise->getValue();
 		}
 
 		T&& get() && {
-			assert_true(this->promise);
+			assert_true(this->isValid());
 			super::wait();
+			if (this->task) return std::move(*this->task).extractValue();
 			return this->promise->extractValue();
 		}
 	};
@@ -2056,7 +2873,7 @@ namespace reference {
 
 	protected:
 
-		treeture(const Task<void>& task) : super(task) {}
+		treeture(Task<void>& task) : super(task) {}
 
 	public:
 
@@ -2084,7 +2901,9 @@ namespace reference {
 		assert_true(TaskBase::State::Blocked == this->state || TaskBase::State::Ready == this->state)
 				<< "Actual state: " << this->state;
 
-		// decompose this task
+		// decompose this task, sub-tasks inherit the split policy and the priority
+		SplitPolicyScope policyScope(TaskBase::getSplitPolicy());
+		TaskPriorityScope priorityScope(TaskBase::getPriority());
 		Task<R>* substitute = decompose().toTask();
 		assert_true(substitute);
 		assert_true(substitute->state == TaskBase::State::New || substitute->state == TaskBase::State::Done);
@@ -2095,6 +2914,10 @@ namespace reference {
 		// mark as no longer splitable
 		TaskBase::setSplitable(false);
 
+		// log the split while this task is still alive -- once the substitute is in place,
+		// this task may get finished and destroyed concurrently
+		logProfilerEvent(ProfileLogEntry::createTaskSplitEntry(this->getId()));
+
 		// mutate to new task
 		Task<R>::setSubstitute(substitute);
 
@@ -2108,24 +2931,6 @@ namespace reference {
 	//										 Unreleased Treetures
 	// ---------------------------------------------------------------------------------------------
 
-	namespace detail {
-
-		template<typename T>
-		struct done_task_to_treeture {
-			treeture<T> operator()(Task<T>&& task) {
-				return treeture<T>(std::move(task).extractValue());
-			}
-		};
-
-		template<>
-		struct done_task_to_treeture<void> {
-			treeture<void> operator()(Task<void>&&) {
-				return treeture<void>();
-			}
-		};
-	}
-
-
 	/**
 	 * A handle to a yet unreleased task.
 	 */
@@ -2168,9 +2973,9 @@ namespace reference {
 			// there has to be a task
 			assert_true(task);
 
-			// special case for completed tasks
+			// special case for completed tasks, the treeture takes the task over
 			if (task->isDone()) {
-				auto res = detail::done_task_to_treeture<T>()(std::move(*task));
+				treeture<T> res(*task);
 				task->dependencyDone();	// remove one dependency for the lose of the owner
 				task = nullptr;
 				return res;
@@ -2375,6 +3180,182 @@ namespace reference {
 	}
 
 
+	// -- continuations --
+
+	/**
+	 * The result of a when_any operation on treetures of this implementation.
+	 */
+	template<typename T>
+	using when_any_result = impl::when_any_result<treeture<T>>;
+
+	namespace detail {
+
+		// calls a continuation with the value delivered by a promise, consuming the value
+		template<typename T>
+		struct continuation_call {
+			template<typename Op>
+			auto operator()(Op& op, const PromisePtr<T>& promise) const {
+				return op(promise ? promise->extractValue() : T());
+			}
+		};
+
+		template<>
+		struct continuation_call<void> {
+			template<typename Op>
+			auto operator()(Op& op, const PromisePtr<void>&) const {
+				return op();
+			}
+		};
+
+		template<typename T, typename Op>
+		using continuation_result_t = decltype(continuation_call<T>()(std::declval<Op&>(),std::declval<const PromisePtr<T>&>()));
+
+		template<typename Action>
+		Task<std::result_of_t<Action()>>* make_continuation_task(const Action& action) {
+			return new SimpleTask<Action>(action);
+		}
+
+		inline void waitFor(TaskBase&) {}
+
+		template<typename T, typename ... Rest>
+		void waitFor(TaskBase& task, const PromisePtr<T>& first, const Rest& ... rest) {
+			if (first) task.addDependency(*first);
+			waitFor(task,rest...);
+		}
+
+		// takes over the promise of the given treeture
+		template<typename T>
+		PromisePtr<T> extractPromise(treeture<T>&& treeture) {
+			reference::treeture<T> local(std::move(treeture));
+			return local.getPromise();
+		}
+
+		template<typename ... Ts, std::size_t ... Is>
+		void waitForAll(TaskBase& task, const std::tuple<PromisePtr<Ts>...>& promises, std::index_sequence<Is...>) {
+			waitFor(task,std::get<Is>(promises)...);
+		}
+
+		template<typename ... Ts, std::size_t ... Is>
+		std::tuple<Ts...> extractValues(const std::tuple<PromisePtr<Ts>...>& promises, std::index_sequence<Is...>) {
+			return std::tuple<Ts...>((std::get<Is>(promises) ? std::get<Is>(promises)->extractValue() : Ts())...);
+		}
+
+	}
+
+	/**
+	 * Attaches a continuation to the given treeture. The continuation is processed by a new task,
+	 * scheduled once the value of the treeture is delivered, and obtains this value as its argument
+	 * (none for void treetures). Unlike get(), no worker is blocked while waiting for the value.
+	 */
+	template<typename T, typename Op, typename R = detail::continuation_result_t<T,Op>>
+	treeture<R> then(treeture<T>&& pred, Op&& op) {
+		auto promise = detail::extractPromise(std::move(pred));
+		auto task = detail::make_continuation_task([promise, op = std::forward<Op>(op)]() mutable {
+			return detail::continuation_call<T>()(op,promise);
+		});
+		detail::waitFor(*task,promise);
+		return detail::init<true>(after(),task).release();
+	}
+
+	/**
+	 * Creates a treeture of the values of the given non-void treetures, delivered once all of them are.
+	 */
+	template<typename ... Ts>
+	treeture<std::tuple<Ts...>> when_all(treeture<Ts>&& ... treetures) {
+		auto promises = std::make_tuple(detail::extractPromise(std::move(treetures))...);
+		auto task = detail::make_continuation_task([promises]() {
+			return detail::extractValues(promises,std::index_sequence_for<Ts...>());
+		});
+		detail::waitForAll(*task,promises,std::index_sequence_for<Ts...>());
+		return detail::init<true>(after(),task).release();
+	}
+
+	/**
+	 * Creates a treeture of the values of the given treetures, delivered once all of them are.
+	 */
+	template<typename T>
+	treeture<std::vector<T>> when_all(std::vector<treeture<T>>&& treetures) {
+		std::vector<PromisePtr<T>> promises;
+		promises.reserve(treetures.size());
+		for(auto& cur : treetures) {
+			promises.push_back(detail::extractPromise(std::move(cur)));
+		}
+		auto task = detail::make_continuation_task([promises]() {
+			std::vector<T> res;
+			res.reserve(promises.size());
+			for(const auto& cur : promises) {
+				res.push_back(cur ? cur->extractValue() : T());
+			}
+			return res;
+		});
+		for(const auto& cur : promises) {
+			detail::waitFor(*task,cur);
+		}
+		return detail::init<true>(after(),task).release();
+	}
+
+	/**
+	 * Creates a treeture completed once all the given void treetures are.
+	 */
+	inline treeture<void> when_all(std::vector<treeture<void>>&& treetures) {
+		auto task = detail::make_continuation_task([]() {});
+		for(auto& cur : treetures) {
+			detail::waitFor(*task,detail::extractPromise(std::move(cur)));
+		}
+		return detail::init<true>(after(),task).release();
+	}
+
+	/**
+	 * Creates a treeture delivered once the first of the given treetures is, providing its index
+	 * and the given treetures. For an empty list of treetures, the index is 0 and delivered immediately.
+	 */
+	template<typename T>
+	treeture<when_any_result<T>> when_any(std::vector<treeture<T>>&& treetures) {
+
+		// the state shared by the continuation and the observers of the individual treetures
+		struct State {
+			std::vector<treeture<T>> treetures;
+			std::atomic<bool> decided;
+			std::size_t index;
+			PromisePtr<void> decision;
+		};
+
+		auto state = std::make_shared<State>();
+		state->treetures = std::move(treetures);
+		state->decided = false;
+		state->index = 0;
+		state->decision = make_promise<void>(state->treetures.empty());
+
+		// the continuation waits for the decision
+		auto task = detail::make_continuation_task([state]() {
+			return when_any_result<T>{ state->index, std::move(state->treetures) };
+		});
+		detail::waitFor(*task,state->decision);
+
+		// the treetures may be consumed as soon as the decision is made
+		std::vector<PromisePtr<T>> promises;
+		promises.reserve(state->treetures.size());
+		for(const auto& cur : state->treetures) {
+			promises.push_back(cur.getPromise());
+		}
+
+		auto res = detail::init<true>(after(),task).release();
+
+		// the first completed treeture makes the decision
+		for(std::size_t i=0; i<promises.size(); i++) {
+			auto observer = detail::make_continuation_task([state,i]() {
+				if (state->decided.exchange(true)) return;
+				state->index = i;
+				state->decision->setReady();
+			});
+			detail::waitFor(*observer,promises[i]);
+			observer->start();
+		}
+
+		return res;
+	}
+
+
 	// ---------------------------------------------------------------------------------------------
 	//											Runtime
 	// ---------------------------------------------------------------------------------------------
@@ -2400,17 +3381,23 @@ namespace reference {
 		namespace detail {
 
 			/**
-			 * A utility to fix the affinity of the current thread to the given core.
+			 * Tests whether the user permits fixing the affinity of worker threads.
+			 */
+			inline bool isAffinityEnabled() {
+				return std::getenv("NO_AFFINITY") == nullptr;
+			}
+
+			/**
+			 * A utility to fix the affinity of the current thread to the given CPU.
 			 * Does not do anything on operating systems other than linux.
 			 */
 			#ifdef __linux__
-				inline void fixAffinity(int core) {
+				inline void fixAffinity(int cpu) {
 					// fix affinity if user does not object
-					if(std::getenv("NO_AFFINITY") == nullptr) {
-						int num_cores = std::thread::hardware_concurrency();
+					if(isAffinityEnabled() && 0 <= cpu && cpu < CPU_SETSIZE) {
 						cpu_set_t mask;
 						CPU_ZERO(&mask);
-						CPU_SET(core % num_cores, &mask);
+						CPU_SET(cpu, &mask);
 						pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask);
 					}
 				}
@@ -2418,8 +3405,22 @@ namespace reference {
 				inline void fixAffinity(int) { }
 			#endif
 
+			/**
+			 * The key recorded for tasks in the queues of workers, such that tasks can be
+			 * inspected without being claimed (and thus without risking to access a task
+			 * processed and destroyed by another worker in the meanwhile).
+			 */
+			struct TaskIdOf {
+				TaskID operator()(TaskBase* task) const {
+					return task->getId();
+				}
+			};
+
 		}
 
+		// the work stealing queue type used for the tasks of a worker
+		using TaskQueue = WorkStealingQueue<TaskBase*,detail::TaskIdOf>;
+
 		class WorkerPool;
 
 
@@ -2427,16 +3428,37 @@ namespace reference {
 
 			using duration = RuntimePredictor::duration;
 
-			// the targeted maximum queue length
-			// (more like a guideline, may be exceeded due to high demand)
-			enum { max_queue_length = 8 };
-
 			WorkerPool& pool;
 
-			volatile bool alive;
+			std::atomic<bool> alive;
 
-			// list of tasks ready to run
-			OptimisticUnboundQueue<TaskBase*> queue;
+			// the spot this worker is parked at while being idle
+			Parker parker;
+
+			// list of tasks ready to run, only pushed to by this worker
+			TaskQueue queue;
+
+			// list of tasks submitted to this worker by other threads
+			UnboundQueue<TaskBase*> inbox;
+
+			// the queues of tasks of a non-default priority
+			struct PriorityBand {
+
+				// list of tasks ready to run, only pushed to by this worker
+				TaskQueue queue;
+
+				// list of tasks submitted to this worker by other threads
+				UnboundQueue<TaskBase*> inbox;
+
+				bool empty() const {
+					return queue.empty() && inbox.empty();
+				}
+
+			};
+
+			// the bands of high and low priority tasks, the normal band are the queue and inbox above
+			PriorityBand urgent;
+			PriorityBand background;
 
 			std::thread thread;
 
@@ -2445,6 +3467,9 @@ namespace reference {
 			// the list of workers to attempt to steel from, in order
 			std::vector<Worker*> stealingOrder;
 
+			// the statistics of this worker, only updated by this worker
+			reference::detail::WorkerStatisticsCounters statistics;
+
 		public:
 
 			Worker(WorkerPool& pool, unsigned id)
@@ -2464,29 +3489,84 @@ namespace reference {
 				alive = false;
 			}
 
+			// tests whether there are tasks in the local queues or inboxes
+			bool hasWork() const {
+				return !queue.empty() || !inbox.empty() || !urgent.empty() || !background.empty();
+			}
+
 			void join() {
 				thread.join();
 			}
 
+			/**
+			 * Obtains a snapshot of the statistics of this worker.
+			 */
+			WorkerStatistics getStatistics() const {
+				return statistics.getSnapshot();
+			}
+
 			void dumpState(std::ostream& out) const {
 				out << "Worker " << id << " / " << thread.get_id() << ":\n";
 				out << "\tQueue:\n";
 				for(const auto& cur : queue.getSnapshot()) {
 					out << "\t\t" << *cur << "\n";
 				}
+				out << "\tInbox:\n";
+				for(const auto& cur : inbox.getSnapshot()) {
+					out << "\t\t" << *cur << "\n";
+				}
+				dumpBand(out,"High priority",urgent);
+				dumpBand(out,"Low priority",background);
 			}
 
 		private:
 
+			// tests whether the calling thread is the owner of this worker's queue
+			bool isOwnerThread() const {
+				return tl_worker == this;
+			}
+
+			static void dumpBand(std::ostream& out, const char* name, const PriorityBand& band) {
+				if (band.empty()) return;
+				out << "\t" << name << " queue:\n";
+				for(const auto& cur : band.queue.getSnapshot()) {
+					out << "\t\t" << *cur << "\n";
+				}
+				out << "\t" << name << " inbox:\n";
+				for(const auto& cur : band.inbox.getSnapshot()) {
+					out << "\t\t" << *cur << "\n";
+				}
+			}
+
+			// obtains the next task from the local queues or inboxes, higher priorities first
+			TaskBase* popLocalTask();
+
+			// obtains the next task of the given band of this worker
+			TaskBase* popLocalTask(PriorityBand& band);
+
+			// attempts to steal a task from the given worker, higher priorities first
+			TaskBase* stealTaskFrom(Worker& other);
+
+			// attempts to steal a task from the given band of another worker
+			static TaskBase* stealTaskFrom(PriorityBand& band);
+
+			// adds a task to the queues of this worker, or to the batch open by the current thread
+			void enqueue(TaskBase& task);
+
+			// adds the given tasks of the given priority to the queues of this worker
+			void push(TaskPriority priority, TaskBase* const* tasks, std::size_t n);
+
+			// adds the given tasks to the given queues of this worker
+			void push(TaskQueue& trgQueue, UnboundQueue<TaskBase*>& trgInbox, TaskBase* const* tasks, std::size_t n);
+
 			void run();
 
 			void runTask(TaskBase& task);
 
-			bool splitTask(TaskBase& task);
+			bool splitTask(TaskBase& task, bool stolen);
 
-			duration estimateRuntime(const TaskBase& task) {
-				return task.getRuntimePredictor().predictTime(task.getDepth());
-			}
+			// splits or runs a task obtained from a queue
+			void processTask(TaskBase& task, bool stolen);
 
 		public:
 
@@ -2494,19 +3574,77 @@ namespace reference {
 
 			bool schedule_step();
 
+			/**
+			 * Makes progress on behalf of a thread waiting for the given task. If help-first
+			 * waiting is enabled, tasks of the sub-tree rooted by the awaited task are preferred,
+			 * taken from the front of the local queue or stolen from the back of other queues.
+			 * Only if there are none, any available task is processed.
+			 */
+			bool schedule_step(const TaskID& awaited);
+
+			friend WorkerPool;
+			friend TaskBatch;
+
 		};
 
 		class WorkerPool {
 
 			std::vector<Worker*> workers;
 
-			// tools for managing idle threads
-			std::mutex m;
-			std::condition_variable cv;
+			// the CPUs the workers are placed on
+			std::vector<int> placement;
+
+			// the steal order of each worker, as indices into the worker list
+			std::vector<std::vector<std::size_t>> stealingOrders;
+
+			// the number of workers parked or about to park, not yet notified
+			std::atomic<int> numSleeping;
+
+			// the position to start the search for workers to wake up
+			std::atomic<unsigned> wakeCursor;
+
+			// the number of idle cycles spinning / yielding before parking a worker
+			std::atomic<unsigned> idleSpinCycles;
+			std::atomic<unsigned> idleYieldCycles;
+
+			// the number of workers currently looking for work
+			std::atomic<int> numIdle;
+
+			// the split policy for tasks not specifying their own
+			std::atomic<const SplitPolicy*> splitPolicy;
+
+			// whether waiting threads prefer tasks contributing to the awaited task
+			std::atomic<bool> helpFirstWaiting;
+
+			// the file runtime predictions are loaded from and saved to, if any
+			std::string predictionsFile;
+
+			static unsigned getEnvOrDefault(const char* name, unsigned def) {
+				if (char* val = std::getenv(name)) {
+					return (unsigned)std::atoi(val);
+				}
+				return def;
+			}
 
 		public:
 
-			WorkerPool() {
+			WorkerPool()
+				: numSleeping(0), wakeCursor(0),
+				  idleSpinCycles(getEnvOrDefault("IDLE_SPIN_CYCLES",10000)),
+				  idleYieldCycles(getEnvOrDefault("IDLE_YIELD_CYCLES",100)),
+				  numIdle(0), splitPolicy(reference::getSplitPolicy("fixed")),
+				  helpFirstWaiting(getEnvOrDefault("HELP_FIRST_WAITING",1) != 0) {
+
+				// parse the split policy
+				if (char* val = std::getenv("SPLIT_POLICY")) {
+					if (auto policy = reference::getSplitPolicy(val)) splitPolicy = policy;
+				}
+
+				// start from the runtime predictions of a previous run
+				if (char* val = std::getenv("RUNTIME_PREDICTIONS")) {
+					predictionsFile = val;
+					loadRuntimePredictors(predictionsFile);
+				}
 
 				int numWorkers = std::thread::hardware_concurrency();
 
@@ -2519,6 +3657,29 @@ namespace reference {
 				// there must be at least one worker
 				if (numWorkers < 1) numWorkers = 1;
 
+				// track dependencies of new task families with a precision matching the number of workers
+				TaskFamilyManager::getInstance().setDependencyDepth(
+					getEnvOrDefault("DEPENDENCY_DEPTH", (unsigned)TaskFamilyManager::getDefaultDependencyDepth(numWorkers))
+				);
+
+				// place workers on CPUs according to the selected policy
+				Topology topology = Topology::getSystemTopology();
+				PlacementPolicy policy = PlacementPolicy::OnePerCore;
+				if (char* val = std::getenv("AFFINITY_POLICY")) {
+					policy = parsePlacementPolicy(val, policy);
+				}
+				placement = topology.getPlacement(policy, numWorkers);
+
+				// steal from close workers first; without fixed affinity all workers are considered equally close
+				auto locations = placement;
+				if (!detail::isAffinityEnabled()) {
+					topology = Topology::createFlat(numWorkers);
+					for(int i=0; i<numWorkers; ++i) locations[i] = i;
+				}
+				for(int i=0; i<numWorkers; ++i) {
+					stealingOrders.push_back(topology.getStealingOrder(locations, i));
+				}
+
 				// create workers
 				for(int i=0; i<numWorkers; ++i) {
 					workers.push_back(new Worker(*this,i));
@@ -2533,7 +3694,7 @@ namespace reference {
 				setCurrentWorker(*workers.front());
 
 				// fix affinity of main thread
-				detail::fixAffinity(0);
+				detail::fixAffinity(placement[0]);
 
 				// fix worker id of main thread
 				setCurrentWorkerID(0);
@@ -2543,15 +3704,14 @@ namespace reference {
 			~WorkerPool() {
 				// shutdown threads
 
-				{
-					// poison all workers
-					std::lock_guard<std::mutex> guard(m);
-					for(auto& cur : workers) {
-						cur->poison();
-					}
+				// poison all workers
+				for(auto& cur : workers) {
+					cur->poison();
+				}
 
-					// make work available
-					workAvailable();
+				// wake up all sleeping workers
+				for(auto& cur : workers) {
+					if (cur->parker.notify()) numSleeping--;
 				}
 
 				// wait for their death
@@ -2559,6 +3719,11 @@ namespace reference {
 					workers[i]->join();
 				}
 
+				// keep runtime predictions for the next run
+				if (!predictionsFile.empty()) {
+					saveRuntimePredictors(predictionsFile);
+				}
+
 				// free resources
 				for(auto& cur : workers) {
 					delete cur;
@@ -2603,10 +3768,100 @@ namespace reference {
 				return workers;
 			}
 
+			/**
+			 * Obtains the CPU the given worker is placed on. Workers are placed according
+			 * to the policy selected by the AFFINITY_POLICY environment variable, which may
+			 * be compact, scatter, or one-per-core (default).
+			 */
+			int getCpu(int i) const {
+				return placement[i];
+			}
+
+			/**
+			 * Obtains the order in which the given worker attempts to steal tasks from others.
+			 */
+			const std::vector<std::size_t>& getStealingOrder(int i) const {
+				return stealingOrders[i];
+			}
+
 			Worker& getWorker() {
 				return getWorker(0);
 			}
 
+			/**
+			 * Updates the number of idle cycles workers are spinning and yielding
+			 * before being parked. Initial values may be set through the environment
+			 * variables IDLE_SPIN_CYCLES and IDLE_YIELD_CYCLES.
+			 */
+			void setIdleThresholds(unsigned spinCycles, unsigned yieldCycles) {
+				idleSpinCycles = spinCycles;
+				idleYieldCycles = yieldCycles;
+			}
+
+			unsigned getIdleSpinCycles() const {
+				return idleSpinCycles.load(std::memory_order_relaxed);
+			}
+
+			unsigned getIdleYieldCycles() const {
+				return idleYieldCycles.load(std::memory_order_relaxed);
+			}
+
+			/**
+			 * Enables or disables help-first waiting, where threads waiting for a task prefer
+			 * processing tasks contributing to it (see Worker::schedule_step). It is enabled
+			 * by default, and may be disabled by setting the environment variable
+			 * HELP_FIRST_WAITING to 0.
+			 */
+			void setHelpFirstWaiting(bool enabled) {
+				helpFirstWaiting = enabled;
+			}
+
+			bool isHelpFirstWaiting() const {
+				return helpFirstWaiting.load(std::memory_order_relaxed);
+			}
+
+			/**
+			 * Obtains the split policy applied to tasks not specifying their own. The initial
+			 * policy may be selected through the SPLIT_POLICY environment variable (fixed,
+			 * lazy, or adaptive), fixed by default.
+			 */
+			const SplitPolicy& getSplitPolicy() const {
+				return *splitPolicy.load(std::memory_order_relaxed);
+			}
+
+			/**
+			 * Updates the default split policy. The policy must remain valid until
+			 * all tasks it may be applied to are completed.
+			 */
+			void setSplitPolicy(const SplitPolicy& policy) {
+				splitPolicy = &policy;
+			}
+
+			/**
+			 * Obtains the number of workers currently looking for work.
+			 */
+			int getNumIdleWorkers() const {
+				return numIdle.load(std::memory_order_relaxed);
+			}
+
+			/**
+			 * Obtains the number of workers currently parked.
+			 */
+			int getNumSleepingWorkers() const {
+				return numSleeping.load(std::memory_order_relaxed);
+			}
+
+			/**
+			 * Obtains a snapshot of the statistics of all workers.
+			 */
+			RuntimeStatistics getStatistics() const {
+				RuntimeStatistics res;
+				for(const auto& cur : workers) {
+					res.workers.push_back(cur->getStatistics());
+				}
+				return res;
+			}
+
 			void dumpState(std::ostream& out) {
 				for(const auto& cur : workers) {
 					cur->dumpState(out);
@@ -2616,18 +3871,64 @@ namespace reference {
 		protected:
 
 			friend Worker;
+			friend TaskBatch;
+
+			bool hasWork() const {
+				for(const auto& cur : workers) {
+					if (cur->hasWork()) return true;
+				}
+				return false;
+			}
+
+			void waitForWork(Worker& worker) {
+
+				// announce the intention to sleep
+				worker.parker.prepare();
+				numSleeping++;
+
+				// pairs with the fence in workAvailable -- the increment alone does not order the following loads
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+
+				// re-check for work that has been submitted in the mean-while
+				if (!worker.alive || hasWork()) {
+					if (worker.parker.cancel()) numSleeping--;
+					return;
+				}
 
-			void waitForWork(volatile bool& alive) {
-				std::unique_lock<std::mutex> lk(m);
-				if (!alive) return;
 				LOG_SCHEDULE("Going to sleep");
-				cv.wait(lk);
+				worker.parker.park();
 				LOG_SCHEDULE("Woken up again");
 			}
 
-			void workAvailable() {
-				// wake up all workers
-				cv.notify_all();
+			void workAvailable(std::size_t numTasks = 1, Worker* preferred = nullptr) {
+				workAvailable(numTasks, &preferred, (preferred) ? 1 : 0);
+			}
+
+			void workAvailable(std::size_t numTasks, Worker* const* preferred, std::size_t numPreferred) {
+
+				// make the new tasks visible before checking for sleeping workers
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (numSleeping.load(std::memory_order_relaxed) == 0) return;
+
+				// wake up the preferred workers first
+				for(std::size_t i=0; i<numPreferred; ++i) {
+					if (preferred[i]->parker.notify()) {
+						numSleeping--;
+						if (--numTasks == 0) return;
+					}
+				}
+
+				// wake up as many other workers as there are new tasks
+				auto numWorkers = workers.size();
+				auto start = wakeCursor.fetch_add(1, std::memory_order_relaxed);
+				for(std::size_t i=0; i<numWorkers && numTasks > 0; ++i) {
+					if (numSleeping.load(std::memory_order_relaxed) == 0) return;
+					Worker& cur = *workers[(start + i) % numWorkers];
+					if (cur.parker.notify()) {
+						numSleeping--;
+						--numTasks;
+					}
+				}
 			}
 
 		};
@@ -2642,27 +3943,17 @@ namespace reference {
 			// fix worker ID
 			setCurrentWorkerID(id);
 
-			// copy worker list
-			auto allWorkers = pool.getWorkers();
-
-			// a utility to add new steel targets
-			auto addStealTarget = [&](std::size_t idx) {
-				if (idx == id) return;
+			// create list of workers to steel from, closest first
+			const auto& allWorkers = pool.getWorkers();
+			for(auto idx : pool.getStealingOrder(id)) {
 				stealingOrder.push_back(allWorkers[idx]);
-			};
-
-			// create list of workers to steel from
-			auto numWorkers = allWorkers.size();
-			for(std::size_t d=1; d<numWorkers; ++d) {
-				addStealTarget((id + d) % numWorkers);
-				addStealTarget((id - d + numWorkers) % numWorkers);
 			}
 
 			// log creation of worker event
 			logProfilerEvent(ProfileLogEntry::createWorkerCreatedEntry());
 
 			// fix affinity
-			detail::fixAffinity(id);
+			detail::fixAffinity(pool.getCpu(id));
 
 			// register worker
 			setCurrentWorker(*this);
@@ -2671,32 +3962,55 @@ namespace reference {
 			while(alive) {
 
 				// count number of idle cycles
-				int idle_cycles = 0;
+				unsigned idle_cycles = 0;
+
+				// the start of the current idle phase
+				std::chrono::steady_clock::time_point idle_start;
 
 				// conduct a schedule step
 				while(alive && !schedule_step()) {
-					// increment idle counter
-					++idle_cycles;
+					// increment idle counter, register as idle on the first miss
+					if (idle_cycles++ == 0) {
+						pool.numIdle++;
+						idle_start = std::chrono::steady_clock::now();
+					}
 
-					// wait a moment
-					cpu_relax();
+					// spin for a while, then yield, and finally park this worker
+					auto spin_cycles = pool.getIdleSpinCycles();
+					if (idle_cycles <= spin_cycles) {
 
-					// if there was no work for quite some time
-					if(idle_cycles > 100000) {
+						// wait a moment
+						cpu_relax();
+
+					} else if (idle_cycles <= spin_cycles + pool.getIdleYieldCycles()) {
+
+						// let others work
+						std::this_thread::yield();
+
+					} else {
 
 						// report sleep event
 						logProfilerEvent(ProfileLogEntry::createWorkerSuspendedEntry());
 
 						// wait for work by putting thread to sleep
-						pool.waitForWork(alive);
+						auto park_start = std::chrono::steady_clock::now();
+						pool.waitForWork(*this);
+						statistics.numParked.add();
+						statistics.parkedTime.add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - park_start).count());
 
 						// report awakening
 						logProfilerEvent(ProfileLogEntry::createWorkerResumedEntry());
 
-						// reset cycles counter
-						idle_cycles = 0;
+						// reset cycles counter (but remain registered as idle)
+						idle_cycles = 1;
 					}
 				}
+
+				// no longer idle
+				if (idle_cycles > 0) {
+					pool.numIdle--;
+					statistics.idleTime.add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - idle_start).count());
+				}
 			}
 
 			// log worker termination event
@@ -2733,6 +4047,10 @@ namespace reference {
 			bool old = nestedContextFlag;
 			nestedContextFlag = true;
 
+			// tasks created by this task inherit its split policy and priority
+			SplitPolicyScope policyScope(task.getSplitPolicy());
+			TaskPriorityScope priorityScope(task.getPriority());
+
 			// process the task
 			if (task.isSplit()) {
 				task.run();
@@ -2741,6 +4059,9 @@ namespace reference {
 				__allscale_unused auto taskId = task.getId();
 				logProfilerEvent(ProfileLogEntry::createTaskStartedEntry(taskId));
 
+				// count processed tasks
+				statistics.tasksExecuted.add();
+
 				// check whether this run needs to be sampled
 				auto level = task.getDepth();
 				if (level == 0) {
@@ -2772,18 +4093,28 @@ namespace reference {
 			LOG_SCHEDULE("Finished task " << task);
 		}
 
-		inline bool Worker::splitTask(TaskBase& task) {
-			using namespace std::chrono_literals;
+		inline bool Worker::splitTask(TaskBase& task, bool stolen) {
 
-			// the threshold for estimated task to be split
-			static const auto taskTimeThreshold = CycleCount(3*1000*1000);
+			// only splitable tasks can be split
+			if (!task.isSplitable()) return false;
 
-			// only split the task if it is estimated to exceed a threshold
-			if (task.isSplitable() && (task.getDepth() == 0 || estimateRuntime(task) > taskTimeThreshold)) {
+			// collect the information for the split decision
+			SplitContext context;
+			context.depth = task.getDepth();
+			context.predictor = &task.getRuntimePredictor();
+			context.queueLength = queue.size();
+			context.stolen = stolen;
+			context.numIdleWorkers = pool.getNumIdleWorkers();
+			context.numWorkers = pool.getNumWorkers();
 
-				// split this task
-				return task.split();
+			// ask the task's policy, or the runtime's default
+			const SplitPolicy* policy = task.getSplitPolicy();
+			if (!policy) policy = &pool.getSplitPolicy();
 
+			// split the task if requested by the policy
+			if (policy->shouldSplit(context) && task.split()) {
+				statistics.tasksSplit.add();
+				return true;
 			}
 
 			// no split happend
@@ -2811,7 +4142,8 @@ namespace reference {
 				// if below this limit, split the task
 				if (task.isSplitable() && task.getDepth() < split_limit) {
 
-					// if splitting worked => we are done
+					// if splitting worked => we are done, the resulting tasks are distributed as a batch
+					TaskBatchScope batch;
 					if (task.split()) return;
 
 				}
@@ -2851,55 +4183,219 @@ namespace reference {
 				}
 			}
 
-			// add task to queue
-			LOG_SCHEDULE( "Queue size before: " << queue.size() );
-
 			// no task that is substituted shall be scheduled
 			assert_false(task.isSubstituted());
 
-			// add task to queue
-			queue.push_back(&task);
+			// add task to the queues of this worker
+			enqueue(task);
+		}
 
-			// signal available work
-			pool.workAvailable();
+		inline void Worker::enqueue(TaskBase& task) {
 
-			// log new queue length
-			LOG_SCHEDULE( "Queue size after: " << queue.size() );
+			// if the current thread is releasing a batch of tasks, add it to the batch
+			if (TaskBatch* batch = TaskBatch::getCurrent()) {
+				batch->add(*this,task);
+				return;
+			}
+
+			// add task to the queues of its priority band
+			TaskBase* tasks[] = { &task };
+			push(task.getPriority(),tasks,1);
 
+			// signal available work, preferably to this worker if submitted by another thread
+			if (isOwnerThread()) {
+				pool.workAvailable();
+			} else {
+				pool.workAvailable(1,this);
+			}
 		}
 
+		inline void Worker::push(TaskPriority priority, TaskBase* const* tasks, std::size_t n) {
 
-		inline bool Worker::schedule_step() {
+			// select the queues of the priority band, the normal band being the common case
+			switch(priority) {
+				case TaskPriority::Normal: push(queue,inbox,tasks,n); return;
+				case TaskPriority::High:   push(urgent.queue,urgent.inbox,tasks,n); return;
+				case TaskPriority::Low:    push(background.queue,background.inbox,tasks,n); return;
+			}
+			assert_fail() << "Invalid priority: " << priority;
+		}
 
-			// process a task from the local queue
-			if (TaskBase* t = queue.pop_front()) {
+		inline void Worker::push(TaskQueue& trgQueue, UnboundQueue<TaskBase*>& trgInbox, TaskBase* const* tasks, std::size_t n) {
 
-				// the task should not have a substitute
-				assert_false(t->isSubstituted());
+			// add tasks to queue
+			LOG_SCHEDULE( "Queue size before: " << trgQueue.size() );
 
-				// check precondition of task
-				assert_true(t->isReady()) << "Actual state: " << t->getState();
+			// add tasks to queue (only the owner may push to the work-stealing queue)
+			if (isOwnerThread()) {
+				trgQueue.push_front(tasks,n);
 
-				// if the queue is not full => create more tasks
-				if (queue.size() < (max_queue_length*3)/4) {
+				// track the queue length
+				statistics.queueHighWaterMark.updateMax(trgQueue.size());
 
-					LOG_SCHEDULE( "Splitting tasks @ queue size: " << queue.size() );
+			} else {
+				trgInbox.push_back(tasks,n);
+			}
 
+			// log new queue length
+			LOG_SCHEDULE( "Queue size after: " << trgQueue.size() );
 
+		}
 
-					// split task and be done
-					if (splitTask(*t)) return true;
 
-					// the task should not have a substitute
-					assert_false(t->isSubstituted());
+		inline void TaskBatch::flush() {
+
+			// nothing to do for an empty batch
+			if (size == 0) return;
+
+			// the workers receiving tasks from another thread, to be woken up first
+			Worker* preferred[capacity];
+			std::size_t numPreferred = 0;
+
+			// push the tasks targeting the same worker and priority band at once, in order
+			TaskBase* group[capacity];
+			for(std::size_t i=0; i<size; ++i) {
+				if (!entries[i].task) continue;
+
+				Worker& worker = *entries[i].worker;
+				TaskPriority priority = entries[i].task->getPriority();
 
+				std::size_t n = 0;
+				for(std::size_t j=i; j<size; ++j) {
+					if (entries[j].worker != &worker || !entries[j].task) continue;
+					if (entries[j].task->getPriority() != priority) continue;
+					group[n++] = entries[j].task;
+					entries[j].task = nullptr;
 				}
+				worker.push(priority,group,n);
+
+				if (!worker.isOwnerThread() && std::find(preferred, preferred + numPreferred, &worker) == preferred + numPreferred) {
+					preferred[numPreferred++] = &worker;
+				}
+			}
+
+			// signal the available work once for the entire batch
+			std::size_t numTasks = size;
+			size = 0;
+			WorkerPool::getInstance().workAvailable(numTasks,preferred,numPreferred);
+		}
+
+		inline TaskBase* Worker::popLocalTask() {
+
+			// high priority tasks are processed first
+			if (!urgent.empty()) {
+				if (TaskBase* t = popLocalTask(urgent)) return t;
+			}
+
+			// the owner processes its own queue first
+			if (isOwnerThread()) {
+				if (TaskBase* t = queue.pop_front()) return t;
+			} else {
+				if (TaskBase* t = queue.try_pop_back()) return t;
+			}
+
+			// then tasks submitted by other threads
+			if (!inbox.empty()) {
+				if (TaskBase* t = inbox.try_pop_front()) return t;
+			}
+
+			// low priority tasks only if there is nothing else to do
+			if (background.empty()) return nullptr;
+			return popLocalTask(background);
+		}
+
+		inline TaskBase* Worker::popLocalTask(PriorityBand& band) {
+			if (isOwnerThread()) {
+				if (TaskBase* t = band.queue.pop_front()) return t;
+			} else {
+				if (TaskBase* t = band.queue.try_pop_back()) return t;
+			}
+			if (band.inbox.empty()) return nullptr;
+			return band.inbox.try_pop_front();
+		}
+
+		inline TaskBase* Worker::stealTaskFrom(Worker& other) {
+
+			// high priority tasks first
+			if (!other.urgent.empty()) {
+				if (TaskBase* t = stealTaskFrom(other.urgent)) return t;
+			}
+
+			// steal from the top of the other's queue first
+			if (TaskBase* t = other.queue.try_pop_back()) return t;
+
+			// then from tasks not yet picked up by the other worker
+			if (!other.inbox.empty()) {
+				if (TaskBase* t = other.inbox.try_pop_back()) return t;
+			}
+
+			// low priority tasks last
+			if (other.background.empty()) return nullptr;
+			return stealTaskFrom(other.background);
+		}
+
+		inline TaskBase* Worker::stealTaskFrom(PriorityBand& band) {
+			if (TaskBase* t = band.queue.try_pop_back()) return t;
+			if (band.inbox.empty()) return nullptr;
+			return band.inbox.try_pop_back();
+		}
 
-				// process this task
-				runTask(*t);
+		inline void Worker::processTask(TaskBase& t, bool stolen) {
+
+			// the task should not have a substitute
+			assert_false(t.isSubstituted());
+
+			// temporary memory allocated while splitting or running the task is released afterwards
+			TaskArenaScope arenaScope;
+
+			// create more tasks if requested by the split policy
+			if (splitTask(t,stolen)) {
+				LOG_SCHEDULE( "Split task @ queue size: " << queue.size() );
+				return;
+			}
+
+			// the task should not have a substitute
+			assert_false(t.isSubstituted());
+
+			// process this task
+			runTask(t);
+		}
+
+		inline bool Worker::schedule_step() {
+
+			// tasks released by this thread must be visible before looking for work
+			if (TaskBatch* batch = TaskBatch::getCurrent()) batch->flush();
+
+			// process a task from the local queue
+			if (TaskBase* t = popLocalTask()) {
+
+				// check precondition of task
+				assert_true(t->isReady()) << "Actual state: " << t->getState();
+
+				// split or run the task
+				processTask(*t,false);
 				return true;
 			}
 
+			// high priority tasks of any worker are preferred over other tasks
+			for(const auto& cur : stealingOrder) {
+				if (cur->urgent.empty()) continue;
+				if (TaskBase* t = stealTaskFrom(cur->urgent)) {
+
+					// record the steal
+					statistics.stealsSucceeded.add();
+					logProfilerEvent(ProfileLogEntry::createTaskStolenEntry(t->getId()));
+
+					LOG_SCHEDULE( "Stolen high priority task: " << t );
+
+					processTask(*t,true);
+					return true;
+				}
+			}
+
+			// count failed steal attempts
+			std::uint64_t failed_steals = 0;
+
 			// look through potential targets to steel a task
 			for(const auto& cur : stealingOrder) {
 
@@ -2907,7 +4403,14 @@ namespace reference {
 				Worker& other = *cur;
 
 				// try to steal a task from another queue
-				if (TaskBase* t = other.queue.try_pop_back()) {
+				TaskBase* t = stealTaskFrom(other);
+				if (!t) {
+					++failed_steals;
+				} else {
+
+					// record the steal
+					statistics.stealsSucceeded.add();
+					if (failed_steals) statistics.stealsFailed.add(failed_steals);
 
 					// the task should not have a substitute
 					assert_false(t->isSubstituted());
@@ -2917,19 +4420,16 @@ namespace reference {
 
 					LOG_SCHEDULE( "Stolen task: " << t );
 
-					// split task the task (since there is not enough work in the queue)
-					if (splitTask(*t)) return true;
-
-					// the task should not have a substitute
-					assert_false(t->isSubstituted());
-
-					// process task
-					runTask(*t);
+					// split or run the task (since there is not enough work in the queue)
+					processTask(*t,true);
 					return true;	// successfully completed a task
 				}
 
 			}
 
+			// record the failed attempts
+			if (failed_steals) statistics.stealsFailed.add(failed_steals);
+
 			// no task found => wait a moment
 			cpu_relax();
 
@@ -2937,6 +4437,53 @@ namespace reference {
 			return false;
 		}
 
+		inline bool Worker::schedule_step(const TaskID& awaited) {
+
+			// tasks released by this thread must be visible before looking for work
+			if (TaskBatch* batch = TaskBatch::getCurrent()) batch->flush();
+
+			// without help-first waiting, any task may be processed
+			if (!pool.isHelpFirstWaiting()) return schedule_step();
+
+			// only the IDs recorded when queuing tasks are inspected, since unclaimed tasks may be
+			// processed and destroyed by other workers concurrently; the test is thus only a hint
+			auto contributes = [&](const TaskID& id) {
+				return id == awaited || awaited.isParentOf(id);
+			};
+
+			// the sub-tree of the awaited task is most likely found in the local queues
+			if (isOwnerThread()) {
+				if (!urgent.queue.empty()) {
+					if (TaskBase* t = urgent.queue.pop_front_if(contributes)) {
+						processTask(*t,false);
+						return true;
+					}
+				}
+				if (TaskBase* t = queue.pop_front_if(contributes)) {
+					processTask(*t,false);
+					return true;
+				}
+			}
+
+			// otherwise it may have been stolen by other workers
+			for(const auto& cur : stealingOrder) {
+				if (TaskBase* t = cur->queue.try_pop_back_if(contributes)) {
+
+					// record the steal
+					statistics.stealsSucceeded.add();
+					logProfilerEvent(ProfileLogEntry::createTaskStolenEntry(t->getId()));
+
+					LOG_SCHEDULE( "Stolen awaited task: " << t );
+
+					processTask(*t,true);
+					return true;
+				}
+			}
+
+			// fall back to any available work
+			return schedule_step();
+		}
+
 	}
 
 	namespace monitoring {
@@ -2967,7 +4514,8 @@ namespace reference {
 		// if below the initial split limit, split this task
 		if (!isOrphan() && getTaskFamily()->isTopLevel() && isSplitable() && getDepth() < runtime::WorkerPool::getInstance().getInitialSplitDepthLimit()) {
 
-			// attempt to split this task
+			// attempt to split this task, releasing the resulting tasks as a batch
+			runtime::TaskBatchScope batch;
 			split();
 
 		}
@@ -2996,6 +4544,10 @@ namespace reference {
 			// at this point this task must be done
 			assert_eq(State::Done,state);
 
+			// a treeture owning this task is responsible for destroying it; the exchange orders
+			// the final accesses of the treeture before the destruction, if performed here
+			if (retained.exchange(false, std::memory_order_acq_rel)) return;
+
 			// destroy this object, and be done
 			delete this;
 			return;
@@ -3039,9 +4591,10 @@ namespace reference {
 		assert_lt(State::New,state);
 
 		// wait until this task is finished
+		auto& worker = runtime::getCurrentWorker();
 		while(!isDone()) {
-			// make some progress
-			runtime::getCurrentWorker().schedule_step();
+			// make some progress, preferably on this task
+			worker.schedule_step(getId());
 		}
 	}
 
@@ -3050,9 +4603,11 @@ namespace reference {
 		// auto action = monitoring::log(monitoring::EventType::DependencyWait, TaskID(family->getId(),path));
 
 		// wait until the referenced task is done
+		auto& worker = runtime::getCurrentWorker();
+		TaskID awaited(familyId,path);
 		while(!isDone()) {
-			// but while doing so, do useful stuff
-			runtime::getCurrentWorker().schedule_step();
+			// but while doing so, do useful stuff, preferably contributing to the referenced task
+			worker.schedule_step(awaited);
 		}
 	}
 
@@ -3060,10 +4615,20 @@ namespace reference {
 
 		template<typename T>
 		void treeture_base<T>::wait() const {
+			// without a task reference, any progress is equally useful
+			if (!taskRef.valid()) {
+				while (!isDone()) {
+					runtime::getCurrentWorker().schedule_step();
+				}
+				return;
+			}
+
 			// wait for completion
-			while (promise && !promise->isReady()) {
-				// make some progress
-				runtime::getCurrentWorker().schedule_step();
+			auto& worker = runtime::getCurrentWorker();
+			TaskID awaited(taskRef.getFamilyId(),taskRef.getPath());
+			while (!isDone()) {
+				// make some progress, preferably on the awaited task
+				worker.schedule_step(awaited);
 			}
 		}
 
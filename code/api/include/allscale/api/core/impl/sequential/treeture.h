@@ -1,10 +1,14 @@
 #pragma once
 
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "allscale/utils/assert.h"
 #include "allscale/utils/printer/arrays.h"
 
+#include "allscale/api/core/impl/when_any_result.h"
+
 namespace allscale {
 namespace api {
 namespace core {
@@ -370,6 +374,69 @@ namespace sequential {
 	}
 
 
+	// -- continuations --
+
+	/**
+	 * The result of a when_any operation on treetures of this implementation.
+	 */
+	template<typename T>
+	using when_any_result = impl::when_any_result<treeture<T>>;
+
+	namespace detail {
+
+		// calls a continuation with the value of a treeture, consuming the value
+		template<typename T>
+		struct continuation_call {
+			template<typename Op>
+			auto operator()(Op& op, treeture<T>&& treeture) const {
+				return op(std::move(treeture).get());
+			}
+		};
+
+		template<>
+		struct continuation_call<void> {
+			template<typename Op>
+			auto operator()(Op& op, treeture<void>&&) const {
+				return op();
+			}
+		};
+
+	}
+
+	template<typename T, typename Op>
+	auto then(treeture<T>&& pred, Op&& op) {
+		// the value is already there, so the continuation is processed right away
+		return make_treeture([&]() {
+			return detail::continuation_call<T>()(op,std::move(pred));
+		});
+	}
+
+	template<typename ... Ts>
+	treeture<std::tuple<Ts...>> when_all(treeture<Ts>&& ... treetures) {
+		return treeture<std::tuple<Ts...>>(std::tuple<Ts...>(std::move(treetures).get()...));
+	}
+
+	template<typename T>
+	treeture<std::vector<T>> when_all(std::vector<treeture<T>>&& treetures) {
+		std::vector<T> res;
+		res.reserve(treetures.size());
+		for(auto& cur : treetures) {
+			res.push_back(std::move(cur).get());
+		}
+		return treeture<std::vector<T>>(std::move(res));
+	}
+
+	inline treeture<void> when_all(std::vector<treeture<void>>&&) {
+		return treeture<void>();
+	}
+
+	template<typename T>
+	treeture<when_any_result<T>> when_any(std::vector<treeture<T>>&& treetures) {
+		// all treetures are completed, so the first one is picked
+		return treeture<when_any_result<T>>(when_any_result<T>{ 0, std::move(treetures) });
+	}
+
+
 } // end namespace sequential
 } // end namespace impl
 } // end namespace core
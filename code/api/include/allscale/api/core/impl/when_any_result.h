@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace allscale {
+namespace api {
+namespace core {
+namespace impl {
+
+	/**
+	 * The result of a when_any operation: the index of the first completed treeture,
+	 * and all the treetures passed to the operation. Shared by all implementations,
+	 * which only differ in the type of treetures.
+	 */
+	template<typename Treeture>
+	struct when_any_result {
+		std::size_t index;
+		std::vector<Treeture> treetures;
+	};
+
+} // end namespace impl
+} // end namespace core
+} // end namespace api
+} // end namespace allscale
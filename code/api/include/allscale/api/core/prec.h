@@ -282,13 +282,13 @@ namespace core {
 				rec_defs<Defs...> defs;
 
 				auto operator()(impl::sequential::dependencies&& deps, const I& in) const {
-					return impl::sequential::make_lazy_unreleased_treeture([=]() mutable {
+					return impl::sequential::make_lazy_unreleased_treeture([this,deps,in]() mutable {
 						return defs.template sequentialCall<i,O,I>(std::move(deps),in);
 					});
 				}
 
 				auto operator()(const I& in) const {
-					return impl::sequential::make_lazy_unreleased_treeture([=](){
+					return impl::sequential::make_lazy_unreleased_treeture([this,in](){
 						return defs.template sequentialCall<i,O,I>(impl::sequential::dependencies(),in);
 					});
 				}
@@ -426,18 +426,51 @@ namespace core {
 
 			rec_defs<Defs...> defs;
 
+			// the policy for splitting the tasks of this operation, null for the runtime's default
+			const impl::reference::SplitPolicy* splitPolicy = nullptr;
+
+			// the priority of the tasks of this operation, if not set inherited from the caller
+			bool prioritized = false;
+			impl::reference::TaskPriority priority = impl::reference::TaskPriority::Normal;
+
+			/**
+			 * Creates a version of this operation utilizing the given split policy for all its tasks.
+			 * The policy must remain valid until all started computations are completed.
+			 */
+			prec_operation withSplitPolicy(const impl::reference::SplitPolicy& policy) const {
+				return prec_operation{defs,&policy,prioritized,priority};
+			}
+
+			/**
+			 * Creates a version of this operation scheduling all its tasks with the given priority.
+			 */
+			prec_operation withPriority(impl::reference::TaskPriority p) const {
+				return prec_operation{defs,splitPolicy,true,p};
+			}
+
 			template<typename DepsKind>
 			treeture<O> operator()(impl::reference::dependencies<DepsKind>&& deps, const I& in) {
+				impl::reference::SplitPolicyScope policyScope(splitPolicy);
+				impl::reference::TaskPriorityScope priorityScope(getPriority());
 				return defs.template parallelCall<true,i,O,I>(std::move(deps),in);
 			}
 
 			treeture<O> operator()(core::no_dependencies&&, const I& in) {
+				impl::reference::SplitPolicyScope policyScope(splitPolicy);
+				impl::reference::TaskPriorityScope priorityScope(getPriority());
 				return defs.template parallelCall<true,i,O,I>(impl::reference::after(),in);
 			}
 
 			treeture<O> operator()(const I& in) {
 				return (*this)(after(),in);
 			}
+
+		private:
+
+			impl::reference::TaskPriority getPriority() const {
+				return prioritized ? priority : impl::reference::getCurrentTaskPriority();
+			}
+
 		};
 
 
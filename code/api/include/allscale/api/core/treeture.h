@@ -1,6 +1,7 @@
 #pragma once
 
 #include <utility>
+#include <vector>
 
 /**
  * This header file formalizes the general, public interface of treetures, independent
@@ -434,6 +435,33 @@ namespace core {
 	}
 
 
+	// --- continuations ---
+
+	/**
+	 * The result of a when_any operation: the index of the first completed treeture,
+	 * and all the treetures passed to the operation. The implementation is selected
+	 * through the treeture template, like for the treetures passed to when_any.
+	 */
+	template<typename T, template<typename> class Treeture = treeture>
+	using when_any_result = impl::when_any_result<Treeture<T>>;
+
+
+	// the operators are provided by the implementations, and equally found through
+	// argument dependent lookup; the using declarations make them available as core::*
+
+	// -- sequential --
+
+	using impl::sequential::then;
+	using impl::sequential::when_all;
+	using impl::sequential::when_any;
+
+	// -- reference --
+
+	using impl::reference::then;
+	using impl::reference::when_all;
+	using impl::reference::when_any;
+
+
 } // end namespace core
 } // end namespace api
 } // end namespace allscale
@@ -1,6 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
 #include <utility>
+#include <vector>
 
 // stuff we need to include before (the intercepted) prec.h gets included
 #include "allscale/utils/assert.h"
@@ -142,6 +150,68 @@ namespace algorithm {
 	detail::loop_reference<Iter> pforWithBoundary(const detail::range<Iter>& r, const InnerBody& innerBody, const BoundaryBody& boundaryBody, const no_dependencies& = no_dependencies());
 
 
+	// ---------------------------------------------------------------------------------------------
+	//									Row-wise pfor Operators
+	// ---------------------------------------------------------------------------------------------
+
+	/**
+	 * The generic version of all parallel loops processing their range row by row with synchronization dependencies.
+	 * Instead of individual points, the body is handed the first point and the length of each contiguous section of
+	 * the range along its innermost dimension, such that it may process those in tight, vectorizable inner loops.
+	 *
+	 * @tparam Iter the type of the iterator to pass over
+	 * @tparam Body the type of the body operation, thus the operation to be applied on each row in the given range
+	 * @tparam Dependency the type of the dependencies to be enforced
+	 *
+	 * @param r the range to iterate over
+	 * @param body the operation to be applied on each row of the given range, accepting the first point and the length of a row
+	 * @param dependency the dependencies to be obeyed when scheduling the iterations of this parallel loop
+	 *
+	 * @return a reference to the iterations of the processed parallel loop to be utilized for forming dependencies
+	 */
+	template<typename Iter, typename Body, typename Dependency>
+	detail::loop_reference<Iter> pforRows(const detail::range<Iter>& r, const Body& body, const Dependency& dependency);
+
+	/**
+	 * The generic version of all parallel loops processing their range row by row without synchronization dependencies.
+	 *
+	 * @tparam Iter the type of the iterator to pass over
+	 * @tparam Body the type of the body operation, thus the operation to be applied on each row in the given range
+	 *
+	 * @param r the range to iterate over
+	 * @param body the operation to be applied on each row of the given range, accepting the first point and the length of a row
+	 *
+	 * @return a reference to the iterations of the processed parallel loop to be utilized for forming dependencies
+	 */
+	template<typename Iter, typename Body>
+	detail::loop_reference<Iter> pforRows(const detail::range<Iter>& r, const Body& body, const no_dependencies& = no_dependencies());
+
+
+	// ---------------------------------------------------------------------------------------------
+	//									Temporally Tiled pfor Operators
+	// ---------------------------------------------------------------------------------------------
+
+	/**
+	 * A parallel loop processing a sequence of time steps over the given range, producing the same result as a chain of
+	 * pfor operations synchronized by a full_neighborhood_sync of the given radius. Instead of sweeping through the
+	 * entire range once per time step, the range is decomposed into cache-sized tiles processing several time steps each.
+	 * Tiles shrink by the given radius per time step, such that they can be processed independently, while the remaining
+	 * gaps are filled by growing tiles in subsequent phases.
+	 *
+	 * @tparam radius the maximum distance, in each dimension, of the points of the previous time step read by the body
+	 * @tparam Iter the type of the iterator to pass over, an integer or a vector of integers
+	 * @tparam Body the type of the body operation, thus the operation to be applied on each point in each time step
+	 *
+	 * @param r the range to iterate over
+	 * @param steps the number of time steps to be processed
+	 * @param body the operation to be applied on each point of the given range, accepting the time step and the point
+	 *
+	 * @return a reference to the iterations of the processed parallel loop to be utilized for forming dependencies
+	 */
+	template<std::size_t radius = 1, typename Iter, typename Body>
+	detail::loop_reference<Iter> pforTiled(const detail::range<Iter>& r, std::size_t steps, const Body& body);
+
+
 	// ---------------------------------------------------------------------------------------------
 	//									The after Utility
 	// ---------------------------------------------------------------------------------------------
@@ -289,6 +359,73 @@ namespace algorithm {
 		return pfor(utils::Vector<Elem,Dims>(0),a,body,dependencies);
 	}
 
+	// ---- row-wise loops ----
+
+	template<typename Iter, typename Body>
+	detail::loop_reference<Iter> pforRows(const Iter& a, const Iter& b, const Body& body) {
+		return pforRows(detail::range<Iter>(a,b),body);
+	}
+
+	template<typename Iter, typename Body, typename Dependency>
+	detail::loop_reference<Iter> pforRows(const Iter& a, const Iter& b, const Body& body, const Dependency& dependency) {
+		return pforRows(detail::range<Iter>(a,b),body,dependency);
+	}
+
+	/**
+	 * A parallel loop iterating over the rows of the hyper-box limited by the given vectors.
+	 */
+	template<typename Elem, size_t dims, typename Body>
+	detail::loop_reference<utils::Vector<Elem,dims>> pforRows(const utils::Vector<Elem,dims>& a, const utils::Vector<Elem,dims>& b, const Body& body) {
+		return pforRows(detail::range<utils::Vector<Elem,dims>>(a,b),body);
+	}
+
+	/**
+	 * A parallel loop iterating over the rows of the hyper-box limited by the given vectors. Optional dependencies may be passed.
+	 */
+	template<typename Elem, size_t dims, typename Body, typename Dependencies>
+	detail::loop_reference<utils::Vector<Elem,dims>> pforRows(const utils::Vector<Elem,dims>& a, const utils::Vector<Elem,dims>& b, const Body& body, const Dependencies& dependencies) {
+		return pforRows(detail::range<utils::Vector<Elem,dims>>(a,b),body,dependencies);
+	}
+
+	/**
+	 * A parallel loop iterating over the rows of the hyper-box limited by the given vector.
+	 */
+	template<typename Elem, size_t Dims, typename Body>
+	auto pforRows(const utils::Vector<Elem,Dims>& a, const Body& body) {
+		return pforRows(utils::Vector<Elem,Dims>(0),a,body);
+	}
+
+	/**
+	 * A parallel loop iterating over the rows of the hyper-box limited by the given vector. Optional dependencies may be passed.
+	 */
+	template<typename Elem, size_t Dims, typename Body, typename Dependencies>
+	auto pforRows(const utils::Vector<Elem,Dims>& a, const Body& body, const Dependencies& dependencies) {
+		return pforRows(utils::Vector<Elem,Dims>(0),a,body,dependencies);
+	}
+
+	// ---- temporally tiled loops ----
+
+	template<std::size_t radius = 1, typename Iter, typename Body>
+	detail::loop_reference<Iter> pforTiled(const Iter& a, const Iter& b, std::size_t steps, const Body& body) {
+		return pforTiled<radius>(detail::range<Iter>(a,b),steps,body);
+	}
+
+	/**
+	 * A parallel loop processing the given number of time steps on the hyper-box limited by the given vectors.
+	 */
+	template<std::size_t radius = 1, typename Elem, size_t dims, typename Body>
+	detail::loop_reference<utils::Vector<Elem,dims>> pforTiled(const utils::Vector<Elem,dims>& a, const utils::Vector<Elem,dims>& b, std::size_t steps, const Body& body) {
+		return pforTiled<radius>(detail::range<utils::Vector<Elem,dims>>(a,b),steps,body);
+	}
+
+	/**
+	 * A parallel loop processing the given number of time steps on the hyper-box limited by the given vector.
+	 */
+	template<std::size_t radius = 1, typename Elem, size_t Dims, typename Body>
+	auto pforTiled(const utils::Vector<Elem,Dims>& a, std::size_t steps, const Body& body) {
+		return pforTiled<radius>(utils::Vector<Elem,Dims>(0),a,steps,body);
+	}
+
 	// -------------------------------------------------------------------------------------------
 	//								Adaptive Synchronization
 	// -------------------------------------------------------------------------------------------
@@ -594,45 +731,29 @@ namespace algorithm {
 			}
 		}
 
-		template<typename Point>
-		struct point_factory;
-
-		template<typename Iter, size_t dims>
-		struct point_factory<std::array<Iter,dims>> {
-			template<typename ... Coordinates>
-			std::array<Iter,dims> operator()(Coordinates ... coordinates) {
-				return { { coordinates ... } };
-			}
-		};
-
-		template<typename Iter, size_t dims>
-		struct point_factory<utils::Vector<Iter,dims>> {
-			template<typename ... Coordinates>
-			utils::Vector<Iter,dims> operator()(Coordinates ... coordinates) {
-				return utils::Vector<Iter,dims>(coordinates...);
-			}
-		};
-
-
 		template<size_t idx>
-		struct scanner {
-			scanner<idx-1> nested;
-			template<template<typename T, size_t d> class Compound, typename Iter, size_t dims, typename Op, typename ... Coordinates>
-			void run(const Compound<Iter,dims>& begin, const Compound<Iter,dims>& end, const Op& op, Coordinates ... coordinates) {
+		struct row_scanner {
+			row_scanner<idx-1> nested;
+			template<template<typename T, size_t d> class Compound, typename Iter, size_t dims, typename Op>
+			void run(const Compound<Iter,dims>& begin, const Compound<Iter,dims>& end, Compound<Iter,dims>& cur, const Op& op) {
 				auto a = begin[dims-idx];
 				auto b = end[dims-idx];
 				for(Iter i = a; i != b ; ++i) {
-					nested.run(begin,end,op,coordinates...,i);
+					cur[dims-idx] = i;
+					nested.run(begin,end,cur,op);
 				}
 			}
 		};
 
 		template<>
-		struct scanner<0> {
-			template<template<typename T, size_t d> class Compound, typename Iter, size_t dims, typename Op, typename ... Coordinates>
-			void run(const Compound<Iter,dims>&, const Compound<Iter,dims>&, const Op& op, Coordinates ... coordinates) {
-				point_factory<Compound<Iter,dims>> factory;
-				op(factory(coordinates...));
+		struct row_scanner<1> {
+			template<template<typename T, size_t d> class Compound, typename Iter, size_t dims, typename Op>
+			void run(const Compound<Iter,dims>& begin, const Compound<Iter,dims>& end, Compound<Iter,dims>& cur, const Op& op) {
+				auto a = begin[dims-1];
+				auto b = end[dims-1];
+				if (a == b) return;
+				cur[dims-1] = a;
+				op(static_cast<const Compound<Iter,dims>&>(cur),std::size_t(b-a));
 			}
 		};
 
@@ -744,10 +865,42 @@ namespace algorithm {
 			detail::scanner_with_boundary<dims>().run_mixed(begin, end, inner, boundary);
 		}
 
+		template<typename Iter, typename Op>
+		void forEachRow(const Iter& a, const Iter& b, const Op& op) {
+			if (a == b) return;
+			op(a,std::size_t(b-a));
+		}
+
+		template<typename Iter, size_t dims, typename Op>
+		void forEachRow(const std::array<Iter,dims>& begin, const std::array<Iter,dims>& end, const Op& op) {
+			// scan range row by row
+			std::array<Iter,dims> cur = begin;
+			detail::row_scanner<dims>().run(begin, end, cur, op);
+		}
+
+		template<typename Elem, size_t dims, typename Op>
+		void forEachRow(const utils::Vector<Elem,dims>& begin, const utils::Vector<Elem,dims>& end, const Op& op) {
+			// scan range row by row
+			utils::Vector<Elem,dims> cur = begin;
+			detail::row_scanner<dims>().run(begin, end, cur, op);
+		}
+
+		template<typename Point, typename Op>
+		void forEachInRows(const Point& begin, const Point& end, const Op& op) {
+			// process the points of each row by incrementing the innermost coordinate
+			forEachRow(begin, end, [&](const Point& start, std::size_t length) {
+				Point cur = start;
+				auto& i = cur[dimensions<Point>::value-1];
+				for(std::size_t j = 0; j < length; ++j, ++i) {
+					op(static_cast<const Point&>(cur));
+				}
+			});
+		}
+
 		template<typename Iter, size_t dims, typename Op>
 		void forEach(const std::array<Iter,dims>& begin, const std::array<Iter,dims>& end, const Op& op) {
 			// scan range
-			detail::scanner<dims>().run(begin, end, op);
+			forEachInRows(begin, end, op);
 		}
 
 		template<typename Elem, size_t dims, typename InnerOp, typename BoundaryOp>
@@ -766,7 +919,7 @@ namespace algorithm {
 		template<typename Elem, size_t dims, typename Op>
 		void forEach(const utils::Vector<Elem,dims>& begin, const utils::Vector<Elem,dims>& end, const Op& op) {
 			// scan range
-			detail::scanner<dims>().run(begin, end, op);
+			forEachInRows(begin, end, op);
 		}
 
 
@@ -828,6 +981,76 @@ namespace algorithm {
 			return fragments<Iter>{ left, right };
 		}
 
+		/**
+		 * The order in which the dimensions of the ranges of a loop are bisected. By default, dimensions
+		 * are split in turn. Alternatively, longer dimensions may be split ahead of the others, such that
+		 * sub-ranges approach cubes with a minimal surface-to-volume ratio. A plan is fixed per loop, such
+		 * that all sub-ranges on the same recursion depth are split along the same dimension.
+		 */
+		template<typename Iter>
+		struct split_plan {
+
+			static split_plan longest(const Iter&, const Iter&) {
+				return {};
+			}
+
+			std::size_t getSplitDimension(std::size_t) const {
+				return 0;
+			}
+		};
+
+		template<
+			template<typename I, size_t d> class Container,
+			typename Iter, size_t dims
+		>
+		struct split_plan<Container<Iter,dims>> {
+
+			// the number of splits each dimension is considered to be ahead of the others
+			std::array<std::uint8_t,dims> lead;
+
+			split_plan() : lead() {}
+
+			/**
+			 * Creates a plan splitting the longest dimensions of the given range first.
+			 */
+			static split_plan longest(const Container<Iter,dims>& begin, const Container<Iter,dims>& end) {
+				split_plan res;
+				double max = 1;
+				for(size_t i=0; i<dims; ++i) {
+					max = std::max(max, double(end[i] - begin[i]));
+				}
+				for(size_t i=0; i<dims; ++i) {
+					double extent = std::max(1.0, double(end[i] - begin[i]));
+					res.lead[i] = (std::uint8_t)std::min(255.0, std::floor(std::log2(max / extent)));
+				}
+				return res;
+			}
+
+			std::size_t getSplitDimension(std::size_t depth) const {
+
+				// the splits leading to equally balanced dimensions
+				std::uint8_t max = *std::max_element(lead.begin(), lead.end());
+				std::size_t prefix = 0;
+				for(const auto& cur : lead) prefix += max - cur;
+
+				// beyond those, dimensions are split in turn
+				if (depth >= prefix) return (depth - prefix) % dims;
+
+				// replay the splits up to the given depth, always splitting the dimension split the least
+				std::array<std::size_t,dims> level;
+				for(size_t i=0; i<dims; ++i) level[i] = lead[i];
+				std::size_t res = 0;
+				for(std::size_t d=0; d<=depth; ++d) {
+					res = 0;
+					for(size_t i=1; i<dims; ++i) {
+						if (level[i] < level[res]) res = i;
+					}
+					level[res]++;
+				}
+				return res;
+			}
+		};
+
 		template<typename Iter>
 		struct range_spliter;
 
@@ -892,8 +1115,8 @@ namespace algorithm {
 				return grow(*this, -steps);
 			}
 
-			fragments<Iter> split(std::size_t depth) const {
-				return range_spliter<Iter>::split(depth,*this);
+			fragments<Iter> split(std::size_t depth, const split_plan<Iter>& plan = split_plan<Iter>()) const {
+				return range_spliter<Iter>::split(depth,*this,plan);
 			}
 
 			template<typename Op>
@@ -901,6 +1124,15 @@ namespace algorithm {
 				detail::forEach(_begin,_end,op);
 			}
 
+			/**
+			 * Processes this range row by row, passing the first point and the length of each
+			 * contiguous section along the innermost dimension to the given operation.
+			 */
+			template<typename Op>
+			void forEachRow(const Op& op) const {
+				detail::forEachRow(_begin,_end,op);
+			}
+
 			template<typename InnerOp, typename BoundaryOp>
 			void forEachWithBoundary(const range& full, const InnerOp& inner, const BoundaryOp& boundary) const {
 				detail::forEach(full._begin,full._end,_begin,_end,inner,boundary);
@@ -917,16 +1149,12 @@ namespace algorithm {
 
 			using rng = range<Iter>;
 
-			static fragments<Iter> split(std::size_t, const rng& r) {
+			static fragments<Iter> split(std::size_t, const rng& r, const split_plan<Iter>& = split_plan<Iter>()) {
 				const auto& a = r.begin();
 				const auto& b = r.end();
 				auto m = a + (b - a)/2;
 				return make_fragments(rng(a,m),rng(m,b));
 			}
-
-			static std::size_t getSplitDimension(std::size_t) {
-				return 0;
-			}
 		};
 
 		template<
@@ -937,18 +1165,18 @@ namespace algorithm {
 
 			using rng = range<Container<Iter,dims>>;
 
-			static fragments<Container<Iter,dims>> split(std::size_t depth, const rng& r) {
+			static fragments<Container<Iter,dims>> split(std::size_t depth, const rng& r, const split_plan<Container<Iter,dims>>& plan = split_plan<Container<Iter,dims>>()) {
 
 				__allscale_unused const auto volume = detail::volume<Container<Iter,dims>>();
 
 				// get split dimension
-				auto splitDim = getSplitDimension(depth);
+				auto splitDim = plan.getSplitDimension(depth);
 
 				// compute range fragments
 				const auto& begin = r.begin();
 				const auto& end = r.end();
 
-				// split the longest dimension, keep the others as they are
+				// split the selected dimension, keep the others as they are
 				auto midA = end;
 				auto midB = begin;
 				midA[splitDim] = midB[splitDim] = range_spliter<Iter>::split(depth,range<Iter>(begin[splitDim],end[splitDim])).left.end();
@@ -960,10 +1188,6 @@ namespace algorithm {
 				return make_fragments(rng(begin,midA),rng(midB,end));
 			}
 
-			static std::size_t getSplitDimension(std::size_t depth) {
-				return depth % dims;
-			}
-
 		};
 
 	} // end namespace detail
@@ -976,6 +1200,9 @@ namespace algorithm {
 
 	namespace detail {
 
+		template<typename Iter>
+		struct iteration_fragments;
+
 		/**
 		 * An entity to reference ranges of iterations of a loop.
 		 */
@@ -997,10 +1224,15 @@ namespace algorithm {
 			 */
 			std::size_t depth;
 
+			/**
+			 * The order in which the referenced loop split its range.
+			 */
+			split_plan<Iter> plan;
+
 		public:
 
-			iteration_reference(const range<Iter>& range, const core::task_reference& handle, std::size_t depth)
-				: _range(range), handle(handle), depth(depth) {}
+			iteration_reference(const range<Iter>& range, const core::task_reference& handle, std::size_t depth, const split_plan<Iter>& plan = split_plan<Iter>())
+				: _range(range), handle(handle), depth(depth), plan(plan) {}
 
 			iteration_reference(const range<Iter>& _range = range<Iter>()) : _range(_range), depth(0) {}
 
@@ -1015,11 +1247,23 @@ namespace algorithm {
 			}
 
 			iteration_reference<Iter> getLeft() const {
-				return { range_spliter<Iter>::split(depth,_range).left, handle.getLeft(), depth+1 };
+				return { _range.split(depth,plan).left, handle.getLeft(), depth+1, plan };
 			}
 
 			iteration_reference<Iter> getRight() const {
-				return { range_spliter<Iter>::split(depth,_range).right, handle.getRight(), depth+1 };
+				return { _range.split(depth,plan).right, handle.getRight(), depth+1, plan };
+			}
+
+			/**
+			 * Obtains references to both halves of the referenced iterations, splitting the range only once.
+			 * Empty ranges, e.g. neighbors beyond the boundary of a loop, are not split at all.
+			 */
+			iteration_fragments<Iter> split() const {
+				if (_range.empty()) {
+					return { { _range, handle.getLeft(), depth+1, plan }, { _range, handle.getRight(), depth+1, plan } };
+				}
+				auto fragments = _range.split(depth,plan);
+				return { { fragments.left, handle.getLeft(), depth+1, plan }, { fragments.right, handle.getRight(), depth+1, plan } };
 			}
 
 			operator core::task_reference() const {
@@ -1037,6 +1281,26 @@ namespace algorithm {
 			std::size_t getDepth() const {
 				return depth;
 			}
+
+			const split_plan<Iter>& getSplitPlan() const {
+				return plan;
+			}
+
+			/**
+			 * Obtains the dimension along which the referenced range got split.
+			 */
+			std::size_t getSplitDimension() const {
+				return plan.getSplitDimension(depth);
+			}
+		};
+
+		/**
+		 * The references to the two halves of the iterations referenced by an iteration reference.
+		 */
+		template<typename Iter>
+		struct iteration_fragments {
+			iteration_reference<Iter> left;
+			iteration_reference<Iter> right;
 		};
 
 
@@ -1049,8 +1313,8 @@ namespace algorithm {
 
 		public:
 
-			loop_reference(const range<Iter>& range, core::treeture<void>&& handle)
-				: iteration_reference<Iter>(range, std::move(handle), 0) {}
+			loop_reference(const range<Iter>& range, core::treeture<void>&& handle, const split_plan<Iter>& plan = split_plan<Iter>())
+				: iteration_reference<Iter>(range, std::move(handle), 0, plan) {}
 
 			loop_reference() {};
 			loop_reference(const loop_reference&) = delete;
@@ -1067,6 +1331,315 @@ namespace algorithm {
 
 
 
+	// ---------------------------------------------------------------------------------------------
+	//									Loop Partitioning
+	// ---------------------------------------------------------------------------------------------
+
+	/**
+	 * A partitioner determines the size of the ranges of iterations processed sequentially by a single
+	 * task of a parallel loop. By default, ranges may be decomposed down to individual iterations, which
+	 * only pays off for expensive loop bodies. For cheap bodies, a coarser partition keeps the task
+	 * overhead low and leaves tight inner loops to the compiler.
+	 */
+	class loop_partitioner {
+
+	public:
+
+		enum class Kind {
+			Fixed,			// < ranges are split until they contain at most a given number of iterations
+			Automatic,		// < ranges are split until their predicted execution time drops below a target
+			Static			// < ranges are split into about one chunk of iterations per worker
+		};
+
+	private:
+
+		Kind kind;
+
+		// the maximum number of iterations of a sequentially processed range, for fixed partitions
+		std::size_t grain;
+
+		// the targeted execution time of sequentially processed ranges, for automatic partitions
+		std::chrono::nanoseconds target;
+
+	public:
+
+		loop_partitioner(Kind kind = Kind::Fixed, std::size_t grain = 1, std::chrono::nanoseconds target = std::chrono::nanoseconds::zero())
+			: kind(kind), grain(std::max<std::size_t>(grain,1)), target(target) {}
+
+		Kind getKind() const {
+			return kind;
+		}
+
+		std::size_t getGrainSize() const {
+			return grain;
+		}
+
+		std::chrono::nanoseconds getTargetTime() const {
+			return target;
+		}
+
+		friend std::ostream& operator<<(std::ostream& out, const loop_partitioner& p) {
+			switch(p.kind) {
+				case Kind::Fixed:     return out << "fixed(" << p.grain << ")";
+				case Kind::Automatic: return out << "auto(" << p.target.count() << "ns)";
+				case Kind::Static:    return out << "static";
+			}
+			return out << "invalid";
+		}
+
+	};
+
+	/**
+	 * Creates a partitioner processing ranges of up to the given number of iterations sequentially.
+	 */
+	inline loop_partitioner fixed_grain(std::size_t grain) {
+		return { loop_partitioner::Kind::Fixed, grain };
+	}
+
+	/**
+	 * Creates a partitioner adapting the size of sequentially processed ranges of each loop body to the
+	 * given target execution time, based on the times measured for previous ranges of the same body.
+	 */
+	inline loop_partitioner auto_grain(std::chrono::nanoseconds target = std::chrono::microseconds(50)) {
+		return { loop_partitioner::Kind::Automatic, 1, target };
+	}
+
+	/**
+	 * Creates a partitioner dividing the iterations of a loop up-front into about one chunk per worker,
+	 * similar to OpenMP's static schedule.
+	 */
+	inline loop_partitioner static_partition() {
+		return { loop_partitioner::Kind::Static };
+	}
+
+	namespace detail {
+
+		inline loop_partitioner& getCurrentLoopPartitionerRef() {
+			static thread_local loop_partitioner partitioner;
+			return partitioner;
+		}
+
+	}
+
+	/**
+	 * Obtains the partitioner applied to parallel loops started by the current thread.
+	 */
+	inline const loop_partitioner& getCurrentLoopPartitioner() {
+		return detail::getCurrentLoopPartitionerRef();
+	}
+
+	/**
+	 * A scope within which parallel loops started by the current thread are partitioned by the given
+	 * partitioner. The partitioner is fixed when a loop is started, loops started by its iterations
+	 * on other threads are not affected.
+	 */
+	class loop_partitioner_scope {
+
+		loop_partitioner old;
+
+	public:
+
+		loop_partitioner_scope(const loop_partitioner& partitioner) : old(getCurrentLoopPartitioner()) {
+			detail::getCurrentLoopPartitionerRef() = partitioner;
+		}
+
+		loop_partitioner_scope(const loop_partitioner_scope&) = delete;
+		loop_partitioner_scope& operator=(const loop_partitioner_scope&) = delete;
+
+		~loop_partitioner_scope() {
+			detail::getCurrentLoopPartitionerRef() = old;
+		}
+
+	};
+
+	/**
+	 * The order in which parallel loops traverse their iteration space.
+	 */
+	enum class loop_traversal {
+		Lexicographic,		// < ranges are bisected along their dimensions in turn, points are visited in scan order
+		SpaceFilling		// < ranges are bisected along their longest dimension, points are visited in blocks along a Z-order curve
+	};
+
+	namespace detail {
+
+		inline loop_traversal& getCurrentLoopTraversalRef() {
+			static thread_local loop_traversal traversal = loop_traversal::Lexicographic;
+			return traversal;
+		}
+
+	}
+
+	/**
+	 * Obtains the traversal order of parallel loops started by the current thread.
+	 */
+	inline loop_traversal getCurrentLoopTraversal() {
+		return detail::getCurrentLoopTraversalRef();
+	}
+
+	/**
+	 * A scope within which parallel loops started by the current thread traverse their iteration
+	 * space in the given order. Like partitioners, the order is fixed when a loop is started.
+	 */
+	class loop_traversal_scope {
+
+		loop_traversal old;
+
+	public:
+
+		loop_traversal_scope(loop_traversal traversal) : old(getCurrentLoopTraversal()) {
+			detail::getCurrentLoopTraversalRef() = traversal;
+		}
+
+		loop_traversal_scope(const loop_traversal_scope&) = delete;
+		loop_traversal_scope& operator=(const loop_traversal_scope&) = delete;
+
+		~loop_traversal_scope() {
+			detail::getCurrentLoopTraversalRef() = old;
+		}
+
+	};
+
+	namespace detail {
+
+		/**
+		 * The average execution time of a single iteration of a loop body, derived from the times
+		 * measured for sequentially processed ranges. Since those are weighted by their number of
+		 * iterations, estimates are independent of the sizes of the loops the body is used in.
+		 */
+		class iteration_cost {
+
+			using clock = core::impl::reference::CycleClock;
+
+			// the total number of clock ticks spent on measured ranges
+			std::atomic<std::uint64_t> ticks;
+
+			// the total number of iterations of measured ranges
+			std::atomic<std::uint64_t> iterations;
+
+		public:
+
+			using duration = clock::duration;
+
+			iteration_cost() : ticks(0), iterations(0) {}
+
+			iteration_cost(const iteration_cost&) = delete;
+			iteration_cost& operator=(const iteration_cost&) = delete;
+
+			/**
+			 * Determines whether there are any measurements to base predictions on.
+			 */
+			bool hasSamples() const {
+				return iterations.load(std::memory_order_relaxed) > 0;
+			}
+
+			/**
+			 * Predicts the time for processing the given number of iterations. Requires samples.
+			 */
+			duration predictTime(std::size_t size) const {
+				auto n = iterations.load(std::memory_order_relaxed);
+				auto t = ticks.load(std::memory_order_relaxed);
+				assert_lt(0u,n) << "No samples to base a prediction on!";
+				return (unsigned long long)(double(t) / double(n) * double(size));
+			}
+
+			/**
+			 * Records the time measured for processing the given number of iterations.
+			 */
+			void registerTime(std::size_t size, const duration& time) {
+				ticks.fetch_add(time.count(), std::memory_order_relaxed);
+				iterations.fetch_add(size, std::memory_order_relaxed);
+			}
+
+			/**
+			 * Measures the time of the given operation processing the given number of iterations.
+			 */
+			template<typename Op>
+			void measure(std::size_t size, const Op& op) {
+				auto start = clock::now();
+				op();
+				registerTime(size, clock::now() - start);
+			}
+
+		};
+
+		/**
+		 * Obtains the iteration costs recorded for the given key type, shared among all threads.
+		 */
+		template<typename Key>
+		iteration_cost& getIterationCost() {
+			static iteration_cost cost;
+			return cost;
+		}
+
+		/**
+		 * The decision on the base case of a parallel loop, derived from the partitioner active when
+		 * the loop got started.
+		 */
+		class loop_grain {
+
+			using duration = iteration_cost::duration;
+
+			// ranges of up to this number of iterations are processed sequentially
+			std::size_t grain;
+
+			// the measured costs of iterations, only maintained for automatic partitions
+			iteration_cost* cost;
+
+			// the targeted execution time of ranges, in clock ticks
+			duration target;
+
+			loop_grain(std::size_t grain, iteration_cost* cost = nullptr, duration target = duration::zero())
+				: grain(grain), cost(cost), target(target) {}
+
+		public:
+
+			template<typename Key>
+			static loop_grain create(const loop_partitioner& partitioner, std::size_t size) {
+				using namespace core::impl::reference;
+				switch(partitioner.getKind()) {
+					case loop_partitioner::Kind::Fixed: {
+						return { partitioner.getGrainSize() };
+					}
+					case loop_partitioner::Kind::Automatic: {
+						auto ticks = (unsigned long long)(double(partitioner.getTargetTime().count()) * TscClock::getTicksPerNanosecond());
+						return { 1, &getIterationCost<Key>(), ticks };
+					}
+					case loop_partitioner::Kind::Static: {
+						std::size_t numWorkers = std::max(runtime::WorkerPool::getInstance().getNumWorkers(),1);
+						return { std::max<std::size_t>((size + numWorkers - 1) / numWorkers, 1) };
+					}
+				}
+				return { 1 };
+			}
+
+			/**
+			 * Determines whether a range of the given size is to be processed sequentially. Until the costs
+			 * of iterations have been measured, automatic partitions keep splitting ranges, such that the
+			 * first measurements are taken on small ranges.
+			 */
+			bool isBaseCase(std::size_t size) const {
+				if (size <= grain) return true;
+				return cost && cost->hasSamples() && !(target < cost->predictTime(size));
+			}
+
+			/**
+			 * Processes a range of the given size sequentially, recording its execution time if required.
+			 */
+			template<typename Op>
+			void process(std::size_t size, const Op& op) const {
+				if (!cost) {
+					op();
+					return;
+				}
+				cost->measure(size, op);
+			}
+
+		};
+
+	} // end namespace detail
+
+
+
 	// ---------------------------------------------------------------------------------------------
 	//									Definitions
 	// ---------------------------------------------------------------------------------------------
@@ -1086,72 +1659,324 @@ namespace algorithm {
 			Dependency dependencies;
 		};
 
+		// the number of points of the blocks visited along a Z-order curve, sized to keep their data in cache
+		enum { SPACE_FILLING_BLOCK_SIZE = 4096 };
+
+		/**
+		 * Applies the given operation to blocks of the given range. Space filling traversals bisect the range
+		 * along its longest dimension down to small blocks, visiting those along a Z-order curve.
+		 */
+		template<typename Iter, typename Op>
+		void forEachBlock(const range<Iter>& r, loop_traversal traversal, const Op& op) {
+			if (traversal == loop_traversal::Lexicographic || dimensions<Iter>::value == 1 || r.size() <= SPACE_FILLING_BLOCK_SIZE) {
+				op(r);
+				return;
+			}
+			auto fragments = r.split(0,split_plan<Iter>::longest(r.begin(),r.end()));
+			forEachBlock(fragments.left,traversal,op);
+			forEachBlock(fragments.right,traversal,op);
+		}
+
+		/**
+		 * Recursively decomposes the given range and applies the given process operation to each
+		 * sequentially handled sub-range. The size of those is determined by the current partitioner,
+		 * where execution times are recorded for the given key type, and the order of splits by the
+		 * current traversal.
+		 */
+		template<typename Key, typename Iter, typename Process, typename Dependency>
+		loop_reference<Iter> processLoop(const range<Iter>& r, const Process& process, const Dependency& dependency) {
+
+			// fix the size of sequentially processed ranges and the order of splits
+			auto grain = loop_grain::create<Key>(getCurrentLoopPartitioner(),r.size());
+			auto plan = (getCurrentLoopTraversal() == loop_traversal::SpaceFilling) ? split_plan<Iter>::longest(r.begin(),r.end()) : split_plan<Iter>();
+
+			// trigger parallel processing
+			return { r, core::prec(
+				[grain](const RecArgsWithDependencies<Iter, Dependency>& rg) {
+					// if the remaining range is small enough, we reached the base case
+					return grain.isBaseCase(rg.range.size());
+				},
+				[process,grain](const RecArgsWithDependencies<Iter, Dependency>& rg) {
+					// process the remaining range
+					grain.process(rg.range.size(),[&]{ process(rg.range); });
+				},
+				core::pick(
+					[plan](const RecArgsWithDependencies<Iter, Dependency>& rg, const auto& nested) {
+						// in the step case we split the range and process sub-ranges recursively
+						auto fragments = rg.range.split(rg.depth,plan);
+						auto& left = fragments.left;
+						auto& right = fragments.right;
+						auto dep = rg.dependencies.split(left,right);
+						auto leftTask = nested(dep.left.toCoreDependencies(), RecArgsWithDependencies<Iter, Dependency>{rg.depth+1, left, dep.left} );
+						auto rightTask = nested(dep.right.toCoreDependencies(), RecArgsWithDependencies<Iter, Dependency>{rg.depth+1, right,dep.right});
+						return core::parallel(std::move(leftTask),std::move(rightTask));
+					},
+					[process,grain](const RecArgsWithDependencies<Iter, Dependency>& rg, const auto&) {
+						// the alternative is processing the step sequentially
+						grain.process(rg.range.size(),[&]{ process(rg.range); });
+					}
+				)
+			)(dependency.toCoreDependencies(),RecArgsWithDependencies<Iter, Dependency>{0,r,dependency}), plan };
+		}
+
+		template<typename Key, typename Iter, typename Process>
+		loop_reference<Iter> processLoop(const range<Iter>& r, const Process& process, const no_dependencies&) {
+
+			// fix the size of sequentially processed ranges and the order of splits
+			auto grain = loop_grain::create<Key>(getCurrentLoopPartitioner(),r.size());
+			auto plan = (getCurrentLoopTraversal() == loop_traversal::SpaceFilling) ? split_plan<Iter>::longest(r.begin(),r.end()) : split_plan<Iter>();
+
+			// trigger parallel processing
+			return { r, core::prec(
+				[grain](const RecArgsNoDependencies<Iter>& rg) {
+					// if the remaining range is small enough, we reached the base case
+					return grain.isBaseCase(rg.range.size());
+				},
+				[process,grain](const RecArgsNoDependencies<Iter>& rg) {
+					// process the remaining range
+					grain.process(rg.range.size(),[&]{ process(rg.range); });
+				},
+				core::pick(
+					[plan](const RecArgsNoDependencies<Iter>& rg, const auto& nested) {
+						// in the step case we split the range and process sub-ranges recursively
+						auto fragments = rg.range.split(rg.depth,plan);
+						auto left = nested(RecArgsNoDependencies<Iter>{rg.depth+1,fragments.left});
+						auto right = nested(RecArgsNoDependencies<Iter>{rg.depth+1,fragments.right});
+						return core::parallel(std::move(left),std::move(right));
+					},
+					[process,grain](const RecArgsNoDependencies<Iter>& rg, const auto&) {
+						// the alternative is processing the step sequentially
+						grain.process(rg.range.size(),[&]{ process(rg.range); });
+					}
+				)
+			)(RecArgsNoDependencies<Iter>{0,r}), plan };
+		}
+
 	} // end detail namespace
 
 
 	template<typename Iter, typename Body, typename Dependency>
 	detail::loop_reference<Iter> pfor(const detail::range<Iter>& r, const Body& body, const Dependency& dependency) {
-		
-		// trigger parallel processing
-		return { r, core::prec(
-			[](const detail::RecArgsWithDependencies<Iter, Dependency>& rg) {
-				// if there is only one element left, we reached the base case
-				return rg.range.size() <= 1;
-			},
-			[body](const detail::RecArgsWithDependencies<Iter, Dependency>& rg) {
-				// apply the body operation to every element in the remaining range
-				auto body_ = body;
-				rg.range.forEach(body_);
-			},
-			core::pick(
-				[](const detail::RecArgsWithDependencies<Iter, Dependency>& rg, const auto& nested) {
-					// in the step case we split the range and process sub-ranges recursively
-					auto fragments = rg.range.split(rg.depth);
-					auto& left = fragments.left;
-					auto& right = fragments.right;
-					auto dep = rg.dependencies.split(left,right);
-					auto leftTask = nested(dep.left.toCoreDependencies(), detail::RecArgsWithDependencies<Iter, Dependency>{rg.depth+1, left, dep.left} );
-					auto rightTask = nested(dep.right.toCoreDependencies(), detail::RecArgsWithDependencies<Iter, Dependency>{rg.depth+1, right,dep.right});
-					return core::parallel(std::move(leftTask),std::move(rightTask));
-				},
-				[body](const detail::RecArgsWithDependencies<Iter, Dependency>& rg, const auto&) {
-					// the alternative is processing the step sequentially
-					auto body_ = body;
-					rg.range.forEach(body_);
-				}
-			)
-		)(dependency.toCoreDependencies(),detail::RecArgsWithDependencies<Iter, Dependency>{0,r,dependency}) };
+		// apply the body operation to every element of each sub-range
+		auto traversal = getCurrentLoopTraversal();
+		return detail::processLoop<Body>(r,[body,traversal](const detail::range<Iter>& rg) {
+			auto body_ = body;
+			detail::forEachBlock(rg,traversal,[&](const detail::range<Iter>& block) { block.forEach(body_); });
+		},dependency);
 	}
 
 	template<typename Iter, typename Body>
-	detail::loop_reference<Iter> pfor(const detail::range<Iter>& r, const Body& body, const no_dependencies&) {
+	detail::loop_reference<Iter> pfor(const detail::range<Iter>& r, const Body& body, const no_dependencies& dependency) {
+		// apply the body operation to every element of each sub-range
+		auto traversal = getCurrentLoopTraversal();
+		return detail::processLoop<Body>(r,[body,traversal](const detail::range<Iter>& rg) {
+			auto body_ = body;
+			detail::forEachBlock(rg,traversal,[&](const detail::range<Iter>& block) { block.forEach(body_); });
+		},dependency);
+	}
 
-		// trigger parallel processing
-		return { r, core::prec(
-			[](const detail::RecArgsNoDependencies<Iter>& r) {
-				// if there is only one element left, we reached the base case
-				return r.range.size() <= 1;
-			},
-			[body](const detail::RecArgsNoDependencies<Iter>& r) {
-				// apply the body operation to every element in the remaining range
-				auto body_ = body;
-				r.range.forEach(body_);
-			},
-			core::pick(
-				[](const detail::RecArgsNoDependencies<Iter>& r, const auto& nested) {
-					// in the step case we split the range and process sub-ranges recursively
-					auto fragments = r.range.split(r.depth);
-					auto left = nested(detail::RecArgsNoDependencies<Iter>{r.depth+1,fragments.left});
-					auto right = nested(detail::RecArgsNoDependencies<Iter>{r.depth+1,fragments.right});
-					return core::parallel(std::move(left),std::move(right));
-				},
-				[body](const detail::RecArgsNoDependencies<Iter>& r, const auto&) {
-					// the alternative is processing the step sequentially
-					auto body_ = body;
-					r.range.forEach(body_);
+	template<typename Iter, typename Body, typename Dependency>
+	detail::loop_reference<Iter> pforRows(const detail::range<Iter>& r, const Body& body, const Dependency& dependency) {
+		// apply the body operation to every row of each sub-range
+		auto traversal = getCurrentLoopTraversal();
+		return detail::processLoop<Body>(r,[body,traversal](const detail::range<Iter>& rg) {
+			auto body_ = body;
+			detail::forEachBlock(rg,traversal,[&](const detail::range<Iter>& block) { block.forEachRow(body_); });
+		},dependency);
+	}
+
+	template<typename Iter, typename Body>
+	detail::loop_reference<Iter> pforRows(const detail::range<Iter>& r, const Body& body, const no_dependencies& dependency) {
+		// apply the body operation to every row of each sub-range
+		auto traversal = getCurrentLoopTraversal();
+		return detail::processLoop<Body>(r,[body,traversal](const detail::range<Iter>& rg) {
+			auto body_ = body;
+			detail::forEachBlock(rg,traversal,[&](const detail::range<Iter>& block) { block.forEachRow(body_); });
+		},dependency);
+	}
+
+	namespace detail {
+
+		// the number of points covered by the tiles of temporally tiled loops, sized to keep their data in cache
+		enum { TEMPORAL_TILE_SIZE = 1 << 14 };
+
+		// -- coordinate access --
+
+		template<typename Int>
+		std::enable_if_t<std::is_integral<Int>::value,std::int64_t> getCoordinate(const Int& p, std::size_t) {
+			return std::int64_t(p);
+		}
+
+		template<typename Elem, std::size_t dims>
+		std::int64_t getCoordinate(const std::array<Elem,dims>& p, std::size_t d) {
+			return std::int64_t(p[d]);
+		}
+
+		template<typename Elem, std::size_t dims>
+		std::int64_t getCoordinate(const utils::Vector<Elem,dims>& p, std::size_t d) {
+			return std::int64_t(p[d]);
+		}
+
+		template<typename Int>
+		std::enable_if_t<std::is_integral<Int>::value> setCoordinate(Int& p, std::size_t, std::int64_t value) {
+			p = Int(value);
+		}
+
+		template<typename Elem, std::size_t dims>
+		void setCoordinate(std::array<Elem,dims>& p, std::size_t d, std::int64_t value) {
+			p[d] = Elem(value);
+		}
+
+		template<typename Elem, std::size_t dims>
+		void setCoordinate(utils::Vector<Elem,dims>& p, std::size_t d, std::int64_t value) {
+			p[d] = Elem(value);
+		}
+
+		/**
+		 * The extent of a space-time tile along a single dimension. In the k-th time step of a block of
+		 * time steps, the tile covers the interval [lower + k * lowerSlope, upper + k * upperSlope).
+		 */
+		struct tile_interval {
+			std::int64_t lower;
+			std::int64_t upper;
+			std::int64_t lowerSlope;
+			std::int64_t upperSlope;
+		};
+
+		/**
+		 * A space-time tile of a temporally tiled loop, being the product of an interval along each dimension.
+		 */
+		template<typename Iter>
+		struct tile {
+
+			std::array<tile_interval,dimensions<Iter>::value> intervals;
+
+			/**
+			 * Applies the given body to all points of this tile in the time steps [t0, t0 + height).
+			 */
+			template<typename Body>
+			void process(const Iter& origin, std::size_t t0, std::size_t height, const Body& body) const {
+				for(std::size_t k=0; k<height; k++) {
+
+					// compute the box covered in the current time step
+					Iter begin = origin;
+					Iter end = origin;
+					bool empty = false;
+					for(std::size_t d=0; d<intervals.size(); d++) {
+						const auto& cur = intervals[d];
+						auto lower = cur.lower + std::int64_t(k) * cur.lowerSlope;
+						auto upper = cur.upper + std::int64_t(k) * cur.upperSlope;
+						if (lower >= upper) empty = true;
+						setCoordinate(begin,d,lower);
+						setCoordinate(end,d,upper);
+					}
+					if (empty) continue;
+
+					// process the points of the current time step
+					auto t = t0 + k;
+					forEach(begin,end,[&](const auto& p) { body(t,p); });
 				}
-			)
-		)(detail::RecArgsNoDependencies<Iter>{0,r}) };
+			}
+
+		};
+
+		/**
+		 * Determines the width of the tiles of a temporally tiled loop over a range of the given volume. Tiles are
+		 * sized to fit into the cache, yet narrowed such that there are at least about as many tiles as workers.
+		 */
+		inline std::int64_t getTemporalTileWidth(std::size_t dims, double volume, std::int64_t slope, std::size_t numWorkers) {
+			auto cacheWidth = std::ceil(std::pow(double(TEMPORAL_TILE_SIZE),1.0/dims));
+			auto workerWidth = std::floor(std::pow(volume / double(std::max<std::size_t>(numWorkers,1)),1.0/dims));
+			return std::max<std::int64_t>(std::int64_t(std::min(cacheWidth,workerWidth)),std::max<std::int64_t>(2*slope,1));
+		}
+
+		/**
+		 * Processes the given number of time steps on the given range using split tiling. Each dimension is cut
+		 * into tiles, which shrink by the given radius per time step, and gaps in between, which grow by the
+		 * radius per time step. In a block of time steps, the products of those are processed in phases
+		 * ordered by the number of gap dimensions, where all tiles of a phase may be processed in parallel.
+		 */
+		template<std::size_t radius, typename Iter, typename Body>
+		void processTiled(const range<Iter>& r, std::size_t steps, const Body& body) {
+			const std::size_t dims = dimensions<Iter>::value;
+			const std::int64_t slope = radius;
+
+			// cut each dimension into tiles of about equal width and the gaps in between
+			std::array<std::vector<tile_interval>,dimensions<Iter>::value> tiles;
+			std::array<std::vector<tile_interval>,dimensions<Iter>::value> gaps;
+			std::size_t height = steps;
+			double volume = 1;
+			for(std::size_t d=0; d<dims; d++) {
+				auto extent = getCoordinate(r.end(),d) - getCoordinate(r.begin(),d);
+				if (extent <= 0) return;
+				volume *= double(extent);
+			}
+			std::size_t numWorkers = std::max(core::impl::reference::runtime::WorkerPool::getInstance().getNumWorkers(),1);
+			auto width = getTemporalTileWidth(dims,volume,slope,numWorkers);
+			for(std::size_t d=0; d<dims; d++) {
+				auto begin = getCoordinate(r.begin(),d);
+				auto end = getCoordinate(r.end(),d);
+
+				auto extent = end - begin;
+				auto num = std::max<std::int64_t>(extent / width,1);
+				for(std::int64_t i=0; i<num; i++) {
+					auto lower = begin + extent * i / num;
+					auto upper = begin + extent * (i+1) / num;
+					tiles[d].push_back({ lower, upper, (i > 0) ? slope : 0, (i < num-1) ? -slope : 0 });
+					if (i > 0) gaps[d].push_back({ lower, lower, -slope, slope });
+				}
+
+				// tiles must not shrink below zero width within a block of time steps
+				if (num > 1 && radius > 0) {
+					height = std::min<std::size_t>(height,(extent / num) / (2*slope));
+				}
+			}
+			height = std::max<std::size_t>(height,1);
+
+			// group the tiles into phases by the number of dimensions they are covering gaps in
+			std::vector<std::vector<tile<Iter>>> phases(dims+1);
+			for(std::size_t mask=0; mask < (std::size_t(1) << dims); mask++) {
+				std::vector<tile<Iter>> cur(1);
+				std::size_t numGaps = 0;
+				for(std::size_t d=0; d<dims; d++) {
+					bool gap = mask & (std::size_t(1) << d);
+					if (gap) numGaps++;
+					std::vector<tile<Iter>> next;
+					for(const auto& t : cur) {
+						for(const auto& interval : (gap ? gaps[d] : tiles[d])) {
+							next.push_back(t);
+							next.back().intervals[d] = interval;
+						}
+					}
+					cur.swap(next);
+				}
+				auto& phase = phases[numGaps];
+				phase.insert(phase.end(),cur.begin(),cur.end());
+			}
+
+			// tiles are already coarse grained, each of them is processed by its own task
+			loop_partitioner_scope partitioner(fixed_grain(1));
+
+			// process blocks of time steps, one phase after the other
+			for(std::size_t t0=0; t0<steps; t0+=height) {
+				auto h = std::min(height,steps-t0);
+				for(const auto& phase : phases) {
+					if (phase.empty()) continue;
+					pfor(std::size_t(0),phase.size(),[&](std::size_t i) {
+						phase[i].process(r.begin(),t0,h,body);
+					});
+				}
+			}
+		}
+
+	} // end namespace detail
+
+	template<std::size_t radius, typename Iter, typename Body>
+	detail::loop_reference<Iter> pforTiled(const detail::range<Iter>& r, std::size_t steps, const Body& body) {
+		// process all time steps in a single task, coordinating the parallel processing of tiles
+		return { r, core::impl::reference::spawn<true>([r,steps,body]() {
+			detail::processTiled<radius>(r,steps,body);
+		}) };
 	}
 
 	class no_dependency : public detail::loop_dependency {
@@ -1345,42 +2170,44 @@ namespace algorithm {
 
 		detail::SubDependencies<small_neighborhood_sync_dependency<Iter,radius>> split(const detail::range<Iter>& left, const detail::range<Iter>& right) const {
 
-			using splitter = detail::range_spliter<Iter>;
-
 			// create new left and right dependencies
 			small_neighborhood_sync_dependency res_left;
 			small_neighborhood_sync_dependency res_right;
 
-			// update center
-			res_left.center = center.getLeft();
-			res_right.center = center.getRight();
+			// split the center only once, its halves are also neighbors of each other
+			auto halves = center.split();
+			res_left.center = halves.left;
+			res_right.center = halves.right;
 
 			// update neighbors except split dimension
 			bool save_left = true;
 			bool save_right = true;
-			auto splitDim = splitter::getSplitDimension(center.getDepth());
+			auto splitDim = center.getSplitDimension();
 			for(std::size_t i =0; i<num_dimensions; i++) {
+				const auto& cur = neighborhood[i];
 				if (i != splitDim) {
 					// narrow down dependencies in each dimension
-					res_left.neighborhood[i].left  = neighborhood[i].left.getLeft();
-					res_left.neighborhood[i].right = neighborhood[i].right.getLeft();
-					res_right.neighborhood[i].left  = neighborhood[i].left.getRight();
-					res_right.neighborhood[i].right = neighborhood[i].right.getRight();
+					auto lower = cur.left.split();
+					auto upper = cur.right.split();
+					res_left.neighborhood[i].left  = lower.left;
+					res_left.neighborhood[i].right = upper.left;
+					res_right.neighborhood[i].left  = lower.right;
+					res_right.neighborhood[i].right = upper.right;
 				} else {
 					// for the split dimension, apply special treatment
-					res_left.neighborhood[i].left = neighborhood[i].left.getRight();
-					res_left.neighborhood[i].right = center.getRight();
-					res_right.neighborhood[i].left = center.getLeft();
-					res_right.neighborhood[i].right = neighborhood[i].right.getLeft();
+					res_left.neighborhood[i].left = cur.left.split().right;
+					res_left.neighborhood[i].right = halves.right;
+					res_right.neighborhood[i].left = halves.left;
+					res_right.neighborhood[i].right = cur.right.split().left;
 
 				}
 
 				// check that there is still something remaining in left and right
-				if (save_left && !neighborhood[i].left.getRange().empty() && getMinimumDimensionLength(res_left.neighborhood[i].left.getRange()) < radius) save_left = false;
-				if (save_left && !neighborhood[i].right.getRange().empty() && getMinimumDimensionLength(res_left.neighborhood[i].right.getRange()) < radius) save_left = false;
+				if (save_left && !cur.left.getRange().empty() && getMinimumDimensionLength(res_left.neighborhood[i].left.getRange()) < radius) save_left = false;
+				if (save_left && !cur.right.getRange().empty() && getMinimumDimensionLength(res_left.neighborhood[i].right.getRange()) < radius) save_left = false;
 
-				if (save_right && !neighborhood[i].left.getRange().empty() && getMinimumDimensionLength(res_right.neighborhood[i].left.getRange()) < radius) save_right = false;
-				if (save_right && !neighborhood[i].right.getRange().empty() && getMinimumDimensionLength(res_right.neighborhood[i].right.getRange()) < radius) save_right = false;
+				if (save_right && !cur.left.getRange().empty() && getMinimumDimensionLength(res_right.neighborhood[i].left.getRange()) < radius) save_right = false;
+				if (save_right && !cur.right.getRange().empty() && getMinimumDimensionLength(res_right.neighborhood[i].right.getRange()) < radius) save_right = false;
 
 			}
 
@@ -1440,32 +2267,33 @@ namespace algorithm {
 				return nested::template produceCoreDependencies(blocks.dependencies[0]...,blocks.dependencies[1]...,blocks.dependencies[2]...);
 			}
 
-			full_dependency_block narrowLeft(bool& save, std::size_t splitDimension, std::size_t radius) const {
-				full_dependency_block res;
-				if (Dims - 1 == splitDimension) {
-					res.dependencies[0] = dependencies[0].narrowRight(save,splitDimension, radius);
-					res.dependencies[1] = dependencies[1].narrowLeft(save,splitDimension, radius);
-					res.dependencies[2] = dependencies[1].narrowRight(save,splitDimension, radius);
-				} else {
-					res.dependencies[0] = dependencies[0].narrowLeft(save,splitDimension, radius);
-					res.dependencies[1] = dependencies[1].narrowLeft(save,splitDimension, radius);
-					res.dependencies[2] = dependencies[2].narrowLeft(save,splitDimension, radius);
+			/**
+			 * Computes the dependencies of the left and right sub-range of the center, splitting each
+			 * covered iteration reference only once. Safety flags are cleared if a resulting dependency
+			 * gets narrower than the given radius.
+			 */
+			void narrow(bool& saveLeft, bool& saveRight, std::size_t splitDimension, std::size_t radius, full_dependency_block& left, full_dependency_block& right) const {
+				if (Dims - 1 != splitDimension) {
+					// narrow down dependencies in each direction
+					for(std::size_t i=0; i<3; i++) {
+						dependencies[i].narrow(saveLeft,saveRight,splitDimension,radius,left.dependencies[i],right.dependencies[i]);
+					}
+					return;
 				}
-				return res;
-			}
 
-			full_dependency_block narrowRight(bool& save, std::size_t splitDimension, std::size_t radius) const {
-				full_dependency_block res;
-				if (Dims - 1 == splitDimension) {
-					res.dependencies[0] = dependencies[1].narrowLeft(save,splitDimension, radius);
-					res.dependencies[1] = dependencies[1].narrowRight(save,splitDimension, radius);
-					res.dependencies[2] = dependencies[2].narrowLeft(save,splitDimension, radius);
-				} else {
-					res.dependencies[0] = dependencies[0].narrowRight(save,splitDimension, radius);
-					res.dependencies[1] = dependencies[1].narrowRight(save,splitDimension, radius);
-					res.dependencies[2] = dependencies[2].narrowRight(save,splitDimension, radius);
-				}
-				return res;
+				// along the split dimension, only the inner halves of the outer neighbors remain
+				bool unused = true;
+				nested outer;
+				dependencies[0].narrow(unused,saveLeft,splitDimension,radius,outer,left.dependencies[0]);
+				dependencies[2].narrow(saveRight,unused,splitDimension,radius,right.dependencies[2],outer);
+
+				// while the halves of the center become neighbors of each other
+				bool saveCenter = true;
+				dependencies[1].narrow(saveCenter,saveCenter,splitDimension,radius,left.dependencies[1],right.dependencies[1]);
+				left.dependencies[2] = right.dependencies[1];
+				right.dependencies[0] = left.dependencies[1];
+				saveLeft = saveLeft && saveCenter;
+				saveRight = saveRight && saveCenter;
 			}
 		};
 
@@ -1500,18 +2328,13 @@ namespace algorithm {
 				return core::after(blocks.dependency...);
 			}
 
-			full_dependency_block narrowLeft(bool& save, std::size_t, std::size_t radius) const {
-				full_dependency_block res;
-				res.dependency = dependency.getLeft();
-				if (!dependency.getRange().empty() && getMinimumDimensionLength(res.dependency.getRange()) < radius) save = false;
-				return res;
-			}
-
-			full_dependency_block narrowRight(bool& save, std::size_t, std::size_t radius) const {
-				full_dependency_block res;
-				res.dependency = dependency.getRight();
-				if (!dependency.getRange().empty() && getMinimumDimensionLength(res.dependency.getRange()) < radius) save = false;
-				return res;
+			void narrow(bool& saveLeft, bool& saveRight, std::size_t, std::size_t radius, full_dependency_block& left, full_dependency_block& right) const {
+				auto halves = dependency.split();
+				left.dependency = halves.left;
+				right.dependency = halves.right;
+				if (dependency.getRange().empty()) return;
+				if (getMinimumDimensionLength(left.dependency.getRange()) < radius) saveLeft = false;
+				if (getMinimumDimensionLength(right.dependency.getRange()) < radius) saveRight = false;
 			}
 		};
 
@@ -1551,17 +2374,18 @@ namespace algorithm {
 		}
 
 		detail::SubDependencies<full_neighborhood_sync_dependency<Iter,radius>> split(const detail::range<Iter>& left, const detail::range<Iter>& right) const {
-			using splitter = detail::range_spliter<Iter>;
-
-			auto splitDim = splitter::getSplitDimension(deps.getCenter().getDepth());
+			auto splitDim = deps.getCenter().getSplitDimension();
 
 			// prepare safety flag
 			bool save_left = true;
 			bool save_right = true;
 
 			// compute left and right sub-dependencies
-			full_neighborhood_sync_dependency res_left(deps.narrowLeft(save_left,splitDim,radius));
-			full_neighborhood_sync_dependency res_right(deps.narrowRight(save_right,splitDim,radius));
+			deps_block left_deps;
+			deps_block right_deps;
+			deps.narrow(save_left,save_right,splitDim,radius,left_deps,right_deps);
+			full_neighborhood_sync_dependency res_left(left_deps);
+			full_neighborhood_sync_dependency res_right(right_deps);
 
 			// check coverage and build up result
 			return {
@@ -1622,69 +2446,24 @@ namespace algorithm {
 		// keep a copy of the full range
 		auto full = r;
 
-		// trigger parallel processing
-		return { r, core::prec(
-			[](const detail::RecArgsWithDependencies<Iter, Dependency>& rg) {
-				// if there is only one element left, we reached the base case
-				return rg.range.size() <= 1;
-			},
-			[innerBody,boundaryBody,full](const detail::RecArgsWithDependencies<Iter, Dependency>& rg) {
-				// apply the body operation to every element in the remaining range
-				rg.range.forEachWithBoundary(full,innerBody,boundaryBody);
-			},
-			core::pick(
-				[](const detail::RecArgsWithDependencies<Iter, Dependency>& rg, const auto& nested) {
-					// in the step case we split the range and process sub-ranges recursively
-					auto fragments = rg.range.split(rg.depth);
-					auto& left = fragments.left;
-					auto& right = fragments.right;
-					auto dep = rg.dependencies.split(left,right);
-					return core::parallel(
-						nested(dep.left.toCoreDependencies(), detail::RecArgsWithDependencies<Iter, Dependency>{rg.depth+1,left, dep.left} ),
-						nested(dep.right.toCoreDependencies(), detail::RecArgsWithDependencies<Iter, Dependency>{rg.depth+1,right,dep.right})
-					);
-				},
-				[innerBody,boundaryBody,full](const detail::RecArgsWithDependencies<Iter, Dependency>& rg, const auto&) {
-					// the alternative is processing the step sequentially
-					rg.range.forEachWithBoundary(full,innerBody,boundaryBody);
-				}
-			)
-		)(dependency.toCoreDependencies(),detail::RecArgsWithDependencies<Iter, Dependency>{0,r,dependency}) };
+		// apply the inner and boundary operations to the points of each sub-range
+		auto traversal = getCurrentLoopTraversal();
+		return detail::processLoop<InnerBody>(r,[innerBody,boundaryBody,full,traversal](const detail::range<Iter>& rg) {
+			detail::forEachBlock(rg,traversal,[&](const detail::range<Iter>& block) { block.forEachWithBoundary(full,innerBody,boundaryBody); });
+		},dependency);
 	}
 
 	template<typename Iter, typename InnerBody, typename BoundaryBody>
-	detail::loop_reference<Iter> pforWithBoundary(const detail::range<Iter>& r, const InnerBody& innerBody, const BoundaryBody& boundaryBody, const no_dependencies&) {
+	detail::loop_reference<Iter> pforWithBoundary(const detail::range<Iter>& r, const InnerBody& innerBody, const BoundaryBody& boundaryBody, const no_dependencies& dependency) {
 
 		// keep a copy of the full range
 		auto full = r;
 
-		// trigger parallel processing
-		return { r, core::prec(
-			[](const detail::RecArgsNoDependencies<Iter>& r) {
-				// if there is only one element left, we reached the base case
-				return r.range.size() <= 1;
-			},
-			[innerBody,boundaryBody,full](const detail::RecArgsNoDependencies<Iter>& r) {
-				// apply the body operation to every element in the remaining range
-				r.range.forEachWithBoundary(full,innerBody,boundaryBody);
-			},
-			core::pick(
-				[](const detail::RecArgsNoDependencies<Iter>& r, const auto& nested) {
-					// in the step case we split the range and process sub-ranges recursively
-					auto fragments = r.range.split(r.depth);
-					auto& left = fragments.left;
-					auto& right = fragments.right;
-					return core::parallel(
-						nested(detail::RecArgsNoDependencies<Iter>{ r.depth+1, left }),
-						nested(detail::RecArgsNoDependencies<Iter>{ r.depth+1, right })
-					);
-				},
-				[innerBody,boundaryBody,full](const detail::RecArgsNoDependencies<Iter>& r, const auto&) {
-					// the alternative is processing the step sequentially
-					r.range.forEachWithBoundary(full,innerBody,boundaryBody);
-				}
-			)
-		)(detail::RecArgsNoDependencies<Iter>{ 0 , r }) };
+		// apply the inner and boundary operations to the points of each sub-range
+		auto traversal = getCurrentLoopTraversal();
+		return detail::processLoop<InnerBody>(r,[innerBody,boundaryBody,full,traversal](const detail::range<Iter>& rg) {
+			detail::forEachBlock(rg,traversal,[&](const detail::range<Iter>& block) { block.forEachWithBoundary(full,innerBody,boundaryBody); });
+		},dependency);
 	}
 
 
@@ -1708,6 +2487,9 @@ namespace algorithm {
 		// get the initial dependency
 		auto dependency = one_on_one(loop);
 
+		// split the range like the preceding loop
+		auto plan = loop.getSplitPlan();
+
 		// trigger parallel processing
 		return { r, core::prec(
 			[point](const detail::AfterRecArgs<Iter>& rg) {
@@ -1720,9 +2502,9 @@ namespace algorithm {
 
 			},
 			core::pick(
-				[](const detail::AfterRecArgs<Iter>& rg, const auto& nested) {
+				[plan](const detail::AfterRecArgs<Iter>& rg, const auto& nested) {
 					// in the step case we split the range and process sub-ranges recursively
-					auto fragments = rg.range.split(rg.depth);
+					auto fragments = rg.range.split(rg.depth,plan);
 					auto& left = fragments.left;
 					auto& right = fragments.right;
 					auto dep = rg.dependencies.split(left,right);
@@ -1736,7 +2518,7 @@ namespace algorithm {
 					if (rg.range.covers(point)) action();
 				}
 			)
-		)(dependency.toCoreDependencies(),detail::AfterRecArgs<Iter>{0,r,dependency}) };
+		)(dependency.toCoreDependencies(),detail::AfterRecArgs<Iter>{0,r,dependency}), plan };
 	}
 
 } // end namespace algorithm
@@ -6,6 +6,7 @@
 #include <tuple>
 
 #include <bitset>
+#include <cstddef>
 #include <cstring>
 
 #include "allscale/utils/assert.h"
@@ -257,12 +258,18 @@ namespace data {
 		}
 
 
-		class const_iterator : public std::iterator<std::random_access_iterator_tag, NodeRef<Kind,Level>> {
+		class const_iterator {
 
 			node_index_t cur;
 
 		public:
 
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = NodeRef<Kind,Level>;
+			using difference_type = std::ptrdiff_t;
+			using pointer = NodeRef<Kind,Level>*;
+			using reference = NodeRef<Kind,Level>&;
+
 			const_iterator(NodeID pos) : cur(pos) {};
 
 			bool operator==(const const_iterator& other) const {
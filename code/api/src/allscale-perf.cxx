@@ -189,7 +189,7 @@ std::vector<ProfileLog> loadLogs() {
 	while(exists(file)) {
 		// load this file
 		std::cout << "  loading file " << file << " ...\n";
-		logs.emplace_back(ProfileLog::loadFrom(file));
+		logs.emplace_back(ProfileLog::loadRecentFrom(file));
 
 		// go to next step
 		i++;
@@ -0,0 +1,71 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "allscale/api/core/impl/reference/profiling.h"
+
+using namespace allscale::api::core::impl::reference;
+
+/**
+ * A utility merging the profiler logs of all workers into a single trace in the Chrome trace
+ * event format, to be inspected using chrome://tracing or the Perfetto UI (ui.perfetto.dev).
+ */
+
+bool exists(const std::string& file) {
+	std::ifstream in(file.c_str());
+	return in.good();
+}
+
+/**
+ * Prints the usage of this program.
+ */
+void printUsageAndExit(const std::string& name) {
+	std::cout << "Usage: " << name << " [options]\n";
+	std::cout << "  Options:\n";
+	std::cout << "  \t--output,-o <file>  specify the trace file to be written (default: trace.json)\n";
+	std::cout << "  \t--help,-h           display this help text\n";
+	exit(0);
+}
+
+int main(int argc, char** argv) {
+
+	std::string output = "trace.json";
+
+	// parse parameters
+	for(int i=1; i<argc; i++) {
+		std::string flag = argv[i];
+		if(flag == "-h" || flag == "--help") {
+			printUsageAndExit(argv[0]);
+		}
+		if(flag == "-o" || flag == "--output") {
+			i++;
+			if(argc <= i) {
+				printUsageAndExit(argv[0]);
+			}
+			output = argv[i];
+		}
+	}
+
+	// load all available logs
+	std::cout << "Loading logs ...\n";
+	std::vector<ProfileLog> logs;
+	for(int i=0; exists(getLogFileNameForWorker(i)); i++) {
+		auto file = getLogFileNameForWorker(i);
+		std::cout << "  loading file " << file << " ...\n";
+		logs.emplace_back(ProfileLog::loadRecentFrom(file));
+	}
+
+	if (logs.empty()) {
+		std::cout << "No profiler logs found in current directory.\n";
+		return 1;
+	}
+
+	// produce the trace
+	std::cout << "Writing trace " << output << " ...\n";
+	std::ofstream out(output.c_str());
+	exportTrace(logs, out);
+
+	return (out.good()) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <numeric>
+
+#include "allscale/api/core/allocator.h"
+#include "allscale/api/core/prec.h"
+
+namespace allscale {
+namespace api {
+namespace core {
+
+	TEST(TaskLocalAllocator, TaskBodies) {
+
+		std::atomic<int> corrupted(0);
+
+		// each step fills a scratch buffer, waits for its sub-tasks, and checks the buffer afterwards
+		auto sum = prec(
+			[](int n) { return n < 2; },
+			[](int n) { return n; },
+			[&](int n, const auto& f) {
+				task_local_vector<int> scratch(64 + n);
+				std::iota(scratch.begin(), scratch.end(), n);
+
+				// sub-tasks processed by this thread while waiting use the same arena
+				auto a = f(n-1).get();
+				auto b = f(n-2).get();
+
+				for(std::size_t i=0; i<scratch.size(); i++) {
+					if (scratch[i] != n + (int)i) corrupted++;
+				}
+				return a + b;
+			}
+		);
+
+		EXPECT_EQ(6765, sum(20).get());
+		EXPECT_EQ(0, corrupted);
+
+		// the memory of completed tasks has been released
+		EXPECT_FALSE(impl::reference::detail::getLocalTaskArena().isActive());
+	}
+
+} // end namespace core
+} // end namespace api
+} // end namespace allscale
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include "allscale/api/core/coroutine.h"
+
+#if ALLSCALE_WITH_COROUTINES
+
+#include "allscale/api/core/prec.h"
+
+namespace allscale {
+namespace api {
+namespace core {
+
+	namespace {
+
+		task<int> answer() {
+			co_return 42;
+		}
+
+		task<void> increment(std::atomic<int>& counter) {
+			counter++;
+			co_return;
+		}
+
+		task<int> fib(int x) {
+			if (x < 2) co_return x;
+			// start one branch in parallel, process the other in this task
+			auto a = run(fib(x-1));
+			int b = co_await fib(x-2);
+			co_return co_await std::move(a) + b;
+		}
+
+		int fib_seq(int x) {
+			if (x < 2) return x;
+			return fib_seq(x-1) + fib_seq(x-2);
+		}
+
+	}
+
+	TEST(Coroutine, Basic) {
+
+		EXPECT_EQ(42, answer().get());
+
+		std::atomic<int> counter(0);
+		increment(counter).get();
+		EXPECT_EQ(1, counter);
+
+		// tasks not started are not processed
+		{
+			auto t = increment(counter);
+		}
+		EXPECT_EQ(1, counter);
+
+		treeture<int> t = run(answer());
+		EXPECT_EQ(42, t.get());
+
+	}
+
+	TEST(Coroutine, AwaitTreetures) {
+
+		auto sum = [](std::vector<treeture<int>>& list) -> task<int> {
+			int res = 0;
+			for(auto& cur : list) {
+				res += co_await cur;
+			}
+			co_return res;
+		};
+
+		std::vector<treeture<int>> list;
+		for(int i=0; i<10; i++) {
+			list.push_back(impl::reference::spawn<true>([i]{ return i; }));
+		}
+		EXPECT_EQ(45, sum(list).get());
+
+		// completed and unreleased treetures, and task references
+		auto mixed = []() -> task<int> {
+			int a = co_await treeture<int>(done(1));
+			int b = co_await impl::reference::spawn<true>([]{ return 2; });
+			int c = co_await impl::sequential::treeture<int>(3);
+			treeture<void> d = impl::reference::spawn<true>([]{});
+			co_await d.getTaskReference();
+			co_return a + b + c;
+		};
+		EXPECT_EQ(6, mixed().get());
+
+	}
+
+	TEST(Coroutine, Nested) {
+
+		for(int i=0; i<15; i++) {
+			EXPECT_EQ(fib_seq(i), fib(i).get()) << "i=" << i;
+		}
+
+	}
+
+	TEST(Coroutine, LongChain) {
+
+		const int N = 10000;
+
+		// each step awaits a task, which does not grow the stack
+		auto chain = []() -> task<int> {
+			int res = 0;
+			for(int i=0; i<N; i++) {
+				res += co_await impl::reference::spawn<true>([]{ return 1; });
+			}
+			co_return res;
+		};
+
+		EXPECT_EQ(N, chain().get());
+
+	}
+
+	TEST(Coroutine, Prec) {
+
+		auto pfib = prec(
+			fun(
+				[](int x)->bool { return x < 2; },
+				[](int x)->int { return x; },
+				[](int x, const auto& f) {
+					auto a = run(f(x-1));
+					auto b = run(f(x-2));
+					return done(a.get() + b.get());
+				}
+			)
+		);
+
+		auto twice = [&](int x) -> task<int> {
+			int a = co_await pfib(x);
+			int b = co_await pfib(x);
+			co_return a + b;
+		};
+
+		EXPECT_EQ(2*fib_seq(12), twice(12).get());
+
+	}
+
+} // end namespace core
+} // end namespace api
+} // end namespace allscale
+
+#else
+
+	TEST(Coroutine, Unsupported) {
+		// the coroutine layer is disabled without C++20 coroutine support
+		EXPECT_FALSE(ALLSCALE_WITH_COROUTINES);
+	}
+
+#endif
@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "allscale/api/core/impl/reference/allocator.h"
+
+namespace allscale {
+namespace api {
+namespace core {
+namespace impl {
+namespace reference {
+
+	TEST(SlabHeap, Basic) {
+
+		detail::SlabHeap heap;
+		EXPECT_EQ(0, heap.getNumSlabs());
+
+		void* a = heap.allocate(24);
+		void* b = heap.allocate(24);
+		EXPECT_NE(a, b);
+		EXPECT_EQ(1, heap.getNumSlabs());
+
+		// blocks are properly aligned
+		EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(a) % alignof(std::max_align_t));
+		EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(b) % alignof(std::max_align_t));
+
+		// freed blocks are re-used
+		detail::SlabHeap::deallocate(a, &heap);
+		EXPECT_EQ(a, heap.allocate(20));
+
+		// but not for other size classes
+		detail::SlabHeap::deallocate(b, &heap);
+		EXPECT_NE(b, heap.allocate(100));
+
+		// large blocks are obtained from the global heap
+		void* c = heap.allocate(detail::SlabHeap::MAX_BLOCK_SIZE + 1);
+		EXPECT_EQ(1, heap.getNumSlabs());
+		detail::SlabHeap::deallocate(c, &heap);
+	}
+
+	TEST(SlabHeap, SteadyState) {
+
+		detail::SlabHeap heap;
+
+		// allocate a first batch of objects
+		std::vector<void*> blocks;
+		for(int i=0; i<10000; i++) {
+			blocks.push_back(heap.allocate(64));
+		}
+		for(auto cur : blocks) {
+			detail::SlabHeap::deallocate(cur, &heap);
+		}
+
+		// no more slabs are required for re-allocating the same amount
+		auto numSlabs = heap.getNumSlabs();
+		for(int j=0; j<10; j++) {
+			blocks.clear();
+			for(int i=0; i<10000; i++) {
+				blocks.push_back(heap.allocate(64));
+			}
+			for(auto cur : blocks) {
+				detail::SlabHeap::deallocate(cur, &heap);
+			}
+		}
+		EXPECT_EQ(numSlabs, heap.getNumSlabs());
+	}
+
+	TEST(SlabHeap, RemoteFree) {
+
+		detail::SlabHeap heap;
+
+		const int N = 10000;
+		std::vector<void*> blocks;
+		for(int i=0; i<N; i++) {
+			blocks.push_back(heap.allocate(32));
+		}
+
+		// free the blocks by concurrent threads
+		std::vector<std::thread> threads;
+		for(int t=0; t<4; t++) {
+			threads.emplace_back([&,t]{
+				for(int i=t; i<N; i+=4) {
+					detail::SlabHeap::deallocate(blocks[i], nullptr);
+				}
+			});
+		}
+		for(auto& cur : threads) cur.join();
+
+		// all blocks got returned to the owner
+		auto numSlabs = heap.getNumSlabs();
+		std::set<void*> reused;
+		for(int i=0; i<N; i++) {
+			reused.insert(heap.allocate(32));
+		}
+		EXPECT_EQ(numSlabs, heap.getNumSlabs());
+		EXPECT_EQ(std::set<void*>(blocks.begin(), blocks.end()), reused);
+	}
+
+	TEST(PoolAllocator, SharedPtr) {
+
+		// the blocks of terminated threads may still be freed
+		std::shared_ptr<int> ptr;
+		std::thread([&]{
+			ptr = std::allocate_shared<int>(PoolAllocator<int>(), 12);
+		}).join();
+
+		EXPECT_EQ(12, *ptr);
+		ptr.reset();
+
+		std::vector<int,PoolAllocator<int>> list;
+		for(int i=0; i<1000; i++) {
+			list.push_back(i);
+		}
+		for(int i=0; i<1000; i++) {
+			EXPECT_EQ(i, list[i]);
+		}
+	}
+
+	TEST(TaskArena, Basic) {
+
+		detail::TaskArena arena;
+		EXPECT_FALSE(arena.isActive());
+		EXPECT_EQ(0, arena.getCapacity());
+
+		auto outer = arena.enter();
+		EXPECT_TRUE(arena.isActive());
+
+		// allocations are aligned and taken from the arena
+		auto a = static_cast<char*>(arena.allocate(3, 1));
+		auto b = static_cast<char*>(arena.allocate(8, 8));
+		EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(b) % 8);
+		EXPECT_LE(a + 3, b);
+		EXPECT_TRUE(arena.contains(a));
+		EXPECT_TRUE(arena.contains(b));
+
+		int x = 0;
+		EXPECT_FALSE(arena.contains(&x));
+
+		// the most recent allocation may be freed individually
+		arena.deallocate(b, 8);
+		EXPECT_EQ(b, arena.allocate(8, 8));
+
+		// nested scopes release their memory when being left
+		auto inner = arena.enter();
+		auto c = arena.allocate(16, 8);
+		arena.leave(inner);
+		EXPECT_EQ(c, arena.allocate(16, 8));
+
+		arena.leave(outer);
+		EXPECT_FALSE(arena.isActive());
+	}
+
+	TEST(TaskArena, Growth) {
+
+		const std::size_t CHUNK = detail::TaskArena::CHUNK_SIZE;
+
+		detail::TaskArena arena;
+
+		// fill several chunks, including one larger than the default chunk size
+		for(int i=0; i<3; i++) {
+			auto mark = arena.enter();
+			for(int j=0; j<100; j++) {
+				arena.allocate(CHUNK / 32, 8);
+			}
+			arena.allocate(3 * CHUNK, 16);
+			EXPECT_LE(7 * CHUNK, arena.getCapacity());
+			arena.leave(mark);
+		}
+
+		// chunks are re-used, thus the footprint is bounded by the peak usage,
+		// while oversized chunks are not retained
+		auto capacity = arena.getCapacity();
+		EXPECT_LE(4 * CHUNK, capacity);
+		EXPECT_GE(5 * CHUNK, capacity);
+
+		// oversized chunks of nested scopes are released when leaving those scopes
+		auto outer = arena.enter();
+		arena.allocate(CHUNK / 2, 8);
+		auto inner = arena.enter();
+		auto a = arena.allocate(2 * CHUNK, 8);
+		EXPECT_TRUE(arena.contains(a));
+		arena.leave(inner);
+		EXPECT_EQ(capacity, arena.getCapacity());
+		arena.leave(outer);
+		EXPECT_EQ(capacity, arena.getCapacity());
+	}
+
+	TEST(TaskLocalAllocator, Scopes) {
+
+		// outside of scopes, memory is obtained from the global heap
+		std::vector<int,TaskLocalAllocator<int>> outer(10, 1);
+		EXPECT_FALSE(detail::getLocalTaskArena().contains(outer.data()));
+
+		{
+			TaskArenaScope scope;
+
+			// within a scope, memory is served by the arena
+			std::vector<int,TaskLocalAllocator<int>> list;
+			for(int i=0; i<1000; i++) {
+				list.push_back(i);
+			}
+			EXPECT_TRUE(detail::getLocalTaskArena().contains(list.data()));
+			for(int i=0; i<1000; i++) {
+				EXPECT_EQ(i, list[i]);
+			}
+
+			// heap memory obtained before may still be freed
+			outer.clear();
+			outer.shrink_to_fit();
+
+			// large blocks are served by the arena as well
+			std::vector<char,TaskLocalAllocator<char>> large(3 * detail::TaskArena::CHUNK_SIZE, 'x');
+			EXPECT_TRUE(detail::getLocalTaskArena().contains(large.data()));
+			EXPECT_EQ('x', large.back());
+		}
+
+		// memory of large blocks is not retained beyond the scope
+		EXPECT_GT(3 * std::size_t(detail::TaskArena::CHUNK_SIZE), detail::getLocalTaskArena().getCapacity());
+
+		// every thread has its own arena
+		std::thread([]{
+			TaskArenaScope scope;
+			std::vector<int,TaskLocalAllocator<int>> list(10);
+			EXPECT_TRUE(detail::getLocalTaskArena().contains(list.data()));
+		}).join();
+	}
+
+} // end namespace reference
+} // end namespace impl
+} // end namespace core
+} // end namespace api
+} // end namespace allscale
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "allscale/api/core/impl/reference/clock.h"
+
+namespace allscale {
+namespace api {
+namespace core {
+namespace impl {
+namespace reference {
+
+	namespace {
+
+		uint64_t getMonotonicTime() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()
+			).count();
+		}
+
+	}
+
+	TEST(TscClock, Progress) {
+		auto a = TscClock::now();
+		auto b = TscClock::nowOrdered();
+		auto c = TscClock::now();
+		EXPECT_LE(a, b);
+		EXPECT_LE(b, c);
+		EXPECT_LT(a, c);
+	}
+
+	TEST(TscClock, Calibration) {
+		TscClock::calibrate();
+		EXPECT_LT(0, TscClock::getTicksPerNanosecond());
+
+		// converted time stamps match the monotonic system clock
+		auto ticks = TscClock::now();
+		auto ns = getMonotonicTime();
+		auto converted = TscClock::toNanoseconds(ticks);
+		EXPECT_NEAR(double(ns), double(converted), 1e6);
+	}
+
+	TEST(TscClock, Duration) {
+		auto ticks = TscClock::nowOrdered();
+		auto ns = getMonotonicTime();
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		auto elapsedTicks = TscClock::nowOrdered() - ticks;
+		auto elapsed = getMonotonicTime() - ns;
+
+		// the converted duration is within 10% of the measured one
+		auto converted = TscClock::toDuration(elapsedTicks).count();
+		EXPECT_NEAR(double(elapsed), double(converted), elapsed * 0.1);
+		EXPECT_NEAR(double(TscClock::toNanoseconds(ticks + elapsedTicks) - TscClock::toNanoseconds(ticks)), double(converted), 1000);
+	}
+
+	namespace {
+
+		template<typename Op>
+		double measureNanosecondsPerCall(const Op& op) {
+			const int N = 1000000;
+			uint64_t sink = 0;
+			auto start = std::chrono::steady_clock::now();
+			for(int i=0; i<N; i++) {
+				sink += op();
+			}
+			auto time = std::chrono::steady_clock::now() - start;
+			EXPECT_NE(0, sink);
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count() / double(N);
+		}
+
+	}
+
+	TEST(Benchmark, TimestampCost) {
+		std::cout << "TscClock::now():        " << measureNanosecondsPerCall([]() { return TscClock::now(); }) << "ns\n";
+		std::cout << "TscClock::nowOrdered(): " << measureNanosecondsPerCall([]() { return TscClock::nowOrdered(); }) << "ns\n";
+		std::cout << "steady_clock::now():    " << measureNanosecondsPerCall([]() { return uint64_t(std::chrono::steady_clock::now().time_since_epoch().count()); }) << "ns\n";
+	}
+
+} // end namespace reference
+} // end namespace impl
+} // end namespace core
+} // end namespace api
+} // end namespace allscale
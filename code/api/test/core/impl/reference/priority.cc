@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "allscale/api/core/impl/reference/priority.h"
+#include "allscale/api/core/impl/reference/treeture.h"
+
+namespace allscale {
+namespace api {
+namespace core {
+namespace impl {
+namespace reference {
+
+	TEST(TaskPriority, Print) {
+		std::stringstream out;
+		out << TaskPriority::Low << "," << TaskPriority::Normal << "," << TaskPriority::High;
+		EXPECT_EQ("low,normal,high", out.str());
+	}
+
+	TEST(TaskPriority, Scope) {
+		EXPECT_EQ(TaskPriority::Normal, getCurrentTaskPriority());
+		{
+			TaskPriorityScope a(TaskPriority::High);
+			EXPECT_EQ(TaskPriority::High, getCurrentTaskPriority());
+			{
+				TaskPriorityScope b(TaskPriority::Low);
+				EXPECT_EQ(TaskPriority::Low, getCurrentTaskPriority());
+			}
+			EXPECT_EQ(TaskPriority::High, getCurrentTaskPriority());
+		}
+		EXPECT_EQ(TaskPriority::Normal, getCurrentTaskPriority());
+	}
+
+	namespace {
+
+		unreleased_treeture<int> fib(int x, std::atomic<int>& mismatches) {
+			if (x <= 1) return done(x);
+			return spawn<false>(
+				[=,&mismatches]() {
+					if (getCurrentTaskPriority() != TaskPriority::Low) mismatches++;
+					int a = 0, b = 1;
+					for(int i=0; i<x; i++) { int c = a + b; a = b; b = c; }
+					return a;
+				},
+				[=,&mismatches]() {
+					if (getCurrentTaskPriority() != TaskPriority::Low) mismatches++;
+					return combine(fib(x-1,mismatches), fib(x-2,mismatches), [](int a, int b) { return a + b; });
+				}
+			);
+		}
+
+	}
+
+	TEST(TaskPriority, Inheritance) {
+		std::atomic<int> mismatches(0);
+
+		// tasks created in a scope obtain its priority, sub-tasks inherit it, also when being split
+		auto res = [&]() {
+			TaskPriorityScope scope(TaskPriority::Low);
+			return fib(16,mismatches).release();
+		}();
+		EXPECT_EQ(TaskPriority::Normal, getCurrentTaskPriority());
+		EXPECT_EQ(987, res.get());
+		EXPECT_EQ(0, mismatches);
+
+		// tasks spawned by a task inherit its priority
+		auto outer = [&]() {
+			TaskPriorityScope scope(TaskPriority::High);
+			return spawn<true>([]() {
+				return spawn<true>([]() { return getCurrentTaskPriority(); }).release().get();
+			}).release();
+		}();
+		EXPECT_EQ(TaskPriority::High, outer.get());
+	}
+
+	namespace {
+
+		int nestedFib(int x) {
+			if (x <= 1) return x;
+			auto a = spawn<false>([=]() { return nestedFib(x-1); }).release();
+			auto b = spawn<false>([=]() { return nestedFib(x-2); }).release();
+			return a.get() + b.get();
+		}
+
+	}
+
+	TEST(TaskPriority, AwaitUrgent) {
+
+		// waiting tasks look for sub-tasks in the high priority queues while other workers steal from them
+		for(int i=0; i<10; i++) {
+			auto res = [&]() {
+				TaskPriorityScope scope(TaskPriority::High);
+				return spawn<true>([]() { return nestedFib(15); }).release();
+			}();
+			EXPECT_EQ(610, res.get());
+		}
+	}
+
+	TEST(TaskPriority, Order) {
+
+		// the sequence of tasks processed by the thread creating them
+		std::mutex lock;
+		std::vector<TaskPriority> order;
+
+		spawn<true>([&]() {
+			auto self = std::this_thread::get_id();
+			std::vector<treeture<void>> tasks;
+
+			// create tasks of all priorities, highest first, before processing any of them
+			for(auto priority : { TaskPriority::High, TaskPriority::Normal, TaskPriority::Low }) {
+				TaskPriorityScope scope(priority);
+				for(int i=0; i<10; i++) {
+					tasks.push_back(spawn<false>([&,self,priority]() {
+						if (std::this_thread::get_id() != self) return;
+						std::lock_guard<std::mutex> guard(lock);
+						order.push_back(priority);
+					}));
+				}
+			}
+
+			for(auto& cur : tasks) cur.wait();
+		}).release().wait();
+
+		// tasks of higher priority have been processed first, although created first
+		EXPECT_FALSE(order.empty());
+		for(std::size_t i=1; i<order.size(); i++) {
+			EXPECT_GE(order[i-1], order[i]) << "Position " << i;
+		}
+	}
+
+} // end namespace reference
+} // end namespace impl
+} // end namespace core
+} // end namespace api
+} // end namespace allscale
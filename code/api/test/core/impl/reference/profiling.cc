@@ -1,6 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
 #include <sstream>
+#include <string>
+#include <thread>
 #include <vector>
 
 #define ENABLE_PROFILING
@@ -122,6 +128,22 @@ namespace reference {
 		return f.good();
 	}
 
+	TEST(ProfileLog, Timestamps) {
+		std::stringstream buffer(std::ios_base::out | std::ios_base::in | std::ios_base::binary);
+
+		ProfileLog log;
+		log << ProfileLogEntry::createWorkerCreatedEntry();
+		log.saveTo(buffer);
+
+		// saved time stamps are given in nanoseconds of the monotonic system clock
+		auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()
+		).count();
+		auto loaded = ProfileLog::loadFrom(buffer);
+		ASSERT_NE(loaded.begin(), loaded.end());
+		EXPECT_NEAR(double(now), double((*loaded.begin()).getTimestamp()), 1e9);
+	}
+
 	TEST(ProfileLog, WorkerPoolProfiling) {
 
 		int poolsize = 0;
@@ -150,6 +172,356 @@ namespace reference {
 
 	}
 
+	namespace {
+
+		int count(const std::string& str, const std::string& pattern) {
+			int res = 0;
+			for(auto pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + 1)) {
+				res++;
+			}
+			return res;
+		}
+
+	}
+
+	TEST(TraceExport, Empty) {
+		std::stringstream out;
+		exportTrace({}, out);
+		EXPECT_EQ("[\n]\n", out.str());
+	}
+
+	TEST(TraceExport, Events) {
+
+		TaskID root(1);
+		TaskID left = root.getLeftChild();
+		TaskID right = root.getRightChild();
+
+		// worker 0 splits the root task and processes the left half
+		ProfileLog a;
+		a << ProfileLogEntry::createTaskSplitEntry(root);
+		a << ProfileLogEntry::createTaskStartedEntry(left);
+		a << ProfileLogEntry::createTaskEndedEntry(left);
+		a << ProfileLogEntry::createWorkerSuspendedEntry();
+		a << ProfileLogEntry::createWorkerResumedEntry();
+
+		// worker 1 steals the right half, which remains unfinished
+		ProfileLog b;
+		b << ProfileLogEntry::createWorkerCreatedEntry();
+		b << ProfileLogEntry::createTaskStolenEntry(right);
+		b << ProfileLogEntry::createTaskStartedEntry(right);
+
+		std::vector<ProfileLog> logs;
+		logs.push_back(std::move(a));
+		logs.push_back(std::move(b));
+
+		std::stringstream buffer;
+		exportTrace(logs, buffer);
+		auto trace = buffer.str();
+
+		// a list of events
+		EXPECT_EQ('[', trace.front());
+		EXPECT_EQ("]\n", trace.substr(trace.size()-2));
+		EXPECT_EQ(count(trace, "{"), count(trace, "}"));
+
+		// one thread name per worker
+		EXPECT_EQ(2, count(trace, "\"thread_name\""));
+		EXPECT_EQ(1, count(trace, "\"name\":\"Worker 1\""));
+
+		// slices: two tasks, one idle phase, a split and a steal
+		EXPECT_EQ(5, count(trace, "\"ph\":\"X\""));
+		EXPECT_EQ(1, count(trace, "\"name\":\"T-1.0\",\"cat\":\"task\""));
+		EXPECT_EQ(1, count(trace, "\"name\":\"T-1.1\",\"cat\":\"task\""));
+		EXPECT_EQ(1, count(trace, "\"name\":\"idle\""));
+		EXPECT_EQ(1, count(trace, "\"name\":\"split T-1\""));
+		EXPECT_EQ(1, count(trace, "\"name\":\"steal T-1.1\""));
+
+		// flows from the split to the sub-tasks, passing the steal
+		EXPECT_EQ(2, count(trace, "\"ph\":\"s\""));
+		EXPECT_EQ(1, count(trace, "\"ph\":\"t\""));
+		EXPECT_EQ(2, count(trace, "\"ph\":\"f\""));
+		EXPECT_EQ(2, count(trace, "\"id\":\"T-1.0\""));
+		EXPECT_EQ(3, count(trace, "\"id\":\"T-1.1\""));
+
+		// the trace starts at time 0
+		EXPECT_EQ(1, count(trace, "\"ts\":0.000,"));
+	}
+
+	TEST(TraceExport, Streaming) {
+		std::stringstream buffer;
+		TraceEventWriter writer(buffer);
+		TraceConverter converter(writer);
+
+		// events are written as they are processed
+		converter.process(3, ProfileLogEntry::createTaskStartedEntry(TaskID(2)));
+		auto size = buffer.str().size();
+		EXPECT_EQ(1, count(buffer.str(), "\"name\":\"Worker 3\""));
+		converter.process(3, ProfileLogEntry::createTaskEndedEntry(TaskID(2)));
+		EXPECT_LT(size, buffer.str().size());
+		EXPECT_EQ(1, count(buffer.str(), "\"name\":\"T-2\""));
+
+		// unfinished phases are closed at the end
+		converter.process(3, ProfileLogEntry::createWorkerSuspendedEntry());
+		EXPECT_EQ(0, count(buffer.str(), "\"name\":\"idle\""));
+		converter.finish();
+		EXPECT_EQ(1, count(buffer.str(), "\"name\":\"idle\""));
+	}
+
+	TEST(ProfilingMode, Names) {
+		EXPECT_EQ(ProfilingMode::Full, parseProfilingMode("full"));
+		EXPECT_EQ(ProfilingMode::Stream, parseProfilingMode("stream"));
+		EXPECT_EQ(ProfilingMode::Recent, parseProfilingMode("recent"));
+		EXPECT_EQ(ProfilingMode::Stream, parseProfilingMode("unknown", ProfilingMode::Stream));
+	}
+
+	TEST(ProfileRingBuffer, PushDrain) {
+		ProfileRingBuffer buffer(5);
+		EXPECT_EQ(8, buffer.getCapacity());
+
+		// fill the buffer beyond its capacity
+		for(int i=0; i<10; i++) {
+			EXPECT_EQ(i < 8, buffer.push(ProfileLogEntry::createTaskStartedEntry(TaskID(i))));
+		}
+		EXPECT_EQ(8, buffer.size());
+		EXPECT_EQ(2, buffer.getNumDropped());
+
+		// entries are drained in order
+		std::vector<int> ids;
+		EXPECT_EQ(8, buffer.drain([&](const ProfileLogEntry& e) { ids.push_back(int(e.getTask().getRootID())); }));
+		EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3, 4, 5, 6, 7 }), ids);
+		EXPECT_EQ(0, buffer.size());
+
+		// space is reclaimed
+		EXPECT_TRUE(buffer.push(ProfileLogEntry::createTaskStartedEntry(TaskID(10))));
+		EXPECT_EQ(1, buffer.drain([](const ProfileLogEntry&) {}));
+	}
+
+	TEST(ProfileRingBuffer, Concurrent) {
+		const int N = 100000;
+		ProfileRingBuffer buffer(1024);
+
+		std::thread producer([&]() {
+			for(int i=0; i<N; i++) {
+				while(!buffer.push(ProfileLogEntry::createTaskStartedEntry(TaskID(i)))) {
+					std::this_thread::yield();
+				}
+			}
+		});
+
+		// all entries are received in order
+		int next = 0;
+		bool ordered = true;
+		while(next < N) {
+			buffer.drain([&](const ProfileLogEntry& e) {
+				ordered = ordered && (int(e.getTask().getRootID()) == next);
+				next++;
+			});
+		}
+		producer.join();
+
+		EXPECT_TRUE(ordered);
+		EXPECT_EQ(N, next);
+	}
+
+	namespace {
+
+		std::vector<ProfileLogEntry> createEntries(uint64_t begin, int num) {
+			std::vector<ProfileLogEntry> res;
+			TaskID task(42);
+			for(int i=0; i<num; i++) {
+				res.push_back(ProfileLogEntry::restore(begin + i * 10, ProfileLogEntry::Kind(i % 9), task));
+				if (task.getDepth() == 60) task = TaskID(42);
+				task = (i % 3) ? task.getRightChild() : task.getLeftChild();
+			}
+			return res;
+		}
+
+		std::vector<ProfileLogEntry> toVector(const ProfileLog& log) {
+			std::vector<ProfileLogEntry> res;
+			for(const auto& cur : log) res.push_back(cur);
+			return res;
+		}
+
+		void expectEqual(const std::vector<ProfileLogEntry>& a, const std::vector<ProfileLogEntry>& b) {
+			ASSERT_EQ(a.size(), b.size());
+			for(std::size_t i=0; i<a.size(); i++) {
+				EXPECT_EQ(a[i].getTimestamp(), b[i].getTimestamp());
+				EXPECT_EQ(a[i].getKind(), b[i].getKind());
+				EXPECT_EQ(a[i].getTask(), b[i].getTask());
+			}
+		}
+
+	}
+
+	TEST(ChunkedProfileLog, Encoding) {
+		auto entries = createEntries(1000*1000*1000, 60);
+
+		// entries are compressed
+		auto data = detail::encodeChunk(entries);
+		EXPECT_GT(entries.size() * sizeof(ProfileLogEntry) / 2, data.size());
+
+		std::vector<ProfileLogEntry> decoded;
+		EXPECT_TRUE(detail::decodeChunk(data, [&](const ProfileLogEntry& e) { decoded.push_back(e); }));
+		expectEqual(entries, decoded);
+
+		// truncated chunks are detected
+		EXPECT_FALSE(detail::decodeChunk(data.substr(0, data.size() - 3), [](const ProfileLogEntry&) {}));
+	}
+
+	TEST(ChunkedProfileLog, Stream) {
+		auto file = ::testing::TempDir() + "allscale_profile_log_stream";
+		auto a = createEntries(0, 50);
+		auto b = createEntries(500, 50);
+
+		{
+			ChunkedProfileLogFile log(file, ProfilingMode::Stream);
+
+			// the file is valid after each chunk
+			log.write(a);
+			expectEqual(a, toVector(ProfileLog::loadFrom(file)));
+			log.write(b);
+		}
+
+		auto all = a;
+		all.insert(all.end(), b.begin(), b.end());
+		expectEqual(all, toVector(ProfileLog::loadFrom(file)));
+
+		// a truncated file, e.g. due to a crash, retains complete chunks
+		std::string content;
+		{
+			std::ifstream in(file, std::ios::binary);
+			content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+		}
+		{
+			std::ofstream out(file, std::ios::binary | std::ios::trunc);
+			out.write(content.data(), content.size() - 5);
+		}
+		expectEqual(a, toVector(ProfileLog::loadFrom(file)));
+
+		std::remove(file.c_str());
+	}
+
+	TEST(ChunkedProfileLog, Recent) {
+		auto file = ::testing::TempDir() + "allscale_profile_log_recent";
+
+		// retain the last 1000ns
+		ChunkedProfileLogFile log(file, ProfilingMode::Recent, 1000);
+		for(int i=0; i<10; i++) {
+			log.write(createEntries(i * 500, 50));
+		}
+
+		// the current segment is rotated whenever it covers 1000ns
+		EXPECT_EQ(4, log.getNumChunks());
+		auto current = toVector(ProfileLog::loadFrom(file));
+		ASSERT_EQ(50, current.size());
+		EXPECT_EQ(4500, current.front().getTimestamp());
+
+		// the previous segment is retained, such that at least the last 1000ns are covered
+		auto entries = toVector(ProfileLog::loadRecentFrom(file));
+		ASSERT_EQ(200, entries.size());
+		EXPECT_EQ(3000, entries.front().getTimestamp());
+		EXPECT_EQ(4990, entries.back().getTimestamp());
+		for(std::size_t i=1; i<entries.size(); i++) {
+			EXPECT_LT(entries[i-1].getTimestamp(), entries[i].getTimestamp());
+		}
+
+		std::remove(file.c_str());
+		std::remove((file + ".old").c_str());
+	}
+
+	TEST(ChunkedProfileLog, Flusher) {
+		auto file = ::testing::TempDir() + "allscale_profile_log_flusher";
+		auto entries = createEntries(0, 100);
+
+		detail::BoundedProfileLog log(64, file, ProfilingMode::Stream, 0);
+		auto& flusher = detail::ProfileLogFlusher::getInstance();
+		flusher.add(log);
+
+		// entries are written by the flusher, flushing before entries would be dropped
+		for(const auto& cur : entries) {
+			if (log.buffer.size() == log.buffer.getCapacity()) flusher.flushAll();
+			EXPECT_TRUE(log.buffer.push(cur));
+		}
+		flusher.remove(log);
+
+		// time stamps are converted into nanoseconds
+		for(auto& cur : entries) cur = cur.toNanoseconds();
+		expectEqual(entries, toVector(ProfileLog::loadFrom(file)));
+
+		std::remove(file.c_str());
+	}
+
+	TEST(ChunkedProfileLog, Dropped) {
+		auto file = ::testing::TempDir() + "allscale_profile_log_dropped";
+
+		// not registered at the flusher, to control the time of flushes
+		detail::BoundedProfileLog log(8, file, ProfilingMode::Stream, 0);
+
+		// overflow the buffer
+		for(int i=0; i<10; i++) {
+			log.buffer.push(ProfileLogEntry::createTaskStartedEntry(TaskID(i)));
+		}
+		log.flush();
+
+		// nothing dropped since the last flush, nothing to report
+		log.buffer.push(ProfileLogEntry::createTaskStartedEntry(TaskID(10)));
+		log.flush();
+
+		// the loss is recorded in the log after the retained entries
+		auto entries = toVector(ProfileLog::loadFrom(file));
+		ASSERT_EQ(10, entries.size());
+		EXPECT_EQ(ProfileLogEntry::TaskStarted, entries[7].getKind());
+		EXPECT_EQ(ProfileLogEntry::EntriesDropped, entries[8].getKind());
+		EXPECT_EQ(2, entries[8].getNumDropped());
+		EXPECT_EQ(TaskID(10), entries[9].getTask());
+
+		// and shows up in traces
+		std::stringstream trace;
+		TraceEventWriter writer(trace);
+		TraceConverter converter(writer);
+		converter.process(0, entries[8]);
+		EXPECT_EQ(1, count(trace.str(), "\"name\":\"lost 2 events\""));
+
+		std::remove(file.c_str());
+	}
+
+	TEST(ChunkedProfileLog, OnlineTrace) {
+		auto file = ::testing::TempDir() + "allscale_profile_log_online";
+		auto traceFile = ::testing::TempDir() + "allscale_profile_trace_online.json";
+
+		auto readTrace = [&]() {
+			std::ifstream in(traceFile);
+			return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+		};
+
+		detail::OnlineTrace trace(traceFile);
+		detail::BoundedProfileLog log(64, file, ProfilingMode::Stream, 0, &trace, 5);
+		auto& flusher = detail::ProfileLogFlusher::getInstance();
+		flusher.add(log);
+
+		// flushed events are visible in the trace while the worker is still running
+		log.buffer.push(ProfileLogEntry::createTaskStartedEntry(TaskID(7)));
+		log.buffer.push(ProfileLogEntry::createTaskEndedEntry(TaskID(7)));
+		log.buffer.push(ProfileLogEntry::createTaskStartedEntry(TaskID(8)));
+		flusher.flushAll();
+		EXPECT_EQ(1, count(readTrace(), "\"name\":\"Worker 5\""));
+		EXPECT_EQ(1, count(readTrace(), "\"name\":\"T-7\""));
+
+		// tasks spanning several flushes are completed by later chunks
+		log.buffer.push(ProfileLogEntry::createTaskEndedEntry(TaskID(8)));
+		flusher.flushAll();
+		EXPECT_EQ(1, count(readTrace(), "\"name\":\"T-8\""));
+
+		// unfinished slices are closed when the worker terminates
+		log.buffer.push(ProfileLogEntry::createWorkerSuspendedEntry());
+		flusher.remove(log);
+		EXPECT_EQ(0, count(readTrace(), "\"name\":\"idle\""));
+		trace.finish(5);
+		EXPECT_EQ(1, count(readTrace(), "\"name\":\"idle\""));
+
+		std::remove(file.c_str());
+		std::remove(traceFile.c_str());
+	}
+
 } // end namespace reference
 } // end namespace impl
 } // end namespace core
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <vector>
 
 #include "allscale/api/core/impl/reference/queue.h"
@@ -170,6 +173,247 @@ namespace reference {
 
 	}
 
+	TEST(WorkStealingQueue, Basic) {
+
+		WorkStealingQueue<int*> queue;
+
+		int a = 1;
+		int b = 2;
+
+		EXPECT_TRUE(queue.empty());
+		EXPECT_EQ(0, queue.size());
+		EXPECT_EQ(nullptr, queue.pop_front());
+		EXPECT_EQ(nullptr, queue.try_pop_back());
+
+		queue.push_front(&a);
+		EXPECT_FALSE(queue.empty());
+		EXPECT_EQ(1, queue.size());
+
+		EXPECT_EQ(&a, queue.pop_front());
+		EXPECT_TRUE(queue.empty());
+		EXPECT_EQ(0, queue.size());
+
+		queue.push_front(&b);
+		EXPECT_EQ(&b, queue.try_pop_back());
+		EXPECT_TRUE(queue.empty());
+		EXPECT_EQ(nullptr, queue.pop_front());
+
+	}
+
+	TEST(WorkStealingQueue, Order) {
+
+		WorkStealingQueue<int*> queue;
+
+		std::array<int,6> data;
+
+		// fill the queue
+		for(auto& cur : data) {
+			queue.push_front(&cur);
+		}
+		EXPECT_EQ(6, queue.size());
+
+		// the owner obtains elements in LIFO order
+		EXPECT_EQ(&data[5], queue.pop_front());
+		EXPECT_EQ(&data[4], queue.pop_front());
+
+		// thieves obtain elements in FIFO order
+		EXPECT_EQ(&data[0], queue.try_pop_back());
+		EXPECT_EQ(&data[1], queue.pop_back());
+
+		// the snapshot lists the remaining elements from back to front
+		EXPECT_EQ(std::vector<int*>({ &data[2], &data[3] }), queue.getSnapshot());
+
+		EXPECT_EQ(&data[3], queue.pop_front());
+		EXPECT_EQ(&data[2], queue.pop_front());
+		EXPECT_EQ(nullptr, queue.pop_front());
+		EXPECT_EQ(nullptr, queue.pop_back());
+
+	}
+
+	namespace {
+
+		struct ValueOf {
+			int operator()(int* x) const {
+				return *x;
+			}
+		};
+
+	}
+
+	TEST(WorkStealingQueue, Conditional) {
+
+		WorkStealingQueue<int*,ValueOf> queue;
+
+		std::array<int,4> data = {{ 0, 1, 2, 3 }};
+		auto isEven = [](int x) { return x % 2 == 0; };
+
+		EXPECT_EQ(nullptr, queue.pop_front_if(isEven));
+		EXPECT_EQ(nullptr, queue.try_pop_back_if(isEven));
+
+		for(auto& cur : data) {
+			queue.push_front(&cur);
+		}
+
+		// only elements at the ends satisfying the predicate are removed
+		EXPECT_EQ(nullptr, queue.pop_front_if(isEven));
+		EXPECT_EQ(&data[0], queue.try_pop_back_if(isEven));
+		EXPECT_EQ(nullptr, queue.try_pop_back_if(isEven));
+		EXPECT_EQ(3, queue.size());
+
+		EXPECT_EQ(&data[3], queue.pop_front());
+		EXPECT_EQ(&data[2], queue.pop_front_if(isEven));
+		EXPECT_EQ(nullptr, queue.pop_front_if(isEven));
+		EXPECT_EQ(1, queue.size());
+
+	}
+
+	TEST(WorkStealingQueue, ConditionalGrowth) {
+
+		const int N = 100;
+
+		// keys need to be preserved while growing the buffer
+		WorkStealingQueue<int*,ValueOf> queue(2);
+
+		std::vector<int> data(N);
+		for(int i=0; i<N; i++) {
+			data[i] = i;
+			queue.push_front(&data[i]);
+		}
+
+		auto isEven = [](int x) { return x % 2 == 0; };
+		EXPECT_EQ(&data[0], queue.try_pop_back_if(isEven));
+		EXPECT_EQ(nullptr, queue.try_pop_back_if(isEven));
+		EXPECT_EQ(nullptr, queue.pop_front_if(isEven));
+		EXPECT_EQ(&data[N-1], queue.pop_front());
+		EXPECT_EQ(&data[N-2], queue.pop_front_if(isEven));
+
+	}
+
+	TEST(WorkStealingQueue, Growth) {
+
+		const int N = 10000;
+
+		// start with a small buffer to enforce several growth steps
+		WorkStealingQueue<int*> queue(2);
+
+		std::vector<int> data(N);
+
+		for(int i=0; i<N; i++) {
+			queue.push_front(&data[i]);
+			EXPECT_EQ(i+1, queue.size());
+		}
+
+		// remove half from the back
+		for(int i=0; i<N/2; i++) {
+			EXPECT_EQ(&data[i], queue.try_pop_back());
+		}
+
+		// and the rest from the front
+		for(int i=N-1; i>=N/2; i--) {
+			EXPECT_EQ(&data[i], queue.pop_front());
+		}
+
+		EXPECT_TRUE(queue.empty());
+
+	}
+
+	TEST(WorkStealingQueue, BatchPush) {
+
+		const int N = 100;
+
+		// start with a small buffer to enforce growth during a batch
+		WorkStealingQueue<int*> queue(2);
+
+		std::vector<int> data(N);
+		std::vector<int*> ptrs;
+		for(auto& cur : data) ptrs.push_back(&cur);
+
+		queue.push_front(ptrs[0]);
+		queue.push_front(&ptrs[1], N-2);
+		queue.push_front(ptrs[N-1]);
+		EXPECT_EQ(N, queue.size());
+
+		// the order is the same as if pushed individually
+		EXPECT_EQ(&data[0], queue.try_pop_back());
+		EXPECT_EQ(&data[1], queue.try_pop_back());
+		for(int i=N-1; i>=2; i--) {
+			EXPECT_EQ(&data[i], queue.pop_front());
+		}
+
+		EXPECT_TRUE(queue.empty());
+
+		// pushing an empty batch is fine too
+		queue.push_front(ptrs.data(), 0);
+		EXPECT_TRUE(queue.empty());
+	}
+
+	TEST(UnboundQueue, BatchPush) {
+
+		UnboundQueue<int> queue;
+		int data[] = { 1, 2, 3 };
+
+		queue.push_back(0);
+		queue.push_back(data, 3);
+		EXPECT_EQ(4, queue.size());
+
+		EXPECT_EQ(0, queue.pop_front());
+		EXPECT_EQ(3, queue.pop_back());
+		EXPECT_EQ(1, queue.pop_front());
+		EXPECT_EQ(2, queue.pop_front());
+		EXPECT_TRUE(queue.empty());
+	}
+
+	TEST(WorkStealingQueue, ConcurrentStealing) {
+
+		const int N = 100000;
+		const int T = 4;
+
+		WorkStealingQueue<int*> queue(4);
+
+		std::vector<int> data(N,0);
+
+		std::atomic<int> processed(0);
+		std::atomic<bool> done(false);
+
+		// a utility to process an element
+		auto process = [&](int* cur) {
+			(*cur)++;
+			processed++;
+		};
+
+		// start some thieves
+		std::vector<std::thread> thieves;
+		for(int t=0; t<T; t++) {
+			thieves.emplace_back([&]{
+				while(!done || !queue.empty()) {
+					if (int* cur = queue.try_pop_back()) process(cur);
+				}
+			});
+		}
+
+		// the owner is producing and consuming elements
+		for(int i=0; i<N; i++) {
+			queue.push_front(&data[i]);
+			if (i % 3 == 0) {
+				if (int* cur = queue.pop_front()) process(cur);
+			}
+		}
+		while(int* cur = queue.pop_front()) {
+			process(cur);
+		}
+
+		// wait for the thieves
+		done = true;
+		for(auto& cur : thieves) {
+			cur.join();
+		}
+
+		// every element has to be processed exactly once
+		EXPECT_EQ(N, processed);
+		EXPECT_TRUE(std::all_of(data.begin(), data.end(), [](int x) { return x == 1; }));
+
+	}
+
 } // end namespace reference
 } // end namespace impl
 } // end namespace core
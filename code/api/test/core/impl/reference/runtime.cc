@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include "allscale/api/core/impl/reference/treeture.h"
@@ -399,6 +401,36 @@ namespace reference {
 //		EXPECT_EQ(STRESS_RES, fib_split(STRESS_N).get());
 	}
 
+	TEST(Runtime, Statistics) {
+		auto& pool = runtime::WorkerPool::getInstance();
+
+		auto before = pool.getStatistics();
+		EXPECT_EQ(pool.getNumWorkers(), (int)before.workers.size());
+
+		EXPECT_EQ(6765, fib_split(20).get());
+
+		auto after = pool.getStatistics();
+		ASSERT_EQ(before.workers.size(), after.workers.size());
+
+		// counters only grow
+		for(std::size_t i=0; i<after.workers.size(); ++i) {
+			EXPECT_LE(before.workers[i].tasksExecuted, after.workers[i].tasksExecuted);
+			EXPECT_LE(before.workers[i].tasksSplit, after.workers[i].tasksSplit);
+			EXPECT_LE(before.workers[i].idleTime, after.workers[i].idleTime);
+			EXPECT_LE(before.workers[i].queueHighWaterMark, after.workers[i].queueHighWaterMark);
+		}
+
+		// some work has been conducted
+		auto total = after.getTotal();
+		EXPECT_LT(before.getTotal().tasksExecuted, total.tasksExecuted);
+		EXPECT_LT(0, total.tasksSplit);
+
+		// statistics can be printed
+		std::stringstream out;
+		out << after;
+		EXPECT_NE(std::string::npos, out.str().find("Total: executed: "));
+	}
+
 } // end namespace reference
 } // end namespace impl
 } // end namespace core
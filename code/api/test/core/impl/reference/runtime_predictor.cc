@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <cstdio>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 #include "allscale/api/core/impl/reference/runtime_predictor.h"
@@ -48,12 +50,131 @@ namespace reference {
 
 		predictor.registerTime(6,duration(64000));
 
-		EXPECT_LT(duration(256000),predictor.predictTime(3));
-		EXPECT_LT(duration(128000),predictor.predictTime(4));
-		EXPECT_LT(duration(64000),predictor.predictTime(5));
-		EXPECT_LT(duration(32000),predictor.predictTime(6));
-		EXPECT_LT(duration(16000),predictor.predictTime(7));
+		// only the measured levels are updated, the others are derived from the closest measured level
+		EXPECT_EQ(duration(256000),predictor.predictTime(3));
+		EXPECT_EQ(duration(128000),predictor.predictTime(4));
+		EXPECT_EQ(duration(64000),predictor.predictTime(5));
+		EXPECT_EQ(duration(64000),predictor.predictTime(6));
+		EXPECT_EQ(duration(32000),predictor.predictTime(7));
+		EXPECT_EQ(1,predictor.getNumSamples(6));
+		EXPECT_EQ(0,predictor.getNumSamples(7));
+
+		// levels too far away from any measured level retain their initial estimate
+		EXPECT_EQ(duration::max(),predictor.predictTime(0));
+		EXPECT_EQ(duration::zero(),predictor.predictTime(20));
+
+	}
+
+	TEST(RuntimePredictor, Concurrent) {
+		RuntimePredictor predictor;
+
+		// concurrent updates of the same level are not lost
+		const int N = 10000;
+		std::vector<std::thread> threads;
+		for(int t=0; t<4; t++) {
+			threads.emplace_back([&]() {
+				for(int i=0; i<N; i++) predictor.registerTime(10,duration(64000));
+			});
+		}
+		for(auto& cur : threads) cur.join();
+
+		EXPECT_EQ(4 * N, predictor.getNumSamples(10));
+		EXPECT_EQ(duration(64000),predictor.predictTime(10));
+	}
+
+	namespace {
+		struct TaskA {};
+		struct TaskB {};
+	}
+
+	TEST(RuntimePredictor, Shared) {
+
+		// predictors are shared among threads
+		auto& a = getRuntimePredictor<TaskA>();
+		RuntimePredictor* other = nullptr;
+		std::thread([&]() { other = &getRuntimePredictor<TaskA>(); }).join();
+		EXPECT_EQ(&a, other);
+
+		// yet distinct for different task types
+		EXPECT_NE(&a, &getRuntimePredictor<TaskB>());
+	}
+
+	TEST(RuntimePredictor, SameName) {
+		auto& registry = detail::RuntimePredictorRegistry::getInstance();
+
+		// types with internal linkage in different translation units may share their name
+		static const char first = 0;
+		static const char second = 0;
+		auto& a = registry.get(&first, "duplicate_task");
+		auto& b = registry.get(&second, "duplicate_task");
+		EXPECT_NE(&a, &b);
+
+		a.registerTime(3,duration(1000));
+		EXPECT_EQ(1, a.getNumSamples(3));
+		EXPECT_EQ(0, b.getNumSamples(3));
+
+		// their predictions are not persisted, since they could not be told apart
+		std::stringstream buffer;
+		registry.save(buffer);
+		EXPECT_EQ(std::string::npos, buffer.str().find("duplicate_task"));
+	}
+
+	TEST(RuntimePredictor, SaveLoad) {
+		auto& registry = detail::RuntimePredictorRegistry::getInstance();
+
+		// tags of task types not instantiated by this program
+		static const char someTask = 0;
+		static const char otherTask = 0;
+
+		auto& a = getRuntimePredictor<TaskA>();
+		for(int i=0; i<100; i++) a.registerTime(7,duration(1000*1000));
+		auto expected = a.predictTime(7);
+
+		std::stringstream buffer;
+		registry.save(buffer);
+
+		// reset the predictions and restore them
+		for(std::size_t i=0; i<RuntimePredictor::MAX_LEVELS; i++) a.setTime(i,duration::zero(),0);
+		EXPECT_EQ(duration::zero(), a.predictTime(7));
+		EXPECT_TRUE(registry.load(buffer));
+
+		// predictions are stored in nanoseconds, thus restored up to rounding errors
+		EXPECT_NEAR(double(expected.count()), double(a.predictTime(7).count()), expected.count() * 0.01);
+		EXPECT_EQ(std::size_t(detail::RuntimePredictorRegistry::MAX_LOADED_SAMPLES), a.getNumSamples(7));
+		EXPECT_EQ(0, a.getNumSamples(20));
+
+		// predictions of types not encountered yet are loaded as well
+		std::stringstream other("some_task\t3:1000:2\n");
+		EXPECT_TRUE(registry.load(other));
+		EXPECT_EQ(2, registry.get(&someTask,"some_task").getNumSamples(3));
+
+		// type names may contain spaces (as produced by MSVC)
+		std::stringstream spaces("struct `anonymous namespace'::some_task\t3:1000:2 4:500:1 \n");
+		EXPECT_TRUE(registry.load(spaces));
+		EXPECT_EQ(2, registry.get(&otherTask,"struct `anonymous namespace'::some_task").getNumSamples(3));
+		EXPECT_EQ(1, registry.get(&otherTask,"struct `anonymous namespace'::some_task").getNumSamples(4));
+
+		// and are preserved when saving and loading again
+		std::stringstream saved;
+		registry.save(saved);
+		registry.get(&otherTask,"struct `anonymous namespace'::some_task").setTime(3,duration::zero(),0);
+		EXPECT_TRUE(registry.load(saved));
+		EXPECT_EQ(2, registry.get(&otherTask,"struct `anonymous namespace'::some_task").getNumSamples(3));
+
+		// malformed input is detected
+		std::stringstream malformed("some_task\t3-1000-2\n");
+		EXPECT_FALSE(registry.load(malformed));
+		std::stringstream unterminated("some_task 3:1000:2\n");
+		EXPECT_FALSE(registry.load(unterminated));
+	}
 
+	TEST(RuntimePredictor, SaveLoadFile) {
+		auto file = ::testing::TempDir() + "allscale_runtime_predictions";
+		getRuntimePredictor<TaskB>().registerTime(3,duration(5000));
+		EXPECT_TRUE(saveRuntimePredictors(file));
+		EXPECT_TRUE(loadRuntimePredictors(file));
+		EXPECT_FALSE(loadRuntimePredictors(file + ".missing"));
+		std::remove(file.c_str());
 	}
 
 } // end namespace reference
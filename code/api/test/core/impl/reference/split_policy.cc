@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+#include "allscale/api/core/impl/reference/split_policy.h"
+#include "allscale/api/core/impl/reference/treeture.h"
+
+namespace allscale {
+namespace api {
+namespace core {
+namespace impl {
+namespace reference {
+
+	namespace {
+
+		SplitContext createContext(std::size_t depth, std::size_t queueLength, bool stolen, std::size_t idle) {
+			SplitContext res;
+			res.depth = depth;
+			res.predictor = nullptr;
+			res.queueLength = queueLength;
+			res.stolen = stolen;
+			res.numIdleWorkers = idle;
+			res.numWorkers = 4;
+			return res;
+		}
+
+	}
+
+	TEST(SplitPolicy, Fixed) {
+		FixedThresholdSplitPolicy policy(1000, 6);
+
+		// unknown execution times are considered large
+		EXPECT_TRUE(policy.shouldSplit(createContext(3,0,false,0)));
+		EXPECT_FALSE(policy.shouldSplit(createContext(3,6,false,0)));
+		EXPECT_TRUE(policy.shouldSplit(createContext(3,6,true,0)));
+
+		// small tasks are not split
+		RuntimePredictor predictor(1);
+		predictor.registerTime(3,CycleCount(100));
+		auto context = createContext(3,0,false,0);
+		context.predictor = &predictor;
+		EXPECT_FALSE(policy.shouldSplit(context));
+
+		// except the root
+		context.depth = 0;
+		EXPECT_TRUE(policy.shouldSplit(context));
+	}
+
+	TEST(SplitPolicy, Lazy) {
+		LazySplitPolicy policy(1, 6);
+
+		// split if the local queue is empty
+		EXPECT_TRUE(policy.shouldSplit(createContext(3,0,false,0)));
+		EXPECT_FALSE(policy.shouldSplit(createContext(3,1,false,0)));
+
+		// or if there are idle workers
+		EXPECT_TRUE(policy.shouldSplit(createContext(3,1,false,2)));
+		EXPECT_FALSE(policy.shouldSplit(createContext(3,6,false,2)));
+
+		// stolen tasks are always split
+		EXPECT_TRUE(policy.shouldSplit(createContext(3,6,true,0)));
+	}
+
+	TEST(SplitPolicy, Adaptive) {
+		const int P = AdaptiveSplitPolicy::ADAPTATION_PERIOD;
+
+		AdaptiveSplitPolicy policy(100, 1000*1000, 6);
+		auto initial = policy.getThreshold();
+
+		// observations are only applied periodically
+		for(int i=0; i<P-1; i++) policy.shouldSplit(createContext(3,0,false,2));
+		EXPECT_EQ(initial, policy.getThreshold());
+
+		// idle workers lower the threshold
+		policy.shouldSplit(createContext(3,0,false,2));
+		EXPECT_LT(policy.getThreshold(), initial);
+
+		// busy workers raise it again
+		auto low = policy.getThreshold();
+		for(int i=0; i<P; i++) policy.shouldSplit(createContext(3,0,false,0));
+		EXPECT_GT(policy.getThreshold(), low);
+
+		// within bounds
+		for(int i=0; i<20*P; i++) policy.shouldSplit(createContext(3,0,false,2));
+		EXPECT_EQ(CycleCount(100), policy.getThreshold());
+		for(int i=0; i<200*P; i++) policy.shouldSplit(createContext(3,0,false,0));
+		EXPECT_EQ(CycleCount(1000*1000), policy.getThreshold());
+
+		// observations of different policies are not mixed
+		AdaptiveSplitPolicy other(100, 1000*1000, 6);
+		for(int i=0; i<P-1; i++) policy.shouldSplit(createContext(3,0,false,2));
+		for(int i=0; i<P-1; i++) other.shouldSplit(createContext(3,0,false,2));
+		policy.shouldSplit(createContext(3,0,false,2));
+		EXPECT_EQ(CycleCount(1000*1000), policy.getThreshold());
+	}
+
+	TEST(SplitPolicy, Names) {
+		EXPECT_EQ("fixed", getSplitPolicy("fixed")->getName());
+		EXPECT_EQ("lazy", getSplitPolicy("lazy")->getName());
+		EXPECT_EQ("adaptive", getSplitPolicy("adaptive")->getName());
+		EXPECT_FALSE(getSplitPolicy("unknown"));
+	}
+
+	TEST(SplitPolicy, Scope) {
+		LazySplitPolicy lazy;
+		FixedThresholdSplitPolicy fixed;
+
+		EXPECT_FALSE(getCurrentSplitPolicy());
+		{
+			SplitPolicyScope a(&lazy);
+			EXPECT_EQ(&lazy, getCurrentSplitPolicy());
+			{
+				SplitPolicyScope b(nullptr);
+				EXPECT_EQ(&lazy, getCurrentSplitPolicy());
+				SplitPolicyScope c(&fixed);
+				EXPECT_EQ(&fixed, getCurrentSplitPolicy());
+			}
+			EXPECT_EQ(&lazy, getCurrentSplitPolicy());
+		}
+		EXPECT_FALSE(getCurrentSplitPolicy());
+	}
+
+	namespace {
+
+		// a policy always splitting, counting its invocations
+		struct CountingPolicy : public SplitPolicy {
+			mutable std::atomic<int> calls { 0 };
+			bool shouldSplit(const SplitContext&) const override {
+				calls++;
+				return true;
+			}
+			std::string getName() const override {
+				return "counting";
+			}
+		};
+
+		unreleased_treeture<int> fib(int x) {
+			if (x <= 1) return done(x);
+			return spawn<false>(
+				[=]() {
+					int a = 0, b = 1;
+					for(int i=0; i<x; i++) { int c = a + b; a = b; b = c; }
+					return a;
+				},
+				[=]() {
+					return combine(fib(x-1), fib(x-2), [](int a, int b) { return a + b; });
+				}
+			);
+		}
+
+	}
+
+	TEST(SplitPolicy, TaskPolicy) {
+		CountingPolicy policy;
+
+		// tasks created in the scope of a policy utilize it, also their sub-tasks
+		auto res = [&]() {
+			SplitPolicyScope scope(&policy);
+			return fib(12).release();
+		}();
+		EXPECT_FALSE(getCurrentSplitPolicy());
+		EXPECT_EQ(144, res.get());
+		EXPECT_LT(0, policy.calls);
+	}
+
+	TEST(SplitPolicy, RuntimePolicy) {
+		auto& pool = runtime::WorkerPool::getInstance();
+		const SplitPolicy& old = pool.getSplitPolicy();
+
+		for(const auto& name : { "fixed", "lazy", "adaptive" }) {
+			pool.setSplitPolicy(*getSplitPolicy(name));
+			EXPECT_EQ(name, pool.getSplitPolicy().getName());
+			EXPECT_EQ(144, fib(12).release().get());
+		}
+
+		pool.setSplitPolicy(old);
+	}
+
+} // end namespace reference
+} // end namespace impl
+} // end namespace core
+} // end namespace api
+} // end namespace allscale
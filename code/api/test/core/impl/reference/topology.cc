@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "allscale/api/core/impl/reference/topology.h"
+
+namespace allscale {
+namespace api {
+namespace core {
+namespace impl {
+namespace reference {
+
+	namespace {
+
+		// a dual-socket system with 2 cores per socket, 2 SMT threads per core, enumerated the way linux does
+		Topology createDualSocket() {
+			std::vector<CpuInfo> cpus;
+			for(int i=0; i<8; i++) {
+				int package = (i / 2) % 2;
+				cpus.push_back({ i, i % 2, package, package * 2, package });
+			}
+			return Topology(cpus);
+		}
+
+		void writeFile(const std::string& file, const std::string& content) {
+			std::ofstream out(file);
+			out << content << "\n";
+		}
+
+		void makeDir(const std::string& dir) {
+			mkdir(dir.c_str(), 0755);
+		}
+
+	}
+
+	TEST(Topology, ParseCpuList) {
+		EXPECT_EQ(std::vector<int>(), detail::parseCpuList(""));
+		EXPECT_EQ(std::vector<int>({ 0 }), detail::parseCpuList("0"));
+		EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3 }), detail::parseCpuList("0-3"));
+		EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3, 8, 10, 11 }), detail::parseCpuList("0-3,8,10-11"));
+	}
+
+	TEST(Topology, Distance) {
+		auto topo = createDualSocket();
+		EXPECT_EQ(Topology::SameCpu, topo.getDistance(0,0));
+		EXPECT_EQ(Topology::SameCore, topo.getDistance(0,4));
+		EXPECT_EQ(Topology::SameL3, topo.getDistance(0,1));
+		EXPECT_EQ(Topology::SameL3, topo.getDistance(0,5));
+		EXPECT_EQ(Topology::Remote, topo.getDistance(0,2));
+		EXPECT_EQ(Topology::Remote, topo.getDistance(0,7));
+	}
+
+	TEST(Topology, Placement) {
+		auto topo = createDualSocket();
+
+		EXPECT_EQ(std::vector<int>({ 0, 4, 1, 5, 2, 6, 3, 7 }), topo.getPlacement(PlacementPolicy::Compact, 8));
+		EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3, 4, 5, 6, 7 }), topo.getPlacement(PlacementPolicy::OnePerCore, 8));
+		EXPECT_EQ(std::vector<int>({ 0, 2, 1, 3, 4, 6, 5, 7 }), topo.getPlacement(PlacementPolicy::Scatter, 8));
+
+		// fewer workers
+		EXPECT_EQ(std::vector<int>({ 0, 4 }), topo.getPlacement(PlacementPolicy::Compact, 2));
+		EXPECT_EQ(std::vector<int>({ 0, 1 }), topo.getPlacement(PlacementPolicy::OnePerCore, 2));
+		EXPECT_EQ(std::vector<int>({ 0, 2 }), topo.getPlacement(PlacementPolicy::Scatter, 2));
+
+		// more workers than CPUs
+		EXPECT_EQ(std::vector<int>({ 0, 2, 1, 3, 4, 6, 5, 7, 0, 2 }), topo.getPlacement(PlacementPolicy::Scatter, 10));
+	}
+
+	TEST(Topology, StealingOrder) {
+		auto topo = createDualSocket();
+
+		auto placement = topo.getPlacement(PlacementPolicy::Compact, 8);
+		EXPECT_EQ(std::vector<std::size_t>({ 1, 2, 3, 7, 6, 5, 4 }), topo.getStealingOrder(placement, 0));
+
+		// on a flat topology, the ring order is preserved
+		auto flat = Topology::createFlat(4);
+		placement = flat.getPlacement(PlacementPolicy::Compact, 4);
+		EXPECT_EQ(std::vector<std::size_t>({ 2, 0, 3 }), flat.getStealingOrder(placement, 1));
+
+		// two workers only steal from each other once
+		placement = flat.getPlacement(PlacementPolicy::Compact, 2);
+		EXPECT_EQ(std::vector<std::size_t>({ 1 }), flat.getStealingOrder(placement, 0));
+	}
+
+	TEST(Topology, PolicyNames) {
+		EXPECT_EQ(PlacementPolicy::Compact, parsePlacementPolicy("compact"));
+		EXPECT_EQ(PlacementPolicy::Scatter, parsePlacementPolicy("scatter"));
+		EXPECT_EQ(PlacementPolicy::OnePerCore, parsePlacementPolicy("one-per-core"));
+		EXPECT_EQ(PlacementPolicy::Compact, parsePlacementPolicy("unknown", PlacementPolicy::Compact));
+	}
+
+	TEST(Topology, LoadFromSysfs) {
+
+		// create a fake sysfs tree of the dual-socket system
+		std::string root = ::testing::TempDir() + "allscale_topology_test";
+		makeDir(root);
+		makeDir(root + "/cpu");
+		makeDir(root + "/node");
+		writeFile(root + "/cpu/online", "0-7");
+		writeFile(root + "/node/online", "0-1");
+		for(int n=0; n<2; n++) {
+			makeDir(root + "/node/node" + std::to_string(n));
+			writeFile(root + "/node/node" + std::to_string(n) + "/cpulist", n == 0 ? "0-1,4-5" : "2-3,6-7");
+		}
+		for(int i=0; i<8; i++) {
+			auto dir = root + "/cpu/cpu" + std::to_string(i);
+			int package = (i / 2) % 2;
+			makeDir(dir);
+			makeDir(dir + "/topology");
+			writeFile(dir + "/topology/core_id", std::to_string(i % 2));
+			writeFile(dir + "/topology/physical_package_id", std::to_string(package));
+			makeDir(dir + "/cache");
+			makeDir(dir + "/cache/index0");
+			writeFile(dir + "/cache/index0/level", "2");
+			makeDir(dir + "/cache/index1");
+			writeFile(dir + "/cache/index1/level", "3");
+			writeFile(dir + "/cache/index1/shared_cpu_list", package == 0 ? "0-1,4-5" : "2-3,6-7");
+		}
+
+		auto topo = Topology::load(root);
+		auto expected = createDualSocket();
+		ASSERT_EQ(8, topo.getNumCpus());
+		for(const auto& cur : expected.getCpus()) {
+			auto info = topo.getCpu(cur.id);
+			ASSERT_TRUE(info);
+			EXPECT_EQ(cur.core, info->core);
+			EXPECT_EQ(cur.package, info->package);
+			EXPECT_EQ(cur.node, info->node);
+			EXPECT_EQ(cur.package * 2, info->l3);
+		}
+
+		// a missing tree results in a flat topology
+		EXPECT_LE(1, Topology::load(root + "/missing").getNumCpus());
+	}
+
+	TEST(Topology, SystemTopology) {
+		auto topo = Topology::getSystemTopology();
+		EXPECT_LE(1, topo.getNumCpus());
+		EXPECT_EQ(4, topo.getPlacement(PlacementPolicy::Scatter, 4).size());
+	}
+
+} // end namespace reference
+} // end namespace impl
+} // end namespace core
+} // end namespace api
+} // end namespace allscale
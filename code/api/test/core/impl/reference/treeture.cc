@@ -1,5 +1,14 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
 #include "allscale/api/core/impl/reference/treeture.h"
 
 namespace allscale {
@@ -114,6 +123,36 @@ namespace reference {
 		EXPECT_EQ(6,z);
 	}
 
+	TEST(TaskBatch, Release) {
+
+		const int N = 40;
+
+		std::atomic<int> counter(0);
+		std::vector<treeture<void>> tasks;
+
+		EXPECT_FALSE(runtime::TaskBatch::getCurrent());
+		{
+			runtime::TaskBatchScope batch;
+			EXPECT_TRUE(runtime::TaskBatch::getCurrent());
+			{
+				// nested scopes join the outer batch, which is flushed whenever it is full
+				runtime::TaskBatchScope nested;
+				for(int i=0; i<N; i++) {
+					tasks.push_back(spawn<false>([&]{ counter++; }));
+				}
+			}
+			EXPECT_TRUE(runtime::TaskBatch::getCurrent());
+
+			// waiting within a batch enqueues the collected tasks first
+			tasks.back().wait();
+			EXPECT_LE(1, counter);
+		}
+		EXPECT_FALSE(runtime::TaskBatch::getCurrent());
+
+		for(auto& cur : tasks) cur.wait();
+		EXPECT_EQ(N, counter);
+	}
+
 	unreleased_treeture<int> sum(unreleased_treeture<int>&& a, unreleased_treeture<int>&& b) {
 		return combine(std::move(a),std::move(b),[](int a, int b) { return a + b; });
 	}
@@ -133,6 +172,45 @@ namespace reference {
 
 	}
 
+	TEST(Treeture, Sharing) {
+
+		// completed tasks are taken over by their treeture
+		treeture<int> a = done(7);
+		EXPECT_TRUE(a.isDone());
+		EXPECT_EQ(7, a.get());
+
+		// and hand over their value when being shared
+		EXPECT_TRUE(a.getPromise()->isReady());
+		EXPECT_EQ(7, a.getPromise()->getValue());
+		EXPECT_EQ(7, a.get());
+
+		// tasks still running deliver their value to the promise attached when sharing
+		std::atomic<bool> go(false);
+		treeture<int> b = spawn<true>([&]{
+			while(!go) std::this_thread::yield();
+			return 12;
+		});
+		auto promise = b.getPromise();
+		EXPECT_FALSE(b.isDone());
+		go = true;
+		EXPECT_EQ(12, b.get());
+		EXPECT_EQ(12, promise->getValue());
+
+		// moved treetures keep the ownership of their task
+		treeture<int> c = spawn<true>([]{ return 5; });
+		treeture<int> d = std::move(c);
+		EXPECT_FALSE(c.isValid());
+		EXPECT_TRUE(d.isValid());
+		EXPECT_EQ(5, std::move(d).get());
+
+		// the same for void tasks
+		treeture<void> e = spawn<true>([]{});
+		auto signal = e.getPromise();
+		e.wait();
+		EXPECT_TRUE(e.isDone());
+		EXPECT_TRUE(signal->isReady());
+	}
+
 	TEST(Treeture, Dependencies) {
 
 		int x = 0;
@@ -161,6 +239,288 @@ namespace reference {
 		EXPECT_EQ(4,x);
 	}
 
+	TEST(Treeture, ManyDependencies) {
+
+		std::atomic<bool> go(false);
+		std::atomic<int> x(0);
+
+		// create tasks not completing before being allowed to
+		std::vector<treeture<void>> tasks;
+		std::vector<task_reference> refs;
+		for(int i=0; i<10; i++) {
+			tasks.push_back(spawn<true>([&]{
+				while(!go) std::this_thread::yield();
+				x++;
+			}));
+			refs.push_back(tasks.back());
+		}
+
+		// register dependencies exceeding the entries embedded in tasks
+		treeture<int> res = spawn<true>(after(std::move(refs)), [&]{ return x.load(); });
+
+		// let the tasks depended on complete
+		go = true;
+		EXPECT_EQ(10, res.get());
+	}
+
+	TEST(Treeture, Then) {
+
+		// continuations of completed treetures
+		treeture<int> a = then(treeture<int>(12), [](int x) { return x + 1; });
+		EXPECT_EQ(13, a.get());
+
+		// continuations of orphan and root tasks
+		treeture<int> b = then(spawn<false>([]{ return 1; }).release(), [](int x) { return x * 2; });
+		EXPECT_EQ(2, b.get());
+
+		int x = 0;
+		treeture<void> c = then(spawn<true>([&]{ x++; }).release(), [&]{ x *= 3; });
+		c.get();
+		EXPECT_EQ(3, x);
+
+		// continuations are root tasks, which may be depended on
+		treeture<int> d = then(std::move(b), [](int x) { return x + 1; });
+		EXPECT_EQ(6, spawn<true>(after(d), [&]{ return d.get() * 2; }).get());
+
+	}
+
+	TEST(Treeture, ThenChain) {
+
+		const int N = 10000;
+
+		// build a long chain of continuations without waiting for any of them
+		treeture<int> cur = spawn<true>([]{ return 0; }).release();
+		for(int i=0; i<N; i++) {
+			cur = then(std::move(cur), [](int x) { return x + 1; });
+		}
+
+		EXPECT_EQ(N, cur.get());
+	}
+
+	TEST(Treeture, WhenAll) {
+
+		// a mix of value types
+		auto all = when_all(spawn<true>([]{ return 1; }).release(), treeture<std::string>(std::string("a")), spawn<false>([]{ return 2.5; }).release());
+		EXPECT_EQ(std::make_tuple(1,std::string("a"),2.5), all.get());
+
+		// a list of treetures, exceeding the dependency entries embedded in tasks
+		std::atomic<bool> go(false);
+		std::vector<treeture<int>> list;
+		for(int i=0; i<10; i++) {
+			list.push_back(spawn<true>([&,i]{
+				while(!go) std::this_thread::yield();
+				return i;
+			}));
+		}
+		auto values = when_all(std::move(list));
+		go = true;
+		EXPECT_EQ(std::vector<int>({0,1,2,3,4,5,6,7,8,9}), values.get());
+
+		// void treetures
+		std::atomic<int> x(0);
+		std::vector<treeture<void>> tasks;
+		for(int i=0; i<10; i++) {
+			tasks.push_back(spawn<true>([&]{ x++; }));
+		}
+		when_all(std::move(tasks)).get();
+		EXPECT_EQ(10, x);
+
+		// empty lists
+		EXPECT_TRUE(when_all(std::vector<treeture<int>>()).get().empty());
+		when_all(std::vector<treeture<void>>()).get();
+
+	}
+
+	TEST(Treeture, WhenAny) {
+
+		std::atomic<bool> go(false);
+
+		// one treeture is delayed until the decision is made (or a timeout is exceeded)
+		std::vector<treeture<int>> list;
+		list.push_back(spawn<true>([&]{
+			auto start = std::chrono::steady_clock::now();
+			while(!go && std::chrono::steady_clock::now() - start < std::chrono::seconds(1)) {
+				std::this_thread::yield();
+			}
+			return 1;
+		}));
+		list.push_back(treeture<int>(2));
+
+		auto res = std::move(when_any(std::move(list))).get();
+		go = true;
+
+		EXPECT_EQ(1, res.index);
+		ASSERT_EQ(2, res.treetures.size());
+		EXPECT_EQ(1, res.treetures[0].get());
+		EXPECT_EQ(2, res.treetures[1].get());
+
+		// an empty list
+		EXPECT_EQ(0, when_any(std::vector<treeture<void>>()).get().index);
+
+	}
+
+	TEST(TaskFamily, Epochs) {
+
+		TaskDependencyManager<4> mgr(1);
+		auto root = TaskPath::root();
+		auto left = root.getLeftChildPath();
+
+		EXPECT_FALSE(mgr.isComplete(root,1));
+		EXPECT_FALSE(mgr.isComplete(left,1));
+
+		EXPECT_TRUE(mgr.markComplete(left,1));
+		EXPECT_FALSE(mgr.markComplete(left,1));
+		EXPECT_TRUE(mgr.isComplete(left,1));
+		EXPECT_FALSE(mgr.isComplete(root,1));
+
+		// completing the root completes all tasks
+		EXPECT_TRUE(mgr.markComplete(root,1));
+		EXPECT_TRUE(mgr.isComplete(left.getRightChildPath(),1));
+
+		// in the next epoch, all tasks are pending again
+		mgr.startEpoch(2);
+		EXPECT_FALSE(mgr.isComplete(root,2));
+		EXPECT_FALSE(mgr.isComplete(left,2));
+
+		// while tasks of the previous epoch remain completed
+		EXPECT_TRUE(mgr.isComplete(root,1));
+		EXPECT_FALSE(mgr.markComplete(root,1));
+		EXPECT_FALSE(mgr.isComplete(root,2));
+	}
+
+	TEST(TaskFamily, DeepTasks) {
+
+		// track levels 0-2 densely, up to level 10 on demand
+		TaskDependencyManager<10> mgr(1,2);
+		EXPECT_EQ(2, mgr.getDenseDepth());
+
+		auto coarse = TaskPath::root().getLeftChildPath().getRightChildPath();
+		auto deep = coarse.getLeftChildPath().getLeftChildPath().getRightChildPath();
+		auto sibling = coarse.getLeftChildPath().getLeftChildPath().getLeftChildPath();
+
+		// untracked deep tasks are represented by their ancestor
+		EXPECT_FALSE(mgr.markComplete(deep,1));
+		EXPECT_FALSE(mgr.isComplete(deep,1));
+
+		// tracked ones are handled precisely
+		mgr.addTask(deep,1);
+		EXPECT_TRUE(mgr.markComplete(deep,1));
+		EXPECT_TRUE(mgr.isComplete(deep,1));
+		EXPECT_TRUE(mgr.isComplete(deep.getLeftChildPath(),1));
+		EXPECT_FALSE(mgr.isComplete(sibling,1));
+		EXPECT_FALSE(mgr.isComplete(coarse,1));
+
+		// completing the ancestor completes all descendants
+		EXPECT_TRUE(mgr.markComplete(coarse,1));
+		EXPECT_TRUE(mgr.isComplete(sibling,1));
+
+		// tracked tasks are forgotten in the next epoch
+		EXPECT_TRUE(mgr.markComplete(TaskPath::root(),1));
+		mgr.startEpoch(2);
+		EXPECT_FALSE(mgr.isComplete(deep,2));
+		EXPECT_FALSE(mgr.markComplete(deep,2));
+		EXPECT_TRUE(mgr.isComplete(deep,1));
+	}
+
+	TEST(TaskFamily, ManyDeepTasks) {
+
+		// track levels 0-2 densely, deeper ones in tables starting with 1024 slots
+		TaskDependencyManager<24> mgr(1,2);
+
+		// create far more deep tasks than fit into the first table
+		const std::uint64_t N = 1 << 15;
+		auto getTask = [](std::uint64_t i) {
+			auto res = TaskPath::root();
+			for(int d=14; d>=0; d--) {
+				res = ((i >> d) & 1) ? res.getRightChildPath() : res.getLeftChildPath();
+			}
+			return res;
+		};
+		for(std::uint64_t i=0; i<N; i++) {
+			mgr.addTask(getTask(i),1);
+		}
+
+		// all of them are tracked precisely
+		for(std::uint64_t i=0; i<N; i+=2) {
+			EXPECT_TRUE(mgr.markComplete(getTask(i),1)) << i;
+		}
+		for(std::uint64_t i=0; i<N; i++) {
+			EXPECT_EQ(i % 2 == 0, mgr.isComplete(getTask(i),1)) << i;
+		}
+
+		// and forgotten in the next epoch
+		EXPECT_TRUE(mgr.markComplete(TaskPath::root(),1));
+		mgr.startEpoch(2);
+		EXPECT_FALSE(mgr.isComplete(getTask(N-2),2));
+		mgr.addTask(getTask(N-2),2);
+		EXPECT_TRUE(mgr.markComplete(getTask(N-2),2));
+		EXPECT_FALSE(mgr.isComplete(getTask(N-1),2));
+
+		// released tables are re-allocated once needed again
+		EXPECT_TRUE(mgr.markComplete(TaskPath::root(),2));
+		mgr.startEpoch(3);
+		for(std::uint64_t i=0; i<N; i++) {
+			mgr.addTask(getTask(i),3);
+		}
+		for(std::uint64_t i=1; i<N; i+=2) {
+			EXPECT_TRUE(mgr.markComplete(getTask(i),3)) << i;
+		}
+		for(std::uint64_t i=0; i<N; i++) {
+			EXPECT_EQ(i % 2 == 1, mgr.isComplete(getTask(i),3)) << i;
+		}
+	}
+
+	TEST(TaskFamily, DependencyDepth) {
+		EXPECT_EQ(6, TaskFamilyManager::getDefaultDependencyDepth(1));
+		EXPECT_EQ(6, TaskFamilyManager::getDefaultDependencyDepth(4));
+		EXPECT_EQ(11, TaskFamilyManager::getDefaultDependencyDepth(128));
+		EXPECT_EQ(12, TaskFamilyManager::getDefaultDependencyDepth(1<<20));
+
+		// new families are created with the configured depth
+		EXPECT_EQ(TaskFamilyManager::getInstance().getDependencyDepth(), createFamily()->getDependencyDepth());
+
+		// configured depths are bounded
+		auto& manager = TaskFamilyManager::getInstance();
+		auto depth = manager.getDependencyDepth();
+		manager.setDependencyDepth(30);
+		EXPECT_EQ(16, manager.getDependencyDepth());
+		manager.setDependencyDepth(depth);
+	}
+
+	TEST(TaskFamily, Recycling) {
+
+		auto& manager = TaskFamilyManager::getInstance();
+
+		// run a first task to populate the family pool
+		spawn<true>([]{}).get();
+		auto before = manager.getNumFamilies();
+
+		// families of completed tasks are re-used
+		std::vector<task_reference> refs;
+		for(int i=0; i<10000; i++) {
+			treeture<int> t = spawn<true>([i]{ return i; });
+			if (i % 1000 == 0) refs.push_back(t);
+			EXPECT_EQ(i, t.get());
+		}
+		EXPECT_GE(before + 10, manager.getNumFamilies());
+
+		// references to completed tasks remain valid, although families got re-used
+		for(const auto& cur : refs) {
+			EXPECT_TRUE(cur.isDone());
+			EXPECT_TRUE(cur.getLeft().isDone());
+		}
+
+		// also for task families with dependencies
+		int x = 0;
+		for(int i=0; i<1000; i++) {
+			treeture<void> a = spawn<true>([&]{ x++; });
+			treeture<void> b = spawn<true>(after(a), [&,i]{ EXPECT_EQ(2*i+1,x); x++; });
+			b.get();
+		}
+		EXPECT_EQ(2000, x);
+		EXPECT_GE(before + 10, manager.getNumFamilies());
+	}
+
 
 	// --- benchmark ---
 
@@ -168,7 +528,7 @@ namespace reference {
 
 	template<int x>
 	struct c_fib {
-		enum { value = c_fib<x-1>::value + c_fib<x-2>::value };
+		enum { value = int(c_fib<x-1>::value) + c_fib<x-2>::value };
 	};
 
 	template<>
@@ -223,6 +583,69 @@ namespace reference {
 		EXPECT_EQ(c_fib<N>::value, p_fib(N));
 	}
 
+	namespace {
+
+		// measures the wall-clock time and process CPU time of the given operation in ms
+		template<typename Op>
+		std::pair<double,double> measure(const Op& op) {
+			auto wallStart = std::chrono::steady_clock::now();
+			auto cpuStart = std::clock();
+			op();
+			auto cpuEnd = std::clock();
+			auto wallEnd = std::chrono::steady_clock::now();
+			return {
+				std::chrono::duration<double,std::milli>(wallEnd - wallStart).count(),
+				1000.0 * (cpuEnd - cpuStart) / CLOCKS_PER_SEC
+			};
+		}
+
+	}
+
+	TEST(Benchmark,IdleProtocol) {
+
+		auto& pool = runtime::WorkerPool::getInstance();
+		auto spin = pool.getIdleSpinCycles();
+		auto yield = pool.getIdleYieldCycles();
+
+		struct Config {
+			const char* name;
+			unsigned spin;
+			unsigned yield;
+		};
+
+		std::vector<Config> configs = {
+			{ "park at once", 0, 0 },
+			{ "default     ", spin, yield },
+			{ "spin long   ", 100000, 1000 }
+		};
+
+		for(const auto& config : configs) {
+			pool.setIdleThresholds(config.spin, config.yield);
+
+			// mostly idle: small parallel jobs separated by pauses
+			auto idle = measure([]{
+				for(int i=0; i<50; i++) {
+					EXPECT_EQ(c_fib<10>::value, p_fib(10));
+					std::this_thread::sleep_for(std::chrono::milliseconds(2));
+				}
+			});
+
+			// mostly busy: a single large parallel job
+			auto busy = measure([]{
+				for(int i=0; i<5; i++) {
+					EXPECT_EQ(c_fib<N>::value, p_fib(N));
+				}
+			});
+
+			std::cout << config.name
+					<< " - idle: " << idle.first << "ms wall, " << idle.second << "ms cpu"
+					<< " - busy: " << busy.first << "ms wall, " << busy.second << "ms cpu\n";
+		}
+
+		// restore thresholds
+		pool.setIdleThresholds(spin, yield);
+	}
+
 } // end namespace reference
 } // end namespace impl
 } // end namespace core
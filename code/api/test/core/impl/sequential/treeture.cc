@@ -107,7 +107,7 @@ namespace sequential {
 
 	template<int x>
 	struct c_fib {
-		enum { value = c_fib<x-1>::value + c_fib<x-2>::value };
+		enum { value = int(c_fib<x-1>::value) + c_fib<x-2>::value };
 	};
 
 	template<>
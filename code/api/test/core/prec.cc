@@ -1,8 +1,12 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
 #include <sstream>
 #include <string>
+#include <utility>
 
 #include "allscale/api/core/prec.h"
 #include "allscale/api/user/arithmetic.h"
@@ -755,8 +759,8 @@ namespace core {
 
 	// ---- application tests --------
 
-	int pfib(int x) {
-		return prec(
+	int pfib(int x, const impl::reference::SplitPolicy* policy = nullptr) {
+		auto fib = prec(
 				fun(
 					[](int x) { return x < 2; },
 					[](int x) { return x; },
@@ -764,7 +768,8 @@ namespace core {
 						return add(f(x-1),f(x-2));
 					}
 				)
-		)(x).get();
+		);
+		return (policy ? fib.withSplitPolicy(*policy) : fib)(x).get();
 	}
 
 	TEST(RecOps, ParallelTest) {
@@ -810,7 +815,7 @@ namespace core {
 
 	template<unsigned N>
 	struct static_fib {
-		enum { value = static_fib<N-1>::value + static_fib<N-2>::value };
+		enum { value = int(static_fib<N-1>::value) + static_fib<N-2>::value };
 	};
 
 	template<>
@@ -887,7 +892,7 @@ namespace core {
 		return reduceIf(a,b,filter,map,std::plus<int>());
 	}
 
-	int nqueens(int size) {
+	int nqueens(int size, const impl::reference::SplitPolicy* policy = nullptr) {
 
 		struct Assignment {
 
@@ -942,7 +947,7 @@ namespace core {
 		);
 
 		// compute the result
-		return compute(Assignment()).get();
+		return (policy ? compute.withSplitPolicy(*policy) : compute)(Assignment()).get();
 	}
 
 
@@ -965,6 +970,177 @@ namespace core {
 
 	}
 
+	namespace {
+
+		// a policy counting its invocations, delegating decisions to another policy
+		struct CountingPolicy : public impl::reference::SplitPolicy {
+			const impl::reference::SplitPolicy& base;
+			mutable std::atomic<int> calls;
+			CountingPolicy(const impl::reference::SplitPolicy& base) : base(base), calls(0) {}
+			bool shouldSplit(const impl::reference::SplitContext& context) const override {
+				calls++;
+				return base.shouldSplit(context);
+			}
+			std::string getName() const override {
+				return "counting";
+			}
+		};
+
+		template<typename Op>
+		double measure(const Op& op) {
+			auto start = std::chrono::steady_clock::now();
+			op();
+			auto end = std::chrono::steady_clock::now();
+			return std::chrono::duration<double,std::milli>(end - start).count();
+		}
+
+	}
+
+	TEST(RecOps, SplitPolicy) {
+		for(const auto& name : { "fixed", "lazy", "adaptive" }) {
+			CountingPolicy policy(*impl::reference::getSplitPolicy(name));
+			EXPECT_EQ(46368, pfib(24, &policy));
+			EXPECT_EQ(724, nqueens(10, &policy));
+			EXPECT_LT(0, policy.calls) << name;
+		}
+	}
+
+	TEST(Benchmark, SplitPolicies) {
+		for(const auto& name : { "fixed", "lazy", "adaptive" }) {
+			auto policy = impl::reference::getSplitPolicy(name);
+			auto fib = measure([&]{ EXPECT_EQ(static_fib<32>::value, pfib(32, policy)); });
+			auto queens = measure([&]{ EXPECT_EQ(14200, nqueens(12, policy)); });
+			std::cout << name << "\t- fib(32): " << fib << "ms, nqueens(12): " << queens << "ms\n";
+		}
+	}
+
+	namespace {
+
+		// keeps the current thread busy for the given time
+		void busy(std::chrono::microseconds time) {
+			auto end = std::chrono::steady_clock::now() + time;
+			while(std::chrono::steady_clock::now() < end) {}
+		}
+
+		// the latencies of nested prec calls
+		struct Latencies {
+			std::atomic<long long> total { 0 };
+			std::atomic<long long> max { 0 };
+			std::atomic<int> count { 0 };
+
+			void add(std::chrono::steady_clock::duration latency) {
+				auto ns = (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count();
+				total += ns;
+				count++;
+				auto cur = max.load();
+				while(cur < ns && !max.compare_exchange_weak(cur,ns)) {}
+			}
+
+			double getMean() const {
+				return (count) ? total / count / 1e6 : 0.0;
+			}
+
+			double getMax() const {
+				return max / 1e6;
+			}
+		};
+
+		/**
+		 * Processes the given number of independent tasks, every 8th of which is waiting
+		 * for a nested prec call of the given priority while the others keep the workers busy.
+		 */
+		int nestedPrec(int n, Latencies& latencies, impl::reference::TaskPriority priority = impl::reference::TaskPriority::Normal) {
+			using range = std::pair<int,int>;
+			auto outer = prec(
+				fun(
+					[](const range& r) { return r.second - r.first <= 1; },
+					[&](const range& r) {
+						if (r.first % 8 != 0) {
+							busy(std::chrono::microseconds(500));
+							return 0;
+						}
+						auto start = std::chrono::steady_clock::now();
+						impl::reference::TaskPriorityScope scope(priority);
+						auto res = pfib(20);
+						latencies.add(std::chrono::steady_clock::now() - start);
+						return res;
+					},
+					[](const range& r, const auto& f) {
+						int m = (r.first + r.second) / 2;
+						return add(f(range(r.first,m)),f(range(m,r.second)));
+					}
+				)
+			);
+			return outer(range(0,n)).get();
+		}
+
+	}
+
+	TEST(Benchmark, NestedPrecLatency) {
+		auto& pool = impl::reference::runtime::WorkerPool::getInstance();
+		bool old = pool.isHelpFirstWaiting();
+
+		for(bool helpFirst : { false, true }) {
+			pool.setHelpFirstWaiting(helpFirst);
+			Latencies latencies;
+			double time = measure([&]{ EXPECT_EQ(64 * 6765, nestedPrec(512, latencies)); });
+			std::cout << (helpFirst ? "help-first" : "any task") << "\t- total: " << time << "ms"
+					<< ", nested prec latency: " << latencies.getMean() << "ms mean, " << latencies.getMax() << "ms max\n";
+		}
+
+		pool.setHelpFirstWaiting(old);
+	}
+
+	TEST(RecOps, Priority) {
+		using impl::reference::TaskPriority;
+		using impl::reference::getCurrentTaskPriority;
+
+		std::atomic<int> mismatches(0);
+		auto check = prec(
+			fun(
+				[](int x) { return x < 2; },
+				[&](int x) {
+					if (getCurrentTaskPriority() != TaskPriority::High) mismatches++;
+					return x;
+				},
+				[](int x, const auto& f) {
+					return add(f(x-1),f(x-2));
+				}
+			)
+		);
+
+		// all tasks of the operation are processed with the requested priority
+		EXPECT_EQ(6765, check.withPriority(TaskPriority::High)(20).get());
+		EXPECT_EQ(0, mismatches);
+
+		// also when combined with a split policy
+		impl::reference::LazySplitPolicy lazy;
+		EXPECT_EQ(6765, check.withPriority(TaskPriority::High).withSplitPolicy(lazy)(20).get());
+		EXPECT_EQ(0, mismatches);
+
+		// without a priority, it is inherited from the caller
+		{
+			impl::reference::TaskPriorityScope scope(TaskPriority::High);
+			EXPECT_EQ(6765, check(20).get());
+		}
+		EXPECT_EQ(0, mismatches);
+
+		// which is by default the normal priority
+		EXPECT_EQ(TaskPriority::Normal, getCurrentTaskPriority());
+		EXPECT_EQ(6765, check(20).get());
+		EXPECT_LT(0, mismatches);
+	}
+
+	TEST(Benchmark, PrioritizedPrecLatency) {
+		using impl::reference::TaskPriority;
+		for(auto priority : { TaskPriority::Normal, TaskPriority::High }) {
+			Latencies latencies;
+			double time = measure([&]{ EXPECT_EQ(64 * 6765, nestedPrec(512, latencies, priority)); });
+			std::cout << priority << " priority\t- total: " << time << "ms"
+					<< ", nested prec latency: " << latencies.getMean() << "ms mean, " << latencies.getMax() << "ms max\n";
+		}
+	}
+
 } // end namespace core
 } // end namespace api
 } // end namespace allscale
@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <sstream>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include "allscale/api/core/treeture.h"
 
@@ -32,6 +34,43 @@ namespace core {
 
 	}
 
+	TEST(Treeture, Continuations) {
+
+		// sequential implementation
+		impl::sequential::treeture<int> s1 = then(impl::sequential::treeture<int>(done(1)), [](int x) { return x + 1; });
+		EXPECT_EQ(2,s1.get());
+
+		auto s2 = when_all(std::move(s1), impl::sequential::treeture<std::string>(done(std::string("a"))));
+		EXPECT_EQ(std::make_tuple(2,std::string("a")),s2.get());
+
+		std::vector<impl::sequential::treeture<int>> s3;
+		s3.push_back(done(3));
+		s3.push_back(done(4));
+		when_any_result<int,impl::sequential::treeture> first = when_any(std::move(s3)).get();
+		EXPECT_EQ(0,first.index);
+		EXPECT_EQ(3,first.treetures[first.index].get());
+
+		// reference implementation
+		impl::reference::treeture<int> r1 = then(impl::reference::treeture<int>(done(1)), [](int x) { return x + 1; });
+		EXPECT_EQ(2,r1.get());
+
+		auto r2 = when_all(std::move(r1), impl::reference::treeture<std::string>(done(std::string("a"))));
+		EXPECT_EQ(std::make_tuple(2,std::string("a")),r2.get());
+
+		std::vector<treeture<int>> r3;
+		r3.push_back(done(3));
+		r3.push_back(done(4));
+		when_any_result<int> any = std::move(when_any(std::move(r3))).get();
+		EXPECT_LT(any.index,2);
+		EXPECT_EQ(3+any.index,any.treetures[any.index].get());
+
+		std::vector<treeture<void>> r4;
+		r4.push_back(done());
+		r4.push_back(done());
+		when_all(std::move(r4)).get();
+
+	}
+
 } // end namespace core
 } // end namespace api
 } // end namespace allscale
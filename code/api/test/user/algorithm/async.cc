@@ -6,6 +6,7 @@
 #include <thread>
 
 #include "allscale/api/user/algorithm/async.h"
+#include "allscale/api/core/coroutine.h"
 #include "allscale/api/core/io.h"
 
 namespace allscale {
@@ -116,6 +117,23 @@ namespace algorithm {
 		manager.remove(binary);
 	}
 
+#if ALLSCALE_WITH_COROUTINES
+
+	TEST(Async, Coroutine) {
+
+		// asynchronous jobs may be awaited within coroutines
+		auto job = []() -> core::task<int> {
+			int a = co_await async([]{ return 5; });
+			int b = co_await async([]{ return 7; });
+			co_return a * b;
+		};
+
+		EXPECT_EQ(35, job().get());
+
+	}
+
+#endif
+
 } // end namespace algorithm
 } // end namespace user
 } // end namespace api
@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <chrono>
+#include <iostream>
 #include <vector>
 
+#include "allscale/api/core/coroutine.h"
 #include "allscale/api/core/io.h"
 
 #include "allscale/api/user/algorithm/pfor.h"
@@ -76,6 +79,47 @@ namespace algorithm {
 		EXPECT_EQ(Point(99,99,99),last);
 	}
 
+	TEST(Scanner,RowScan1D) {
+
+		auto range = detail::range<int>(10,100);
+
+		int rows = 0;
+		range.forEachRow([&](int begin, std::size_t length){
+			EXPECT_EQ(10,begin);
+			EXPECT_EQ(90,length);
+			rows++;
+		});
+
+		EXPECT_EQ(1,rows);
+	}
+
+	TEST(Scanner,RowScan3D) {
+
+		using Point = utils::Vector<int,3>;
+		auto range = detail::range<Point>(Point(1,2,3),Point(10,20,30));
+
+		// rows are enumerated in scan order, covering the innermost dimension
+		Point last(1,1,3);
+		int rows = 0;
+		range.forEachRow([&](const Point& begin, std::size_t length){
+			Point next = last;
+			next.y++;
+			if (next.y == 20) { next.y = 2; next.x++; }
+			EXPECT_EQ(next,begin);
+			EXPECT_EQ(27,length);
+			last = begin;
+			rows++;
+		});
+
+		EXPECT_EQ(9*18,rows);
+		EXPECT_EQ(Point(9,19,3),last);
+
+		// empty ranges have no rows
+		detail::range<Point>(Point(0,0,0),Point(10,0,10)).forEachRow([](const Point&, std::size_t){
+			FAIL() << "No rows expected";
+		});
+	}
+
 
 	// --- basic parallel loop usage ---
 
@@ -2997,6 +3041,769 @@ namespace algorithm {
 	}
 
 
+#if ALLSCALE_WITH_COROUTINES
+
+	TEST(Pfor, Coroutine) {
+
+		const int N = 1000;
+		std::vector<int> data(N, 0);
+
+		// a sequence of dependent loops, awaited without blocking a worker
+		auto steps = [&]() -> core::task<int> {
+			for(int i=0; i<10; i++) {
+				co_await pfor(0,N,[&](int j) { data[j]++; });
+			}
+			co_return data[N/2];
+		};
+
+		EXPECT_EQ(10, steps().get());
+		for(int j=0; j<N; j++) {
+			EXPECT_EQ(10, data[j]) << "j=" << j;
+		}
+	}
+
+#endif
+
+	TEST(Pfor, Rows) {
+		const int N = 50;
+
+		// 1D loops are handled as a single row
+		std::vector<int> line(N*N*N, 0);
+		pforRows(0,N*N*N,[&](int begin, std::size_t length) {
+			for(std::size_t i=0; i<length; i++) line[begin+i]++;
+		});
+		for(const auto& cur : line) {
+			EXPECT_EQ(1,cur);
+		}
+
+		// multi-dimensional loops are processed row by row
+		using Point = utils::Vector<int,3>;
+		std::vector<int> data(N*N*N, 0);
+		pforRows(Point(N,N,N),[&](const Point& begin, std::size_t length) {
+			int* row = &data[(begin.x * N + begin.y) * N + begin.z];
+			for(std::size_t i=0; i<length; i++) row[i]++;
+		});
+		for(const auto& cur : data) {
+			EXPECT_EQ(1,cur);
+		}
+
+		// also obeying dependencies to point-wise loops
+		auto As = pfor(Point(N,N,N),[&](const Point& p) {
+			data[(p.x * N + p.y) * N + p.z] = 2;
+		});
+		auto Bs = pforRows(Point(N,N,N),[&](const Point& begin, std::size_t length) {
+			for(std::size_t i=0; i<length; i++) {
+				Point p = begin;
+				p.z += (int)i;
+				for(int dx=-1; dx<=1; dx++) {
+					if (p.x + dx < 0 || p.x + dx >= N) continue;
+					EXPECT_EQ(2,data[((p.x + dx) * N + p.y) * N + p.z]);
+				}
+			}
+		}, small_neighborhood_sync(As));
+		Bs.wait();
+	}
+
+	TEST(SplitPlan, Longest) {
+
+		using Point = utils::Vector<int,2>;
+
+		// by default, dimensions are split in turn
+		detail::split_plan<Point> plan;
+		for(std::size_t i=0; i<10; i++) {
+			EXPECT_EQ(i % 2, plan.getSplitDimension(i));
+		}
+
+		// longer dimensions are split first, until all are balanced
+		plan = detail::split_plan<Point>::longest(Point(0,0),Point(100,400));
+		EXPECT_EQ(1, plan.getSplitDimension(0));
+		EXPECT_EQ(1, plan.getSplitDimension(1));
+		EXPECT_EQ(0, plan.getSplitDimension(2));
+		EXPECT_EQ(1, plan.getSplitDimension(3));
+		EXPECT_EQ(0, plan.getSplitDimension(4));
+		EXPECT_EQ(1, plan.getSplitDimension(5));
+
+		// the resulting sub-ranges approach squares
+		detail::range<Point> r(Point(0,0),Point(100,400));
+		for(std::size_t d=0; d<4; d++) {
+			r = r.split(d,plan).left;
+		}
+		EXPECT_EQ(Point(0,0), r.begin());
+		EXPECT_EQ(Point(50,50), r.end());
+
+		// the same works for three dimensions
+		using Point3 = utils::Vector<int,3>;
+		auto plan3 = detail::split_plan<Point3>::longest(Point3(0,0,0),Point3(16,64,16));
+		EXPECT_EQ(1, plan3.getSplitDimension(0));
+		EXPECT_EQ(1, plan3.getSplitDimension(1));
+		EXPECT_EQ(0, plan3.getSplitDimension(2));
+		EXPECT_EQ(1, plan3.getSplitDimension(3));
+		EXPECT_EQ(2, plan3.getSplitDimension(4));
+		EXPECT_EQ(0, plan3.getSplitDimension(5));
+	}
+
+	TEST(Scanner, SpaceFillingBlocks) {
+
+		using Point = utils::Vector<int,2>;
+		detail::range<Point> r(Point(0,0),Point(256,256));
+
+		// lexicographic traversals process the range as a whole
+		int blocks = 0;
+		detail::forEachBlock(r,loop_traversal::Lexicographic,[&](const detail::range<Point>& b) {
+			EXPECT_EQ(r.begin(),b.begin());
+			EXPECT_EQ(r.end(),b.end());
+			blocks++;
+		});
+		EXPECT_EQ(1,blocks);
+
+		// space filling traversals visit blocks along a Z-order curve
+		std::vector<detail::range<Point>> list;
+		detail::forEachBlock(r,loop_traversal::SpaceFilling,[&](const detail::range<Point>& b) {
+			EXPECT_EQ(64*64,b.size());
+			list.push_back(b);
+		});
+		ASSERT_EQ(16,list.size());
+		EXPECT_EQ(Point(0,0),list[0].begin());
+		EXPECT_EQ(Point(0,64),list[1].begin());
+		EXPECT_EQ(Point(64,0),list[2].begin());
+		EXPECT_EQ(Point(64,64),list[3].begin());
+		EXPECT_EQ(Point(0,128),list[4].begin());
+		EXPECT_EQ(Point(192,192),list[15].begin());
+	}
+
+	TEST(Pfor, SpaceFillingTraversal) {
+		const int N = 100;
+		using Point = utils::Vector<int,3>;
+
+		std::vector<int> dataA(N*N*N, 0);
+		std::vector<int> dataB(N*N*N, 0);
+		std::vector<int> dataC(N*N*N, 0);
+		auto idx = [](const Point& p) { return (p.x * N + p.y) * N + p.z; };
+
+		loop_partitioner_scope grain(fixed_grain(64));
+
+		// all points are covered exactly once
+		{
+			loop_traversal_scope scope(loop_traversal::SpaceFilling);
+			EXPECT_EQ(loop_traversal::SpaceFilling, getCurrentLoopTraversal());
+			pfor(Point(N,N/2,N/4),[&](const Point& p) { dataA[idx(p)]++; });
+			pforRows(Point(N,N/2,N/4),[&](const Point& p, std::size_t length) {
+				for(std::size_t i=0; i<length; i++) dataB[idx(p)+i]++;
+			});
+		}
+		EXPECT_EQ(loop_traversal::Lexicographic, getCurrentLoopTraversal());
+		for(int x=0; x<N; x++) {
+			for(int y=0; y<N; y++) {
+				for(int z=0; z<N; z++) {
+					int expected = (y < N/2 && z < N/4) ? 1 : 0;
+					EXPECT_EQ(expected, dataA[idx(Point(x,y,z))]);
+					EXPECT_EQ(expected, dataB[idx(Point(x,y,z))]);
+				}
+			}
+		}
+
+		// dependencies on and of space filling loops are obeyed
+		auto As = [&]() {
+			loop_traversal_scope scope(loop_traversal::SpaceFilling);
+			return pfor(Point(N,N,N),[&](const Point& p) { dataA[idx(p)] = 1; });
+		}();
+
+		auto Bs = pfor(Point(N,N,N),[&](const Point& p) {
+			for(int dx=-1; dx<=1; dx++) {
+				for(int dy=-1; dy<=1; dy++) {
+					Point q(p.x+dx,p.y+dy,p.z);
+					if (q.x < 0 || q.y < 0 || q.x >= N || q.y >= N) continue;
+					EXPECT_EQ(1,dataA[idx(q)]);
+				}
+			}
+			dataB[idx(p)] = 2;
+		}, full_neighborhood_sync(As));
+
+		// Bs reads diagonal neighbours of dataA, which a small neighborhood sync does not cover -> write dataC
+		auto Cs = [&]() {
+			loop_traversal_scope scope(loop_traversal::SpaceFilling);
+			return pfor(Point(N,N,N),[&](const Point& p) {
+				for(int d=-1; d<=1; d++) {
+					if (p.z+d < 0 || p.z+d >= N) continue;
+					EXPECT_EQ(2,dataB[idx(Point(p.x,p.y,p.z+d))]);
+				}
+				dataC[idx(p)] = 3;
+			}, small_neighborhood_sync(Bs));
+		}();
+
+		bool done = false;
+		auto Ds = after(Cs, Point(N/2,N/2,N/2), [&]() {
+			EXPECT_EQ(3,dataC[idx(Point(N/2,N/2,N/2))]);
+			done = true;
+		});
+
+		Ds.wait();
+		EXPECT_TRUE(done);
+	}
+
+	TEST(LoopPartitioner, Grain) {
+
+		auto fixed = detail::loop_grain::create<int>(fixed_grain(100),1000);
+		EXPECT_TRUE(fixed.isBaseCase(1));
+		EXPECT_TRUE(fixed.isBaseCase(100));
+		EXPECT_FALSE(fixed.isBaseCase(101));
+
+		// the default partitioner decomposes ranges down to single iterations
+		auto single = detail::loop_grain::create<int>(getCurrentLoopPartitioner(),1000);
+		EXPECT_TRUE(single.isBaseCase(1));
+		EXPECT_FALSE(single.isBaseCase(2));
+
+		// static partitions produce about one chunk per worker
+		auto numWorkers = core::impl::reference::runtime::WorkerPool::getInstance().getNumWorkers();
+		auto chunks = detail::loop_grain::create<int>(static_partition(),1000);
+		EXPECT_TRUE(chunks.isBaseCase((1000 + numWorkers - 1) / numWorkers));
+		EXPECT_EQ(numWorkers == 1, chunks.isBaseCase(1000));
+	}
+
+	namespace {
+		struct AutoGrainKey {};
+	}
+
+	TEST(LoopPartitioner, AutoGrain) {
+		using duration = detail::iteration_cost::duration;
+		auto target = std::chrono::microseconds(50);
+		auto ticks = (unsigned long long)(double(std::chrono::nanoseconds(target).count()) * core::impl::reference::TscClock::getTicksPerNanosecond());
+
+		// without measurements, ranges are split down to single iterations
+		auto automatic = detail::loop_grain::create<AutoGrainKey>(auto_grain(target),1000000);
+		EXPECT_TRUE(automatic.isBaseCase(1));
+		EXPECT_FALSE(automatic.isBaseCase(2));
+		EXPECT_FALSE(automatic.isBaseCase(1000000));
+
+		// once iterations have been measured, ranges are processed sequentially if they meet the target
+		auto& cost = detail::getIterationCost<AutoGrainKey>();
+		cost.registerTime(100, duration(ticks / 10));
+		EXPECT_TRUE(automatic.isBaseCase(1000));
+		EXPECT_FALSE(automatic.isBaseCase(1001));
+		EXPECT_FALSE(automatic.isBaseCase(1000000));
+
+		// the estimate is per iteration, thus independent of the size of the measured ranges
+		cost.registerTime(10000, duration(ticks * 10));
+		EXPECT_TRUE(automatic.isBaseCase(1000));
+		EXPECT_FALSE(automatic.isBaseCase(1001));
+
+		// measurements are recorded when processing ranges
+		auto other = detail::loop_grain::create<int>(auto_grain(target),1000);
+		EXPECT_FALSE(other.isBaseCase(2));
+		other.process(2, []{});
+		EXPECT_TRUE(detail::getIterationCost<int>().hasSamples());
+	}
+
+	TEST(LoopPartitioner, Scope) {
+		EXPECT_EQ(loop_partitioner::Kind::Fixed, getCurrentLoopPartitioner().getKind());
+		EXPECT_EQ(1, getCurrentLoopPartitioner().getGrainSize());
+		{
+			loop_partitioner_scope scope(fixed_grain(16));
+			EXPECT_EQ(16, getCurrentLoopPartitioner().getGrainSize());
+			{
+				loop_partitioner_scope inner(static_partition());
+				EXPECT_EQ(loop_partitioner::Kind::Static, getCurrentLoopPartitioner().getKind());
+			}
+			EXPECT_EQ(16, getCurrentLoopPartitioner().getGrainSize());
+		}
+		EXPECT_EQ(1, getCurrentLoopPartitioner().getGrainSize());
+		EXPECT_EQ("fixed(1)", toString(getCurrentLoopPartitioner()));
+	}
+
+	TEST(Pfor, Partitioners) {
+		const int N = 10000;
+
+		for(const auto& partitioner : { fixed_grain(1), fixed_grain(100), fixed_grain(N), auto_grain(), static_partition() }) {
+			loop_partitioner_scope scope(partitioner);
+
+			// all iterations are covered exactly once
+			std::vector<int> data(N, 0);
+			pfor(0,N,[&](int i) { data[i]++; });
+			for(int i=0; i<N; i++) {
+				EXPECT_EQ(1, data[i]) << "Partitioner: " << partitioner << " Index: " << i;
+			}
+
+			// also for multi-dimensional ranges
+			std::vector<int> grid(100*100, 0);
+			pfor(utils::Vector<int,2>(100,100),[&](const utils::Vector<int,2>& p) { grid[p.x * 100 + p.y]++; });
+			for(int i=0; i<100*100; i++) {
+				EXPECT_EQ(1, grid[i]) << "Partitioner: " << partitioner << " Index: " << i;
+			}
+
+			// and for loops with boundaries
+			std::vector<int> inner(N, 0);
+			std::vector<int> boundary(N, 0);
+			pforWithBoundary(0,N,[&](int i) { inner[i]++; },[&](int i) { boundary[i]++; });
+			EXPECT_EQ(1, boundary[0]);
+			EXPECT_EQ(1, boundary[N-1]);
+			for(int i=1; i<N-1; i++) {
+				EXPECT_EQ(1, inner[i]) << "Partitioner: " << partitioner << " Index: " << i;
+				EXPECT_EQ(0, boundary[i]) << "Partitioner: " << partitioner << " Index: " << i;
+			}
+		}
+	}
+
+	TEST(Pfor, PartitionersSyncSmallNeighborhood) {
+		const int N = 10000;
+
+		std::vector<int> dataA(N);
+		std::vector<int> dataB(N);
+
+		// dependencies between loops of different partitions have to be obeyed
+		auto As = [&]() {
+			loop_partitioner_scope scope(fixed_grain(100));
+			return pfor(0,N,[&](int i) {
+				dataA[i] = 1;
+			});
+		}();
+
+		auto Bs = [&]() {
+			loop_partitioner_scope scope(static_partition());
+			return pfor(0,N,[&](int i) {
+				if (i != 0) {
+					EXPECT_EQ(1,dataA[i-1]) << "Index: " << i;
+				}
+				EXPECT_EQ(1,dataA[i]) << "Index: " << i;
+				if (i != N-1) {
+					EXPECT_EQ(1,dataA[i+1]) << "Index: " << i;
+				}
+				dataB[i] = 2;
+			}, small_neighborhood_sync(As));
+		}();
+
+		auto Cs = pfor(0,N,[&](int i) {
+			if (i != 0) {
+				EXPECT_EQ(2,dataB[i-1]) << "Index: " << i;
+			}
+			EXPECT_EQ(2,dataB[i]) << "Index: " << i;
+			if (i != N-1) {
+				EXPECT_EQ(2,dataB[i+1]) << "Index: " << i;
+			}
+			dataA[i] = 3;
+		}, small_neighborhood_sync(Bs));
+
+		Cs.wait();
+
+		for(int i=0; i<N; i++) {
+			EXPECT_EQ(3, dataA[i]);
+			EXPECT_EQ(2, dataB[i]);
+		}
+	}
+
+	TEST(Pfor, Tiled1D) {
+
+		const int N = 100000;
+		const int T = 100;
+
+		// a 3-point stencil alternating between two buffers
+		auto update = [](const std::vector<int>& src, std::vector<int>& trg, int i) {
+			if (i == 0 || i == N-1) {
+				trg[i] = src[i] + 1;
+				return;
+			}
+			trg[i] = (src[i-1] + 2 * src[i] + src[i+1]) % 1009;
+		};
+
+		std::vector<int> init(N);
+		for(int i=0; i<N; i++) init[i] = (i * 7) % 13;
+
+		// compute the reference result sequentially
+		std::vector<int> ref[2] = { init, init };
+		for(int t=0; t<T; t++) {
+			for(int i=0; i<N; i++) update(ref[t%2],ref[(t+1)%2],i);
+		}
+
+		// compute the tiled result
+		std::vector<int> buffer[2] = { init, init };
+		std::atomic<int> count(0);
+		pforTiled(0,N,T,[&](std::size_t t, int i) {
+			update(buffer[t%2],buffer[(t+1)%2],i);
+			count++;
+		});
+
+		EXPECT_EQ(N*T, count);
+		EXPECT_EQ(ref[T%2], buffer[T%2]);
+	}
+
+	TEST(Pfor, Tiled2D) {
+
+		const int N = 300;
+		const int T = 40;
+
+		using Point = utils::Vector<int,2>;
+
+		// a 9-point stencil alternating between two buffers
+		auto update = [](const std::vector<int>& src, std::vector<int>& trg, const Point& p) {
+			int sum = 0;
+			for(int i=std::max(p.x-1,0); i<=std::min(p.x+1,N-1); i++) {
+				for(int j=std::max(p.y-1,0); j<=std::min(p.y+1,N-1); j++) {
+					sum += src[i*N+j];
+				}
+			}
+			trg[p.x*N+p.y] = (sum + src[p.x*N+p.y]) % 1009;
+		};
+
+		std::vector<int> init(N*N);
+		for(int i=0; i<N*N; i++) init[i] = (i * 7) % 13;
+
+		// compute the reference result sequentially
+		std::vector<int> ref[2] = { init, init };
+		for(int t=0; t<T; t++) {
+			for(int i=0; i<N; i++) {
+				for(int j=0; j<N; j++) {
+					update(ref[t%2],ref[(t+1)%2],Point(i,j));
+				}
+			}
+		}
+
+		// compute the tiled result
+		std::vector<int> buffer[2] = { init, init };
+		std::atomic<int> count(0);
+		pforTiled(Point(N,N),T,[&](std::size_t t, const Point& p) {
+			update(buffer[t%2],buffer[(t+1)%2],p);
+			count++;
+		});
+
+		EXPECT_EQ(N*N*T, count);
+		EXPECT_EQ(ref[T%2], buffer[T%2]);
+	}
+
+	TEST(Pfor, TiledRadius) {
+
+		const int N = 50000;
+		const int T = 60;
+		const int R = 3;
+
+		// a stencil reading the points within radius R, only updating the inner points
+		auto update = [](const std::vector<int>& src, std::vector<int>& trg, int i) {
+			int sum = 0;
+			for(int j=i-R; j<=i+R; j++) sum += src[j];
+			trg[i] = sum % 1009;
+		};
+
+		std::vector<int> init(N);
+		for(int i=0; i<N; i++) init[i] = (i * 7) % 13;
+
+		std::vector<int> ref[2] = { init, init };
+		for(int t=0; t<T; t++) {
+			for(int i=R; i<N-R; i++) update(ref[t%2],ref[(t+1)%2],i);
+		}
+
+		std::vector<int> buffer[2] = { init, init };
+		pforTiled<R>(R,N-R,T,[&](std::size_t t, int i) {
+			update(buffer[t%2],buffer[(t+1)%2],i);
+		});
+
+		EXPECT_EQ(ref[T%2], buffer[T%2]);
+	}
+
+	TEST(Pfor, TiledWidth) {
+		using detail::getTemporalTileWidth;
+
+		// large ranges are cut into cache-sized tiles
+		EXPECT_EQ(detail::TEMPORAL_TILE_SIZE, getTemporalTileWidth(1,1e9,1,4));
+		EXPECT_EQ(128, getTemporalTileWidth(2,1e9,1,4));
+
+		// small ranges are still cut into about as many tiles as there are workers
+		EXPECT_EQ(50, getTemporalTileWidth(2,100*100,1,4));
+		EXPECT_EQ(7812, getTemporalTileWidth(1,1000*1000,1,128));
+		EXPECT_EQ(12, getTemporalTileWidth(3,20*20*20,1,4));
+
+		// yet tiles are at least twice as wide as the radius
+		EXPECT_EQ(6, getTemporalTileWidth(1,100,3,64));
+		EXPECT_EQ(1, getTemporalTileWidth(1,100,0,1000));
+	}
+
+	TEST(Pfor, TiledSync) {
+
+		const int N = 40000;
+		const int T = 10;
+
+		std::vector<int> data(N,0);
+
+		// the result of a tiled loop may be synchronized on like any other loop
+		auto ref = pforTiled(0,N,T,[&](std::size_t, int i) {
+			data[i]++;
+		});
+
+		pfor(0,N,[&](int i) {
+			EXPECT_EQ(T,data[i]);
+			data[i]++;
+		},small_neighborhood_sync(ref));
+
+		for(int i=0; i<N; i++) {
+			EXPECT_EQ(T+1,data[i]);
+		}
+	}
+
+	namespace {
+
+		// a split policy decomposing loops down to their grain size, regardless of the load
+		struct AlwaysSplitPolicy : public core::impl::reference::SplitPolicy {
+			bool shouldSplit(const core::impl::reference::SplitContext&) const override {
+				return true;
+			}
+			std::string getName() const override {
+				return "always";
+			}
+		};
+
+	}
+
+	TEST(Pfor, DeepDependencies) {
+		using namespace core::impl::reference;
+
+		// a loop consisting of far more deep tasks than the dependency manager tracks initially
+		const int N = 1 << 15;
+		AlwaysSplitPolicy always;
+		std::atomic<int> count(0);
+		std::atomic<bool> ready(false);
+		detail::iteration_reference<int> root;
+
+		// the outcome of the observation made by the last iteration being processed
+		std::atomic<int> neighbor(-1);
+		std::atomic<bool> neighborDone(false);
+		std::atomic<bool> rootDone(true);
+
+		auto ref = [&]() {
+			SplitPolicyScope policy(&always);
+			loop_partitioner_scope partitioner(fixed_grain(1));
+			return pfor(0,N,[&](int i) {
+				if (++count < N) return;
+
+				// locate the task of the neighbor of the last iteration, sharing all ancestors with it
+				auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+				while(!ready && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+				if (!ready) return;
+				neighbor = i ^ 1;
+				auto cur = root;
+				while(cur.getRange().size() > 1) {
+					auto fragments = cur.split();
+					cur = (fragments.right.getRange().begin() <= neighbor) ? fragments.right : fragments.left;
+				}
+				if (cur.getRange().begin() != neighbor) return;
+
+				// it is reported to be completed, although its ancestors are still running
+				while(!cur.getHandle().isDone() && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+				neighborDone = cur.getHandle().isDone();
+				rootDone = root.getHandle().isDone();
+			});
+		}();
+
+		root = ref;
+		ready = true;
+		ref.wait();
+
+		EXPECT_EQ(N, count);
+		EXPECT_LE(0, neighbor);
+		EXPECT_TRUE(neighborDone);
+		EXPECT_FALSE(rootDone);
+	}
+
+	TEST(Benchmark, PforSplitPolicies) {
+		using namespace core::impl::reference;
+
+		auto& pool = runtime::WorkerPool::getInstance();
+		const SplitPolicy& old = pool.getSplitPolicy();
+
+		const int N = 1000000;
+		std::vector<double> data(N, 1.0);
+
+		for(const auto& name : { "fixed", "lazy", "adaptive" }) {
+			pool.setSplitPolicy(*getSplitPolicy(name));
+
+			// a mix of many short loops and a few long ones
+			auto start = std::chrono::steady_clock::now();
+			for(int i=0; i<100; i++) {
+				pfor(0,1000,[&](int j) { data[j] += 1.0; });
+			}
+			for(int i=0; i<10; i++) {
+				pfor(0,N,[&](int j) { data[j] = data[j] * 0.5 + 1.0; });
+			}
+			auto end = std::chrono::steady_clock::now();
+
+			std::cout << name << "\t- pfor: " << std::chrono::duration<double,std::milli>(end - start).count() << "ms\n";
+		}
+
+		pool.setSplitPolicy(old);
+
+		for(int j=1000; j<N; j+=1000) {
+			EXPECT_LT(1.0, data[j]);
+		}
+	}
+
+	TEST(Benchmark, PforPartitioners) {
+
+		const int N = 1000000;
+		std::vector<double> data(N, 1.0);
+
+		for(const auto& partitioner : { fixed_grain(1), fixed_grain(1024), auto_grain(), static_partition() }) {
+			loop_partitioner_scope scope(partitioner);
+
+			// a cheap loop body, where the task overhead dominates fine grained partitions
+			auto start = std::chrono::steady_clock::now();
+			for(int i=0; i<10; i++) {
+				pfor(0,N,[&](int j) { data[j] = data[j] * 0.5 + 1.0; });
+			}
+			auto end = std::chrono::steady_clock::now();
+
+			std::cout << partitioner << "\t- pfor: " << std::chrono::duration<double,std::milli>(end - start).count() << "ms\n";
+		}
+
+		for(int j=0; j<N; j+=1000) {
+			EXPECT_LT(1.0, data[j]);
+		}
+	}
+
+	TEST(Benchmark, PforRows) {
+
+		const int N = 128;
+		using Point = utils::Vector<int,3>;
+
+		std::vector<double> a(N*N*N, 1.0);
+		std::vector<double> b(N*N*N, 0.0);
+
+		auto idx = [](int x, int y, int z) { return (x * N + y) * N + z; };
+
+		loop_partitioner_scope scope(fixed_grain(N*N));
+
+		// a 3D Jacobi step on the interior, once point-wise, once row-wise
+		auto start = std::chrono::steady_clock::now();
+		for(int t=0; t<10; t++) {
+			pfor(Point(1,1,1),Point(N-1,N-1,N-1),[&](const Point& p) {
+				b[idx(p.x,p.y,p.z)] = (a[idx(p.x-1,p.y,p.z)] + a[idx(p.x+1,p.y,p.z)] + a[idx(p.x,p.y-1,p.z)] + a[idx(p.x,p.y+1,p.z)] + a[idx(p.x,p.y,p.z-1)] + a[idx(p.x,p.y,p.z+1)]) / 6;
+			});
+		}
+		auto end = std::chrono::steady_clock::now();
+		std::cout << "points\t- pfor: " << std::chrono::duration<double,std::milli>(end - start).count() << "ms\n";
+
+		start = std::chrono::steady_clock::now();
+		for(int t=0; t<10; t++) {
+			pforRows(Point(1,1,1),Point(N-1,N-1,N-1),[&](const Point& p, std::size_t length) {
+				const double* c = &a[idx(p.x,p.y,p.z)];
+				double* r = &b[idx(p.x,p.y,p.z)];
+				for(int i=0; i<(int)length; i++) {
+					r[i] = (c[i-N*N] + c[i+N*N] + c[i-N] + c[i+N] + c[i-1] + c[i+1]) / 6;
+				}
+			});
+		}
+		end = std::chrono::steady_clock::now();
+		std::cout << "rows\t- pfor: " << std::chrono::duration<double,std::milli>(end - start).count() << "ms\n";
+
+		EXPECT_EQ(1.0, b[idx(N/2,N/2,N/2)]);
+	}
+
+	TEST(Benchmark, PforTraversals) {
+
+		const int N = 200;
+		using Point = utils::Vector<int,3>;
+
+		std::vector<double> a(N*N*N, 1.0);
+		std::vector<double> b(N*N*N, 0.0);
+
+		auto idx = [](int x, int y, int z) { return (x * N + y) * N + z; };
+
+		loop_partitioner_scope grain(fixed_grain(32*32*32));
+
+		// the heat stencil of the tutorials on a 3D grid, alternating between two buffers
+		for(auto traversal : { loop_traversal::Lexicographic, loop_traversal::SpaceFilling }) {
+			loop_traversal_scope scope(traversal);
+
+			auto start = std::chrono::steady_clock::now();
+			for(int t=0; t<10; t++) {
+				auto& src = (t % 2) ? b : a;
+				auto& trg = (t % 2) ? a : b;
+				pforRows(Point(1,1,1),Point(N-1,N-1,N-1),[&](const Point& p, std::size_t length) {
+					const double* c = &src[idx(p.x,p.y,p.z)];
+					double* r = &trg[idx(p.x,p.y,p.z)];
+					for(int i=0; i<(int)length; i++) {
+						r[i] = c[i] + 0.1 * (c[i-N*N] + c[i+N*N] + c[i-N] + c[i+N] + c[i-1] + c[i+1] - 6 * c[i]);
+					}
+				});
+			}
+			auto end = std::chrono::steady_clock::now();
+
+			auto name = (traversal == loop_traversal::Lexicographic) ? "lexicographic" : "space filling";
+			std::cout << name << "\t- stencil: " << std::chrono::duration<double,std::milli>(end - start).count() << "ms\n";
+		}
+
+		EXPECT_EQ(1.0, a[idx(N/2,N/2,N/2)]);
+	}
+
+	TEST(Benchmark, PforTiled) {
+
+		const int N = 1000;
+		const int T = 50;
+		using Point = utils::Vector<int,2>;
+
+		std::vector<double> a(N*N, 1.0);
+		std::vector<double> b(N*N, 1.0);
+
+		loop_partitioner_scope grain(fixed_grain(64*64));
+
+		auto update = [&](std::size_t t, const Point& p) {
+			const auto& src = (t % 2) ? b : a;
+			auto& trg = (t % 2) ? a : b;
+			int i = p.x * N + p.y;
+			trg[i] = src[i] + 0.1 * (src[i-N] + src[i+N] + src[i-1] + src[i+1] - 4 * src[i]);
+		};
+
+		// the heat stencil of the tutorials, as a chain of loops synchronized by their neighborhood
+		{
+			auto start = std::chrono::steady_clock::now();
+			detail::loop_reference<Point> ref;
+			for(int t=0; t<T; t++) {
+				ref = pfor(Point(1,1),Point(N-1,N-1),[&,t](const Point& p) { update(t,p); },small_neighborhood_sync(ref));
+			}
+			ref.wait();
+			auto end = std::chrono::steady_clock::now();
+			std::cout << "chained\t- stencil: " << std::chrono::duration<double,std::milli>(end - start).count() << "ms\n";
+		}
+
+		// the same stencil processing several time steps per tile
+		{
+			auto start = std::chrono::steady_clock::now();
+			pforTiled(Point(1,1),Point(N-1,N-1),T,update);
+			auto end = std::chrono::steady_clock::now();
+			std::cout << "tiled\t- stencil: " << std::chrono::duration<double,std::milli>(end - start).count() << "ms\n";
+		}
+
+		EXPECT_EQ(1.0, a[N*N/2 + N/2]);
+	}
+
+	// splits the given dependency along with its range like a loop does down to the given depth, returning the number of splits
+	template<typename I, typename Dependency>
+	std::size_t splitDependency(const Dependency& dependency, const detail::range<I>& range, std::size_t depth, std::size_t maxDepth) {
+		if (depth >= maxDepth) return 0;
+		auto parts = range.split(depth);
+		auto deps = dependency.split(parts.left,parts.right);
+		return 1 + splitDependency(deps.left,parts.left,depth+1,maxDepth) + splitDependency(deps.right,parts.right,depth+1,maxDepth);
+	}
+
+	TEST(Benchmark, NeighborhoodSyncSplit) {
+
+		const int N = 256;
+		const std::size_t depth = 18;
+		using Point = utils::Vector<int,3>;
+
+		auto loop = make_loop_ref(Point(0,0,0),Point(N,N,N));
+
+		// the cost of deriving the dependencies of sub-tasks when decomposing a loop
+		auto measure = [&](const char* name, const auto& dependency) {
+			auto start = std::chrono::steady_clock::now();
+			auto splits = splitDependency(dependency,loop.getRange(),0,depth);
+			auto end = std::chrono::steady_clock::now();
+			std::cout << name << "\t- split: " << std::chrono::duration<double,std::nano>(end - start).count() / splits << "ns/task\n";
+			EXPECT_EQ((std::size_t(1) << depth) - 1, splits);
+		};
+
+		measure("none",after_all_sync(loop));
+		measure("small",small_neighborhood_sync(loop));
+		measure("full",full_neighborhood_sync(loop));
+		measure("small r=2",small_neighborhood_sync<2>(loop));
+		measure("full r=2",full_neighborhood_sync<2>(loop));
+	}
+
 } // end namespace algorithm
 } // end namespace user
 } // end namespace api
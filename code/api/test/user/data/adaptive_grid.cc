@@ -1,5 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+
+#include "allscale/api/core/allocator.h"
+
 #include "allscale/api/user/data/adaptive_grid.h"
 
 #include "allscale/utils/printer/vectors.h"
@@ -1149,6 +1154,38 @@ namespace data {
 
 	}
 
+	TEST(Benchmark, AdaptiveGridScratchBuffers) {
+
+		AdaptiveGrid<double, CellConfig<2, layers<layer<2,2>, layer<3,3>>>> aGrid({ 100, 100 });
+
+		aGrid.pforEach([](auto& cell) {
+			cell.forAllActiveNodes([](double& cur) { cur = 1.0; });
+		});
+
+		// each step copies the nodes of a cell into a temporary buffer before reducing them
+		auto run = [&](const char* name, auto buffer) {
+			std::atomic<int> errors(0);
+			auto start = std::chrono::steady_clock::now();
+			for(int i=0; i<100; i++) {
+				aGrid.pforEach([&](auto& cell) {
+					auto nodes = buffer;
+					cell.forAllActiveNodes([&](const double& cur) { nodes.push_back(cur); });
+					double sum = 0;
+					for(const auto& cur : nodes) sum += cur;
+					if (sum != 2*2*3*3) errors++;
+				});
+			}
+			auto end = std::chrono::steady_clock::now();
+
+			std::cout << name << "\t- adaptive grid: " << std::chrono::duration<double,std::milli>(end - start).count() << "ms\n";
+
+			EXPECT_EQ(0, errors);
+		};
+
+		run("heap", std::vector<double>());
+		run("task local", core::task_local_vector<double>());
+	}
+
 } // end namespace data
 } // end namespace user
 } // end namespace api
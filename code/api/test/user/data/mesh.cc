@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+
+#include "allscale/api/core/allocator.h"
 #include "allscale/api/core/data.h"
 #include "allscale/api/user/data/mesh.h"
 #include "allscale/utils/string_utils.h"
@@ -1616,6 +1619,42 @@ namespace data {
 
 	}
 
+	TEST(Benchmark, MeshScratchBuffers) {
+
+		auto bar = createBarMesh<2,2>(100000);
+
+		auto values = bar.createNodeData<Vertex,double,0>();
+		bar.pforAll<Vertex>([&](const auto& node){
+			values[node] = node.id;
+		});
+
+		// each step gathers the values of its neighbors into a temporary buffer
+		auto run = [&](const char* name, auto buffer) {
+			auto result = bar.createNodeData<Vertex,double,0>();
+			auto start = std::chrono::steady_clock::now();
+			for(int i=0; i<10; i++) {
+				bar.pforAll<Vertex>([&](const auto& node){
+					auto neighbors = buffer;
+					for(const auto& cur : bar.template getSinks<Edge>(node)) {
+						neighbors.push_back(values[cur]);
+					}
+					double sum = 0;
+					for(const auto& cur : neighbors) sum += cur;
+					result[node] = sum;
+				});
+			}
+			auto end = std::chrono::steady_clock::now();
+
+			std::cout << name << "\t- mesh: " << std::chrono::duration<double,std::milli>(end - start).count() << "ms\n";
+
+			EXPECT_EQ(1, result[NodeRef<Vertex>(0)]);
+			EXPECT_EQ(20, result[NodeRef<Vertex>(10)]);
+		};
+
+		run("heap", std::vector<double>());
+		run("task local", core::task_local_vector<double>());
+	}
+
 
 	// --- combinations ---
 